@@ -0,0 +1,427 @@
+/**
+ * This file contains all functions related to archives of modules in the 'linker'. An archive is mapped to memory and only its index is
+ * searched, a member is parsed only when it defines a label an already linked module refers to.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for mmap */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "archive.h"
+#include "emergency_free_mem.h"
+
+
+/**
+ * is_archive_name function checks whether a name given to the 'linker' is the name of an archive.
+ *
+ * @param name - the name.
+ * @return - 1 if it's the name of an archive, otherwise 0 is returned.
+ */
+int is_archive_name(const char* name)
+{
+	size_t len;
+
+	len = strlen(name);
+	return len > strlen(ARCHIVE_EXTENSION) && strcmp(name + len - strlen(ARCHIVE_EXTENSION), ARCHIVE_EXTENSION) == 0;
+}
+
+
+/**
+ * open_archive function maps an archive and checks its header.
+ *
+ * @param path - the name of the archive file.
+ * @return - a pointer to the archive, or NULL if the archive could not be opened or is not valid.
+ */
+ar_ptr open_archive(const char* path)
+{
+	struct stat st;
+	int fd;
+	char* map;
+	ar_ptr a;
+	long members_num;
+	long symbols_num;
+
+	fd = open(path, O_RDONLY);
+	if(fd == -1) {
+		link_error(path, 0, "The archive file could not be opened.", NULL);
+		return NULL;
+	}
+
+	if(fstat(fd, &st) == -1 || st.st_size < ARCHIVE_HEADER_LENGTH) {
+		close(fd);
+		link_error(path, 0, "Invalid archive file.", NULL);
+		return NULL;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);	/* the mapping stays valid after the file is closed */
+	if(map == MAP_FAILED) {
+		link_error(path, 0, "The archive file could not be opened.", NULL);
+		return NULL;
+	}
+
+	members_num = strtol(map + sizeof(ARCHIVE_MAGIC), NULL, 10);
+	symbols_num = strtol(map + sizeof(ARCHIVE_MAGIC) + 9, NULL, 10);
+	if(strncmp(map, ARCHIVE_MAGIC, strlen(ARCHIVE_MAGIC)) != 0 || members_num < 0 || symbols_num < 0 ||
+			ARCHIVE_HEADER_LENGTH + members_num * MEMBER_RECORD_LENGTH + symbols_num * SYMBOL_RECORD_LENGTH > st.st_size) {
+		munmap(map, st.st_size);
+		link_error(path, 0, "Invalid archive file.", NULL);
+		return NULL;
+	}
+
+	a = malloc(sizeof(archive));
+
+	/* verify if malloc worked as expected */
+	if(a == NULL)
+	{
+		munmap(map, st.st_size);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	a -> map = map;
+	a -> size = st.st_size;
+	a -> members_num = members_num;
+	a -> symbols_num = symbols_num;
+	a -> members = map + ARCHIVE_HEADER_LENGTH;
+	a -> symbols = a -> members + members_num * MEMBER_RECORD_LENGTH;
+	a -> next = NULL;
+	a -> name = malloc(strlen(path) + 1);
+	a -> loaded = calloc(members_num + 1, 1);	/* +1 so an empty archive doesn't ask for 0 bytes */
+
+	/* verify if malloc worked as expected */
+	if(a -> name == NULL || a -> loaded == NULL)
+	{
+		close_archives(&a);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	strcpy(a -> name, path);
+
+	return a;
+}
+
+
+/**
+ * archive_find_symbol function searches for an entry label in the index of an archive (binary search over the sorted symbol records).
+ *
+ * @param a - a pointer to the archive.
+ * @param label - the label.
+ * @return - the index of the member that defines the label, or -1 if no member defines it.
+ */
+int archive_find_symbol(ar_ptr a, const char* label)
+{
+	char padded[MAX_SYMBOL_LENGTH];
+	const char* record;
+	int low, high, mid;
+	int cmp;
+	int member;
+
+	if(strlen(label) > MAX_SYMBOL_LENGTH) {
+		return -1;
+	}
+	pad_label(label, padded);
+
+	low = 0;
+	high = a -> symbols_num - 1;
+	while(low <= high)
+	{
+		mid = low + (high - low) / 2;
+		record = a -> symbols + mid * SYMBOL_RECORD_LENGTH;
+		cmp = memcmp(padded, record, MAX_SYMBOL_LENGTH);
+
+		if(cmp == 0) {
+			member = strtol(record + MAX_SYMBOL_LENGTH + 1, NULL, 10);
+			if(member < 0 || member >= a -> members_num) {
+				link_error(a -> name, 0, "Invalid archive file, the index refers to a member that doesn't exist.", label);
+				return -1;
+			}
+			return member;
+		}
+		else if(cmp < 0) {
+			high = mid - 1;
+		}
+		else low = mid + 1;
+	}
+
+	return -1;
+}
+
+
+/**
+ * archive_load_member function creates a module from a member of an archive, the member is marked as loaded.
+ *
+ * @param a - a pointer to the archive.
+ * @param member - the index of the member.
+ * @return - a pointer to the module, or NULL if the member is not valid.
+ */
+om_ptr archive_load_member(ar_ptr a, int member)
+{
+	char name[MAX_MEMBER_NAME_LENGTH + 1];	/* +1 for string terminator char */
+	unsigned long fields[6];	/* offsets and lengths of the '.ob', '.ent' and '.ext' files */
+	const char* record;
+	int i;
+
+	if(member < 0 || member >= a -> members_num) {
+		link_error(a -> name, 0, "Invalid archive file, the index refers to a member that doesn't exist.", NULL);
+		return NULL;
+	}
+	a -> loaded[member] = 1;
+
+	record = a -> members + member * MEMBER_RECORD_LENGTH;
+	unpad_label(record, name);
+
+	for(i = 0; i < 6; i++)
+	{
+		fields[i] = strtoul(record + MAX_MEMBER_NAME_LENGTH + 1 + i * 11, NULL, 10);
+		if(i % 2 == 1 && (fields[i-1] > a -> size || fields[i] > a -> size - fields[i-1])) {	/* the file must be inside the archive */
+			link_error(a -> name, 0, "Invalid archive file, a member is outside the archive.", NULL);
+			return NULL;
+		}
+	}
+
+	return parse_object_module(name, a -> map + fields[0], fields[1], fields[3] ? a -> map + fields[2] : NULL, fields[3],
+			fields[5] ? a -> map + fields[4] : NULL, fields[5]);
+}
+
+
+/**
+ * create_archive function creates an archive of modules.
+ *
+ * @param path - the name of the archive file.
+ * @param names - the names of the modules (without extension).
+ * @param names_num - the number of modules.
+ * @return - 1 if the archive was created, otherwise 0 is returned.
+ */
+int create_archive(const char* path, char** names, int names_num)
+{
+	static const char* extensions[3] = {OB_EXTENSION, ENT_EXTENSION, EXT_EXTENSION};
+	char** texts;	/* the '.ob', '.ent' and '.ext' files of every module (3 per module) */
+	size_t* lens;
+	char* symbols;	/* the symbol records */
+	int symbols_num;
+	char label[MAX_SYMBOL_LENGTH + 1];	/* +1 for string terminator char */
+	char* file_name;
+	FILE* fp;
+	om_ptr m;
+	sr_ptr entry;
+	unsigned long offset;
+	int valid;
+	int i, j;
+
+	texts = calloc(names_num * 3 + 1, sizeof(char*));
+	lens = calloc(names_num * 3 + 1, sizeof(size_t));
+
+	/* verify if calloc worked as expected */
+	if(texts == NULL || lens == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	/* START - read and check the modules */
+	valid = 1;
+	symbols_num = 0;
+	for(i = 0; i < names_num; i++)
+	{
+		if(strlen(names[i]) > MAX_MEMBER_NAME_LENGTH) {
+			link_error(names[i], 0, "Module name is longer than allowed in an archive (31 characters).", NULL);
+			valid = 0;
+			continue;
+		}
+
+		for(j = 0; j < 3; j++) {
+			file_name = module_file_name(names[i], extensions[j]);
+			texts[i*3 + j] = read_whole_file(file_name, &lens[i*3 + j]);
+			free(file_name);
+		}
+
+		if(texts[i*3] == NULL) {
+			file_name = module_file_name(names[i], OB_EXTENSION);
+			link_error(file_name, 0, "The object file could not be opened.", NULL);
+			free(file_name);
+			valid = 0;
+			continue;
+		}
+
+		m = parse_object_module(names[i], texts[i*3], lens[i*3], texts[i*3 + 1], lens[i*3 + 1], texts[i*3 + 2], lens[i*3 + 2]);
+		if(m == NULL) {
+			valid = 0;
+			continue;
+		}
+		for(entry = m -> entries; entry != NULL; entry = entry -> next) {
+			symbols_num++;
+		}
+		free_object_modules(&m);
+	}
+	/* END - read and check the modules */
+
+	symbols = NULL;
+	if(valid) {
+		/* START - the index */
+		symbols = malloc(symbols_num * SYMBOL_RECORD_LENGTH + 1);	/* +1 for the string terminator char sprintf function adds */
+
+		/* verify if malloc worked as expected */
+		if(symbols == NULL)
+		{
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+
+		symbols_num = 0;
+		for(i = 0; i < names_num; i++)
+		{
+			m = parse_object_module(names[i], texts[i*3], lens[i*3], texts[i*3 + 1], lens[i*3 + 1], texts[i*3 + 2], lens[i*3 + 2]);
+			for(entry = m -> entries; entry != NULL; entry = entry -> next) {
+				sprintf(symbols + symbols_num * SYMBOL_RECORD_LENGTH, "%-31s %08d\n", entry -> label, i);
+				symbols_num++;
+			}
+			free_object_modules(&m);
+		}
+
+		qsort(symbols, symbols_num, SYMBOL_RECORD_LENGTH, compare_symbol_records);
+
+		for(i = 1; i < symbols_num; i++) {
+			if(compare_symbol_records(symbols + (i-1) * SYMBOL_RECORD_LENGTH, symbols + i * SYMBOL_RECORD_LENGTH) == 0) {
+				file_name = module_file_name(names[strtol(symbols + i * SYMBOL_RECORD_LENGTH + MAX_SYMBOL_LENGTH + 1, NULL, 10)], ENT_EXTENSION);
+				unpad_label(symbols + i * SYMBOL_RECORD_LENGTH, label);
+				link_error(file_name, 0, "Entry label is already defined in another module of the archive.", label);
+				free(file_name);
+				valid = 0;
+			}
+		}
+		/* END - the index */
+	}
+
+	if(valid) {
+		fp = fopen(path, "w+");
+
+		if(fp == NULL) {
+			printf("Could not create archive file.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+
+		fprintf(fp, "%s %08d %08d\n", ARCHIVE_MAGIC, names_num, symbols_num);
+
+		offset = ARCHIVE_HEADER_LENGTH + names_num * MEMBER_RECORD_LENGTH + symbols_num * SYMBOL_RECORD_LENGTH;
+		for(i = 0; i < names_num; i++)
+		{
+			fprintf(fp, "%-31s", names[i]);
+			for(j = 0; j < 3; j++) {
+				fprintf(fp, " %010lu %010lu", texts[i*3 + j] ? offset : 0, (unsigned long)lens[i*3 + j]);
+				offset += lens[i*3 + j];
+			}
+			fputc('\n', fp);
+		}
+
+		fwrite(symbols, SYMBOL_RECORD_LENGTH, symbols_num, fp);
+
+		for(i = 0; i < names_num * 3; i++) {
+			if(texts[i] != NULL) {
+				fwrite(texts[i], 1, lens[i], fp);
+			}
+		}
+
+		printf("\nFile '%s' has been created successfully!", path);
+
+		fclose(fp);
+	}
+
+	/* frees */
+	for(i = 0; i < names_num * 3; i++) {
+		if(texts[i] != NULL) {
+			free(texts[i]);
+		}
+	}
+	free(texts);
+	free(lens);
+	if(symbols != NULL) {
+		free(symbols);
+	}
+
+	return valid;
+}
+
+
+/**
+ * pad_label function copies a label to a buffer of MAX_SYMBOL_LENGTH chars padded with spaces.
+ *
+ * @param label - the label.
+ * @param padded - a buffer of at least MAX_SYMBOL_LENGTH chars (no string terminator char is stored).
+ */
+void pad_label(const char* label, char* padded)
+{
+	int i;
+
+	for(i = 0; i < MAX_SYMBOL_LENGTH && label[i] != '\0'; i++) {
+		padded[i] = label[i];
+	}
+	for(; i < MAX_SYMBOL_LENGTH; i++) {
+		padded[i] = ' ';
+	}
+}
+
+
+/**
+ * unpad_label function copies a label (or a member name) padded with spaces to a string.
+ *
+ * @param padded - the padded label, MAX_SYMBOL_LENGTH chars.
+ * @param label - a string of at least MAX_SYMBOL_LENGTH + 1 chars where to store the label.
+ */
+void unpad_label(const char* padded, char* label)
+{
+	int len;
+
+	for(len = MAX_SYMBOL_LENGTH; len > 0 && padded[len-1] == ' '; len--);
+	memcpy(label, padded, len);
+	label[len] = '\0';
+}
+
+
+/**
+ * compare_symbol_records function compares 2 symbol records by their labels (for qsort function).
+ *
+ * @param a - a pointer to the first record.
+ * @param b - a pointer to the second record.
+ * @return - a negative number, 0 or a positive number, like strcmp function.
+ */
+int compare_symbol_records(const void* a, const void* b)
+{
+	return memcmp(a, b, MAX_SYMBOL_LENGTH);
+}
+
+
+/**
+ * close_archives function unmaps and frees a list of archives.
+ *
+ * @param head - the pointer to the head of the list.
+ */
+void close_archives(ar_ptr* head)
+{
+	ar_ptr a;
+
+	while(*head != NULL)
+	{
+		a = *head;
+		*head = a -> next;
+		munmap(a -> map, a -> size);
+		if(a -> name != NULL) {
+			free(a -> name);
+		}
+		if(a -> loaded != NULL) {
+			free(a -> loaded);
+		}
+		free(a);
+	}
+}
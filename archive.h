@@ -0,0 +1,132 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "object_module.h"
+#define ARCHIVE_EXTENSION ".oba"
+#define ARCHIVE_MAGIC "OBA1"
+#define ARCHIVE_HEADER_LENGTH 23	/* "OBA1 MMMMMMMM SSSSSSSS\n" - the number of members and the number of symbols */
+#define MAX_MEMBER_NAME_LENGTH MAX_SYMBOL_LENGTH	/* names are padded like labels */
+#define MEMBER_RECORD_LENGTH 98	/* name (31) and 6 offsets / lengths (11 each: a space and 10 digits), then a newline char */
+#define SYMBOL_RECORD_LENGTH 41	/* label (31), a space, member index (8), a newline char */
+
+/*
+ * An archive ('.oba' file) bundles many modules with an index of their entry labels. It has 4 parts:
+ * 1. a header line.
+ * 2. a member record for every module: its name and the offsets (from the start of the archive) and lengths of its '.ob', '.ent' and '.ext'
+ *    files.
+ * 3. a symbol record for every entry label of every module, sorted by label: the label and the index of the member record of the module.
+ * 4. the contents of the '.ob', '.ent' and '.ext' files of all modules.
+ * Names and labels are padded with spaces and numbers with zeros, so all records of a part have the same length, and the index is searched
+ * straight in the mapped archive (binary search) without being parsed.
+ */
+
+
+/* a pointer to struct archive */
+typedef struct archive* ar_ptr;
+
+/* a struct that represents an archive opened for linking (list) */
+typedef struct archive {
+	char* name;	/* the name of the archive file */
+	char* map;	/* the mapped archive */
+	size_t size;	/* the size of the archive */
+	int members_num;
+	int symbols_num;
+	const char* members;	/* the first member record */
+	const char* symbols;	/* the first symbol record */
+	char* loaded;	/* 1 for every member that was already loaded */
+	ar_ptr next;
+} archive;
+
+
+/**
+ * is_archive_name function checks whether a name given to the 'linker' is the name of an archive (ends with ARCHIVE_EXTENSION).
+ *
+ * @param name - the name.
+ * @return - 1 if it's the name of an archive, otherwise 0 is returned.
+ */
+int is_archive_name(const char* name);
+
+
+/**
+ * open_archive function maps an archive and checks its header. No member is read.
+ * Errors are reported with link_error function.
+ *
+ * @param path - the name of the archive file.
+ * @return - a pointer to the archive, or NULL if the archive could not be opened or is not valid.
+ */
+ar_ptr open_archive(const char* path);
+
+
+/**
+ * archive_find_symbol function searches for an entry label in the index of an archive.
+ *
+ * @param a - a pointer to the archive.
+ * @param label - the label.
+ * @return - the index of the member that defines the label, or -1 if no member defines it.
+ */
+int archive_find_symbol(ar_ptr a, const char* label);
+
+
+/**
+ * archive_load_member function creates a module from a member of an archive, the member is marked as loaded.
+ * Errors are reported with link_error function.
+ *
+ * @param a - a pointer to the archive.
+ * @param member - the index of the member.
+ * @return - a pointer to the module, or NULL if the member is not valid.
+ */
+om_ptr archive_load_member(ar_ptr a, int member);
+
+
+/**
+ * create_archive function creates an archive of modules. The '.ob', '.ent' and '.ext' files of every module are read, checked (like the
+ * 'linker' reads them) and copied to the archive as they are.
+ * Errors are reported with link_error function, and the archive is not created if errors were found.
+ *
+ * @param path - the name of the archive file.
+ * @param names - the names of the modules (without extension).
+ * @param names_num - the number of modules.
+ * @return - 1 if the archive was created, otherwise 0 is returned.
+ */
+int create_archive(const char* path, char** names, int names_num);
+
+
+/**
+ * pad_label function copies a label to a buffer of MAX_SYMBOL_LENGTH chars padded with spaces (the form of the labels in the index).
+ *
+ * @param label - the label.
+ * @param padded - a buffer of at least MAX_SYMBOL_LENGTH chars (no string terminator char is stored).
+ */
+void pad_label(const char* label, char* padded);
+
+
+/**
+ * unpad_label function copies a label (or a member name) padded with spaces to a string.
+ *
+ * @param padded - the padded label, MAX_SYMBOL_LENGTH chars.
+ * @param label - a string of at least MAX_SYMBOL_LENGTH + 1 chars where to store the label.
+ */
+void unpad_label(const char* padded, char* label);
+
+
+/**
+ * compare_symbol_records function compares 2 symbol records by their labels (for qsort function).
+ *
+ * @param a - a pointer to the first record.
+ * @param b - a pointer to the second record.
+ * @return - a negative number, 0 or a positive number, like strcmp function.
+ */
+int compare_symbol_records(const void* a, const void* b);
+
+
+/**
+ * close_archives function unmaps and frees a list of archives.
+ *
+ * @param head - the pointer to the head of the list.
+ */
+void close_archives(ar_ptr* head);
+
+
+#endif
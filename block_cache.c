@@ -0,0 +1,358 @@
+/**
+ * This file contains all functions related to the basic-block translation cache of the 'simulator'. A block is translated the first time the
+ * program counter reaches its start address, and is executed from the cache every other time, with operands already resolved to pointers and
+ * the comparison at the end of a loop fused with its branch.
+ * Anything unusual (invalid instructions, stores to the code, the step limit) is left to run_machine function one instruction at a time, so
+ * both ways of executing a program give exactly the same results.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "block_cache.h"
+#include "emergency_free_mem.h"
+
+static block_ptr cache[MEMORY_SIZE];	/* the translated blocks, by start address */
+
+
+/**
+ * run_translated function executes instructions from the current pc until 'stop', an error or the step limit, with translated blocks.
+ *
+ * @param mc - a pointer to the machine.
+ * @param max_steps - the maximum number of instructions to execute, or NO_STEP_LIMIT.
+ * @return - MACHINE_STOPPED, MACHINE_STEP_LIMIT or MACHINE_ERROR (see run_machine function).
+ */
+machine_status run_translated(machine_ptr mc, long max_steps)
+{
+	block_ptr b;
+	block_op* op;
+	machine_status res;
+	long code_writes;
+	int interpret;
+	int stopped;
+	int pc;
+
+	pc = mc -> pc;
+	code_writes = mc -> code_writes;
+	interpret = 0;
+	stopped = 0;
+
+	for(;;)
+	{
+		if(mc -> code_writes != code_writes) {	/* only run_machine function stores to the code, one word per instruction */
+			invalidate_blocks(mc, mc -> last_code_write);
+			code_writes = mc -> code_writes;
+		}
+
+		b = NULL;
+		if(!interpret && pc >= FIRST_ADDRESS && pc < mc -> code_end) {
+			if(cache[pc] == NULL) {
+				cache[pc] = translate_block(mc, pc);
+			}
+			b = cache[pc];
+		}
+
+		if(b == NULL || b -> length == 0 || (max_steps != NO_STEP_LIMIT && mc -> executed + b -> length > max_steps)) {
+			interpret = 0;
+			mc -> pc = pc;
+			if(mc -> executed == max_steps) {
+				res = MACHINE_STEP_LIMIT;
+				break;
+			}
+			res = run_machine(mc, mc -> executed + 1);
+			if(res != MACHINE_STEP_LIMIT) {
+				break;
+			}
+			pc = mc -> pc;
+			continue;
+		}
+
+		for(op = b -> ops; ; op++)
+		{
+			switch(op -> kind)
+			{
+				case BLOCK_MOV:
+					*(op -> dest) = *(op -> src);
+					continue;
+
+				case BLOCK_ADD:
+					*(op -> dest) = (*(op -> dest) + *(op -> src)) & WORD_MASK;
+					continue;
+
+				case BLOCK_SUB:
+					*(op -> dest) = (*(op -> dest) - *(op -> src)) & WORD_MASK;
+					continue;
+
+				case BLOCK_NOT:
+					*(op -> dest) = ~*(op -> dest) & WORD_MASK;
+					continue;
+
+				case BLOCK_ADD_CONST:
+					*(op -> dest) = (*(op -> dest) + op -> imm[0]) & WORD_MASK;
+					continue;
+
+				case BLOCK_CMP:
+					mc -> zero = ((*(op -> src) - *(op -> dest)) & WORD_MASK) == 0;
+					continue;
+
+				case BLOCK_RED:
+					*(op -> dest) = machine_getchar(mc) & WORD_MASK;
+					continue;
+
+				case BLOCK_PRN:
+					machine_putchar(mc, *(op -> dest) & 0xFF);
+					continue;
+
+				case BLOCK_JMP:
+					pc = jump_target(mc, op -> target_mode, op -> target);
+					break;
+
+				case BLOCK_BNE:
+					pc = mc -> zero ? op -> next_pc : jump_target(mc, op -> target_mode, op -> target);
+					break;
+
+				case BLOCK_CMP_BNE:
+					mc -> zero = ((*(op -> src) - *(op -> dest)) & WORD_MASK) == 0;
+					pc = mc -> zero ? op -> next_pc : jump_target(mc, op -> target_mode, op -> target);
+					break;
+
+				case BLOCK_JSR:
+					if(mc -> sp == MAX_STACK_DEPTH) {	/* run_machine function reports it */
+						pc = op -> addr;
+						interpret = 1;
+						break;
+					}
+					mc -> stack[mc -> sp++] = op -> next_pc;
+					pc = jump_target(mc, op -> target_mode, op -> target);
+					break;
+
+				case BLOCK_RTS:
+					if(mc -> sp == 0) {	/* run_machine function reports it */
+						pc = op -> addr;
+						interpret = 1;
+						break;
+					}
+					pc = mc -> stack[--(mc -> sp)];
+					break;
+
+				case BLOCK_STOP:
+					pc = op -> addr;
+					stopped = 1;
+					break;
+
+				case BLOCK_NEXT:
+					pc = op -> next_pc;
+					break;
+			}
+			break;
+		}
+
+		/* a 'jsr' / 'rts' that failed is the last instruction of its block, and it wasn't executed */
+		mc -> executed += interpret ? b -> length - 1 : b -> length;
+
+		if(stopped) {
+			mc -> pc = pc;
+			res = MACHINE_STOPPED;
+			break;
+		}
+	}
+
+	free_block_cache();
+
+	return res;
+}
+
+
+/**
+ * translate_block function translates the basic block that starts at an address.
+ *
+ * @param mc - a pointer to the machine.
+ * @param start - the address (in the code).
+ * @return - a pointer to the translated block.
+ */
+block_ptr translate_block(machine_ptr mc, int start)
+{
+	block_ptr b;
+	block_op* op;
+	decoded_instruction* ins;
+	int addr;
+
+	b = malloc(sizeof(block));
+
+	/* verify if malloc worked as expected */
+	if(b == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	b -> start = start;
+	b -> length = 0;
+	addr = start;
+	op = b -> ops;
+
+	while(b -> length < MAX_BLOCK_LENGTH && addr < mc -> code_end)
+	{
+		ins = &(mc -> code[addr]);
+		if(is_interpreted(mc, ins)) {
+			break;
+		}
+
+		op -> addr = addr;
+		op -> next_pc = addr + ins -> length;
+		op -> target_mode = ins -> dest_mode;
+		op -> target = ins -> dest;
+		op -> src = translate_operand(mc, ins -> src_mode, ins -> src, &(op -> imm[0]));
+		op -> dest = translate_operand(mc, ins -> dest_mode, ins -> dest, &(op -> imm[1]));
+		b -> length++;
+		addr += ins -> length;
+
+		switch(ins -> op)
+		{
+			case mov: op -> kind = BLOCK_MOV; break;
+			case cmp: op -> kind = BLOCK_CMP; break;
+			case add: op -> kind = BLOCK_ADD; break;
+			case sub: op -> kind = BLOCK_SUB; break;
+			case not: op -> kind = BLOCK_NOT; break;
+			case red: op -> kind = BLOCK_RED; break;
+			case prn: op -> kind = BLOCK_PRN; break;
+
+			case lea:	/* the address of the source operand is a constant */
+				op -> kind = BLOCK_MOV;
+				op -> imm[0] = ins -> src;
+				op -> src = &(op -> imm[0]);
+				break;
+
+			case clr:
+				op -> kind = BLOCK_MOV;
+				op -> imm[0] = 0;
+				op -> src = &(op -> imm[0]);
+				break;
+
+			case inc:
+			case dec:
+				op -> kind = BLOCK_ADD_CONST;
+				op -> imm[0] = ins -> op == inc ? 1 : -1;
+				break;
+
+			case jmp: op -> kind = BLOCK_JMP; break;
+			case jsr: op -> kind = BLOCK_JSR; break;
+			case rts: op -> kind = BLOCK_RTS; break;
+			case stop: op -> kind = BLOCK_STOP; break;
+
+			case bne:
+				if(op != b -> ops && (op - 1) -> kind == BLOCK_CMP) {	/* fuse with the 'cmp' before it */
+					op--;
+					op -> kind = BLOCK_CMP_BNE;
+					op -> next_pc = addr;
+					op -> target_mode = ins -> dest_mode;
+					op -> target = ins -> dest;
+				}
+				else op -> kind = BLOCK_BNE;
+				break;
+
+			default:
+				break;
+		}
+
+		if(ins -> op == jmp || ins -> op == bne || ins -> op == jsr || ins -> op == rts || ins -> op == stop) {
+			b -> end = addr;
+			return b;
+		}
+		op++;
+	}
+
+	op -> kind = BLOCK_NEXT;
+	op -> addr = addr;
+	op -> next_pc = addr;
+	b -> end = addr;
+
+	return b;
+}
+
+
+/**
+ * translate_operand function resolves an operand to the register / memory word it refers to.
+ *
+ * @param mc - a pointer to the machine.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand (see decoded_instruction struct).
+ * @param imm - where immediate operands are stored.
+ * @return - a pointer to the value of the operand.
+ */
+int* translate_operand(machine_ptr mc, addressing_type mode, int operand, int* imm)
+{
+	if(mode == regis_direct) {
+		return &(mc -> regs[operand]);
+	}
+	else if(mode == immediate) {
+		*imm = operand & WORD_MASK;
+		return imm;
+	}
+
+	return &(mc -> memory[operand]);
+}
+
+
+/**
+ * is_interpreted function checks whether an instruction must be executed by run_machine function instead of being translated.
+ *
+ * @param mc - a pointer to the machine.
+ * @param ins - the decoded instruction.
+ * @return - 1 if the instruction is interpreted, otherwise 0 is returned.
+ */
+int is_interpreted(machine_ptr mc, decoded_instruction* ins)
+{
+	if(ins -> op == no_op) {
+		return 1;
+	}
+	if(ins -> op == lea && ins -> src_mode != direct && ins -> src_mode != relative) {
+		return 1;
+	}
+	if(writes_operand(ins -> op)) {
+		if(ins -> dest_mode == immediate) {
+			return 1;
+		}
+		if(ins -> dest_mode != regis_direct && ins -> dest < mc -> code_end) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+
+/**
+ * invalidate_blocks function frees the cached blocks that contain an address.
+ *
+ * @param mc - a pointer to the machine.
+ * @param addr - the address.
+ */
+void invalidate_blocks(machine_ptr mc, int addr)
+{
+	int i;
+
+	for(i = FIRST_ADDRESS; i <= addr && i < mc -> code_end; i++) {
+		if(cache[i] != NULL && cache[i] -> end > addr) {
+			free(cache[i]);
+			cache[i] = NULL;
+		}
+	}
+}
+
+
+/**
+ * free_block_cache function frees all cached blocks.
+ */
+void free_block_cache()
+{
+	int i;
+
+	for(i = 0; i < MEMORY_SIZE; i++) {
+		if(cache[i] != NULL) {
+			free(cache[i]);
+			cache[i] = NULL;
+		}
+	}
+}
@@ -0,0 +1,103 @@
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include "machine.h"
+#define MAX_BLOCK_LENGTH 64	/* the maximum number of instructions of a translated block */
+
+
+/* the operations of translated code. Operands are resolved to pointers when the block is translated, so the addressing type is never checked
+ * while running. BLOCK_CMP_BNE is a 'cmp' followed by a 'bne' (the usual end of a loop) fused into one operation */
+typedef enum {BLOCK_MOV, BLOCK_ADD, BLOCK_SUB, BLOCK_NOT, BLOCK_ADD_CONST, BLOCK_CMP, BLOCK_RED, BLOCK_PRN, BLOCK_JMP, BLOCK_BNE, BLOCK_CMP_BNE,
+BLOCK_JSR, BLOCK_RTS, BLOCK_STOP, BLOCK_NEXT} block_op_kind;
+
+
+/* a struct that represents one operation of a translated block */
+typedef struct block_op {
+	block_op_kind kind;
+	int* src;	/* the register / memory word of the source operand, or imm[0] */
+	int* dest;	/* the register / memory word of the destination operand, or imm[1] for 'cmp' and 'prn' */
+	int imm[2];	/* the values of immediate operands (source, destination), imm[0] is the constant of BLOCK_ADD_CONST */
+	addressing_type target_mode;	/* the addressing type of the operand of a jump */
+	int target;	/* the decoded operand of a jump (see jump_target function in 'machine.h') */
+	int addr;	/* the address of the instruction */
+	int next_pc;	/* the address of the next instruction */
+} block_op;
+
+
+/* a pointer to struct block */
+typedef struct block* block_ptr;
+
+/* a struct that represents a translated basic block: the instructions from its start address up to (and including) the first 'jmp', 'bne',
+ * 'jsr', 'rts' or 'stop'. A block ends earlier, with BLOCK_NEXT, before an instruction that must be executed by run_machine function (an
+ * invalid instruction, or a store to the code), and after MAX_BLOCK_LENGTH instructions. A block of 0 instructions means that the instruction
+ * at its start address is executed by run_machine function */
+typedef struct block {
+	int start;	/* the address of the first instruction */
+	int end;	/* the address after the last word of the block */
+	int length;	/* the number of instructions */
+	block_op ops[MAX_BLOCK_LENGTH + 1];	/* +1 for BLOCK_NEXT */
+} block;
+
+
+/**
+ * run_translated function executes instructions from the current pc until 'stop', an error or the step limit, like run_machine function, but
+ * basic blocks are translated once and cached by their start address. Blocks are invalidated when the code they were translated from is
+ * written to.
+ *
+ * @param mc - a pointer to the machine.
+ * @param max_steps - the maximum number of instructions to execute, or NO_STEP_LIMIT.
+ * @return - MACHINE_STOPPED, MACHINE_STEP_LIMIT or MACHINE_ERROR (see run_machine function).
+ */
+machine_status run_translated(machine_ptr mc, long max_steps);
+
+
+/**
+ * translate_block function translates the basic block that starts at an address.
+ *
+ * @param mc - a pointer to the machine.
+ * @param start - the address (in the code).
+ * @return - a pointer to the translated block.
+ */
+block_ptr translate_block(machine_ptr mc, int start);
+
+
+/**
+ * translate_operand function resolves an operand to the register / memory word it refers to.
+ *
+ * @param mc - a pointer to the machine.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand (see decoded_instruction struct).
+ * @param imm - where immediate operands are stored.
+ * @return - a pointer to the value of the operand.
+ */
+int* translate_operand(machine_ptr mc, addressing_type mode, int operand, int* imm);
+
+
+/**
+ * is_interpreted function checks whether an instruction must be executed by run_machine function instead of being translated: invalid
+ * instructions (so run_machine function reports them), and instructions that write to the code or to an immediate operand.
+ *
+ * @param mc - a pointer to the machine.
+ * @param ins - the decoded instruction.
+ * @return - 1 if the instruction is interpreted, otherwise 0 is returned.
+ */
+int is_interpreted(machine_ptr mc, decoded_instruction* ins);
+
+
+/**
+ * invalidate_blocks function frees the cached blocks that contain an address.
+ *
+ * @param mc - a pointer to the machine.
+ * @param addr - the address.
+ */
+void invalidate_blocks(machine_ptr mc, int addr);
+
+
+/**
+ * free_block_cache function frees all cached blocks.
+ */
+void free_block_cache();
+
+
+#endif
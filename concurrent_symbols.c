@@ -0,0 +1,365 @@
+/**
+ * This file contains all functions related to the concurrent symbol table of the 'assembler': a hash table of labels that threads insert
+ * definitions and declarations into at the same time, with the rules of insert function in 'symbol_table.c', and the same result and errors as
+ * if they were inserted one by one in the order of the source file.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for threads */
+#include <pthread.h>
+#include "concurrent_symbols.h"
+#include "emergency_free_mem.h"
+
+static ss_ptr* symbol_buckets = NULL;	/* the concurrent symbol table, each bucket is a list of labels */
+static unsigned long symbols_mask = 0;	/* the number of buckets - 1 (the number of buckets is a power of 2) */
+static pthread_mutex_t symbol_locks[SYMBOL_LOCK_STRIPES];	/* the locks of the buckets */
+
+
+/**
+ * create_concurrent_symbols function creates an empty concurrent symbol table.
+ *
+ * @param labels_num - the number of labels the table is expected to hold.
+ */
+void create_concurrent_symbols(long labels_num)
+{
+	unsigned long buckets_num;
+	int i;
+
+	/* at least one bucket per lock, so every bucket is locked by one lock */
+	for(buckets_num = SYMBOL_LOCK_STRIPES; buckets_num < (unsigned long) labels_num; buckets_num *= 2)
+		;
+
+	symbol_buckets = calloc(buckets_num, sizeof(ss_ptr));
+
+	/* verify if calloc worked as expected */
+	if(symbol_buckets == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	symbols_mask = buckets_num - 1;
+	for(i = 0; i < SYMBOL_LOCK_STRIPES; i++) {
+		pthread_mutex_init(&symbol_locks[i], NULL);
+	}
+}
+
+
+/**
+ * insert_concurrent_symbol function adds a definition or declaration of a label to the concurrent symbol table, from any thread.
+ *
+ * @param lbl - the label.
+ * @param IC - the number line in the file where the label is defined.
+ * @param att - the attribute of the label.
+ * @param line - the line in the source file where the label is defined or declared.
+ * @param seq - the sequence number of the definition.
+ * @return - 1 if the definition was inserted, 0 if memory could not be allocated.
+ */
+int insert_concurrent_symbol(const char* lbl, int IC, attribute att, int line, long seq)
+{
+	pthread_mutex_t* lock;
+	symbol_event* events;
+	unsigned long bucket;
+	ss_ptr s;
+	int pos;
+
+	bucket = symbol_hash(lbl) & symbols_mask;
+	lock = &symbol_locks[bucket % SYMBOL_LOCK_STRIPES];
+	pthread_mutex_lock(lock);
+
+	for(s = symbol_buckets[bucket]; s != NULL && strcmp(s -> symbol.label, lbl) != 0; s = s -> next)
+		;
+
+	if(s == NULL)	/* the first definition of the label that got to the table */
+	{
+		s = malloc(sizeof(shared_symbol));
+		events = malloc(SYMBOL_EVENTS_INITIAL_SIZE * sizeof(symbol_event));
+		if(s == NULL || events == NULL)
+		{
+			free(s);
+			free(events);
+			pthread_mutex_unlock(lock);
+			return 0;
+		}
+
+		strcpy(s -> symbol.label, lbl);
+		s -> events = events;
+		s -> events_num = 0;
+		s -> events_size = SYMBOL_EVENTS_INITIAL_SIZE;
+		s -> next = symbol_buckets[bucket];
+		symbol_buckets[bucket] = s;
+	}
+	else if(s -> events_num == s -> events_size)
+	{
+		events = realloc(s -> events, s -> events_size * 2 * sizeof(symbol_event));
+		if(events == NULL)
+		{
+			pthread_mutex_unlock(lock);
+			return 0;
+		}
+		s -> events = events;
+		s -> events_size *= 2;
+	}
+
+	/* the events stay sorted by their sequence numbers */
+	for(pos = s -> events_num; pos > 0 && s -> events[pos - 1].seq > seq; pos--) {
+		s -> events[pos] = s -> events[pos - 1];
+	}
+	s -> events[pos].seq = seq;
+	s -> events[pos].IC = IC;
+	s -> events[pos].att = att;
+	s -> events[pos].line = line;
+	s -> events_num++;
+
+	/* a definition after all others is applied to the label as it is, one before them changes what they found so all are applied again */
+	apply_symbol_events(s, pos == s -> events_num - 1 ? pos : 0);
+
+	pthread_mutex_unlock(lock);
+	return 1;
+}
+
+
+/**
+ * apply_symbol_events function applies the events of a label to its node.
+ *
+ * @param s - the pointer to the label.
+ * @param from - the index of the first event that was not applied yet.
+ */
+void apply_symbol_events(ss_ptr s, int from)
+{
+	char label[MAX_LABEL_LENGTH + 1];
+	symbol_event* e;
+	int i;
+
+	if(from == 0)
+	{
+		strcpy(label, s -> symbol.label);
+		e = &s -> events[0];
+		init_symbol(&s -> symbol, label, e -> IC, e -> att, e -> line);
+		e -> err = NO_ERRORS;
+		from = 1;
+	}
+
+	for(i = from; i < s -> events_num; i++)
+	{
+		e = &s -> events[i];
+		e -> err = NO_ERRORS;
+		merge_symbol(&s -> symbol, e -> IC, e -> att, e -> line, &e -> err);
+	}
+}
+
+
+/**
+ * concurrent_symbol_errors function returns the definitions and declarations of the concurrent symbol table that are errors, in order.
+ *
+ * @param errors - a pointer to where to store the array of the events.
+ * @return - the number of errors.
+ */
+long concurrent_symbol_errors(symbol_event** errors)
+{
+	unsigned long bucket;
+	long errors_num;
+	ss_ptr s;
+	int i;
+
+	for(errors_num = 0, bucket = 0; bucket <= symbols_mask; bucket++) {
+		for(s = symbol_buckets[bucket]; s != NULL; s = s -> next) {
+			for(i = 0; i < s -> events_num; i++) {
+				errors_num += s -> events[i].err != NO_ERRORS;
+			}
+		}
+	}
+
+	*errors = NULL;
+	if(errors_num == 0) {
+		return 0;
+	}
+
+	*errors = malloc(errors_num * sizeof(symbol_event));
+
+	/* verify if malloc worked as expected */
+	if(*errors == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		free_concurrent_symbols();
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(errors_num = 0, bucket = 0; bucket <= symbols_mask; bucket++) {
+		for(s = symbol_buckets[bucket]; s != NULL; s = s -> next) {
+			for(i = 0; i < s -> events_num; i++) {
+				if(s -> events[i].err != NO_ERRORS) {
+					(*errors)[errors_num++] = s -> events[i];
+				}
+			}
+		}
+	}
+
+	qsort(*errors, errors_num, sizeof(symbol_event), compare_symbol_seqs);
+
+	return errors_num;
+}
+
+
+/**
+ * export_concurrent_symbols function creates a symbol table (list) of the labels of the concurrent symbol table, in the order of their first
+ * definitions.
+ *
+ * @param head - the pointer to the pointer where to store the head of the list.
+ * @param curr - the pointer to the pointer where to store the last node of the list.
+ */
+void export_concurrent_symbols(symb_ptr* head, symb_ptr* curr)
+{
+	unsigned long bucket;
+	ss_ptr* labels;
+	symb_ptr p;
+	long labels_num;
+	long i;
+	ss_ptr s;
+
+	for(labels_num = 0, bucket = 0; bucket <= symbols_mask; bucket++) {
+		for(s = symbol_buckets[bucket]; s != NULL; s = s -> next) {
+			labels_num++;
+		}
+	}
+
+	labels = malloc((labels_num + 1) * sizeof(ss_ptr));	/* +1 so an empty table doesn't ask for 0 bytes */
+
+	/* verify if malloc worked as expected */
+	if(labels == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		free_concurrent_symbols();
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(labels_num = 0, bucket = 0; bucket <= symbols_mask; bucket++) {
+		for(s = symbol_buckets[bucket]; s != NULL; s = s -> next) {
+			labels[labels_num++] = s;
+		}
+	}
+
+	qsort(labels, labels_num, sizeof(ss_ptr), compare_first_seqs);
+
+	*head = NULL;
+	*curr = NULL;
+	for(i = 0; i < labels_num; i++)
+	{
+		p = malloc(sizeof(symb));
+
+		/* verify if malloc worked as expected */
+		if(p == NULL)
+		{
+			free(labels);
+			free_symb_list(head);
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			free_concurrent_symbols();
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+
+		*p = labels[i] -> symbol;
+		p -> next = NULL;
+		if(*head == NULL) {
+			*head = p;
+		}
+		else (*curr) -> next = p;
+		*curr = p;
+	}
+
+	free(labels);
+}
+
+
+/**
+ * free_concurrent_symbols function frees the concurrent symbol table.
+ */
+void free_concurrent_symbols()
+{
+	unsigned long bucket;
+	ss_ptr s;
+	int i;
+
+	if(symbol_buckets == NULL) {
+		return;
+	}
+
+	for(bucket = 0; bucket <= symbols_mask; bucket++)
+	{
+		while(symbol_buckets[bucket] != NULL)
+		{
+			s = symbol_buckets[bucket];
+			symbol_buckets[bucket] = s -> next;
+			free(s -> events);
+			free(s);
+		}
+	}
+
+	free(symbol_buckets);
+	symbol_buckets = NULL;
+	symbols_mask = 0;
+	for(i = 0; i < SYMBOL_LOCK_STRIPES; i++) {
+		pthread_mutex_destroy(&symbol_locks[i]);
+	}
+}
+
+
+/**
+ * symbol_hash function returns the bucket of the concurrent symbol table for 'label' (djb2 hash).
+ *
+ * @param label - the label.
+ * @return - the hash value (the bucket is the hash value masked by the number of buckets).
+ */
+unsigned long symbol_hash(const char* label)
+{
+	unsigned long hash;
+
+	hash = 5381;
+	while(*label != '\0') {
+		hash = hash * 33 + (unsigned char)*label++;
+	}
+
+	return hash;
+}
+
+
+/**
+ * compare_symbol_seqs function compares 2 events by their sequence numbers (for qsort function).
+ *
+ * @param first - a pointer to the first event.
+ * @param second - a pointer to the second event.
+ * @return - a negative number, 0 or a positive number like strcmp function.
+ */
+int compare_symbol_seqs(const void* first, const void* second)
+{
+	long a_seq, b_seq;
+
+	a_seq = ((const symbol_event*) first) -> seq;
+	b_seq = ((const symbol_event*) second) -> seq;
+
+	return (a_seq > b_seq) - (a_seq < b_seq);
+}
+
+
+/**
+ * compare_first_seqs function compares 2 labels of the concurrent symbol table by the sequence numbers of their first events (for qsort
+ * function).
+ *
+ * @param first - a pointer to the pointer to the first label.
+ * @param second - a pointer to the pointer to the second label.
+ * @return - a negative number, 0 or a positive number like strcmp function.
+ */
+int compare_first_seqs(const void* first, const void* second)
+{
+	long a_seq, b_seq;
+
+	a_seq = (*(const ss_ptr*) first) -> events[0].seq;
+	b_seq = (*(const ss_ptr*) second) -> events[0].seq;
+
+	return (a_seq > b_seq) - (a_seq < b_seq);
+}
@@ -0,0 +1,129 @@
+#ifndef CONCURRENT_SYMBOLS_H
+#define CONCURRENT_SYMBOLS_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "line_details.h"
+#include "symbol_table.h"	/* for the merge rules of insert function (init_symbol and merge_symbol functions) */
+#define SYMBOL_LOCK_STRIPES 64	/* the number of locks of the concurrent symbol table, bucket b is locked by lock b % SYMBOL_LOCK_STRIPES */
+#define SYMBOL_EVENTS_INITIAL_SIZE 4	/* the number of events a label of the concurrent symbol table has room for, it doubles when it's full */
+
+
+/* a struct that represents one definition or declaration of a label, like one call to insert function. The sequence number is the order of
+ * the definition in the source file (the order insert function would be called) */
+typedef struct symbol_event {
+	long seq;
+	int IC;
+	attribute att;
+	int line;
+	ERR_VALUE err;	/* the error insert function would report for this definition (NO_ERRORS if there is none) */
+} symbol_event;
+
+
+/* a pointer to struct shared_symbol */
+typedef struct shared_symbol* ss_ptr;
+
+/* a struct that represents a label in the concurrent symbol table: the node insert function would create for it, and all its definitions and
+ * declarations in the order of their sequence numbers. Labels with the same hash value are chained in a list */
+typedef struct shared_symbol {
+	symb symbol;	/* the label after all its events were applied in order */
+	symbol_event* events;	/* the events of the label, sorted by their sequence numbers */
+	int events_num;
+	int events_size;	/* the number of events there is room for */
+	ss_ptr next;	/* the next label in the same bucket */
+} shared_symbol;
+
+
+/**
+ * create_concurrent_symbols function creates an empty concurrent symbol table: a hash table whose buckets are locked by SYMBOL_LOCK_STRIPES
+ * locks, so threads that insert different labels rarely wait for each other. The number of buckets doesn't change, so a lookup only holds the
+ * lock of its own bucket.
+ *
+ * @param labels_num - the number of labels the table is expected to hold.
+ */
+void create_concurrent_symbols(long labels_num);
+
+
+/**
+ * insert_concurrent_symbol function adds a definition or declaration of a label to the concurrent symbol table, from any thread. It applies
+ * the rules of insert function (see init_symbol and merge_symbol functions in 'symbol_table.h') while it holds the lock of the bucket of the
+ * label, in the order of the sequence numbers and not in the order the threads got to the table: a definition that comes before the ones
+ * already inserted is put in its place and the label is applied again from its first definition. So the table and the errors are the same as
+ * if insert function was called for all definitions in the order of their sequence numbers, whatever the threads do.
+ *
+ * @param lbl - the label.
+ * @param IC - the number line in the file where the label is defined.
+ * @param att - the attribute of the label.
+ * @param line - the line in the source file where the label is defined or declared.
+ * @param seq - the sequence number of the definition (unique).
+ * @return - 1 if the definition was inserted, 0 if memory could not be allocated (nothing is printed, it can be called from any thread).
+ */
+int insert_concurrent_symbol(const char* lbl, int IC, attribute att, int line, long seq);
+
+
+/**
+ * apply_symbol_events function applies the events of a label, from its first event, to its node (like insert function would).
+ *
+ * @param s - the pointer to the label.
+ * @param from - the index of the first event that was not applied yet (0 to apply all of them again).
+ */
+void apply_symbol_events(ss_ptr s, int from);
+
+
+/**
+ * concurrent_symbol_errors function returns the definitions and declarations of the concurrent symbol table that are errors, in the order of
+ * their sequence numbers. It must be called when no thread inserts labels anymore.
+ *
+ * @param errors - a pointer to where to store the array of the events (must be freed, NULL if there are no errors).
+ * @return - the number of errors.
+ */
+long concurrent_symbol_errors(symbol_event** errors);
+
+
+/**
+ * export_concurrent_symbols function creates a symbol table (list) of the labels of the concurrent symbol table, in the order of their first
+ * definitions, like the list insert function creates. It must be called when no thread inserts labels anymore.
+ *
+ * @param head - the pointer to the pointer where to store the head of the list.
+ * @param curr - the pointer to the pointer where to store the last node of the list.
+ */
+void export_concurrent_symbols(symb_ptr* head, symb_ptr* curr);
+
+
+/**
+ * free_concurrent_symbols function frees the concurrent symbol table.
+ */
+void free_concurrent_symbols();
+
+
+/**
+ * symbol_hash function returns the bucket of the concurrent symbol table for 'label' (djb2 hash).
+ *
+ * @param label - the label.
+ * @return - the index of the bucket.
+ */
+unsigned long symbol_hash(const char* label);
+
+
+/**
+ * compare_symbol_seqs function compares 2 events by their sequence numbers (for qsort function).
+ *
+ * @param first - a pointer to the first event.
+ * @param second - a pointer to the second event.
+ * @return - a negative number, 0 or a positive number like strcmp function.
+ */
+int compare_symbol_seqs(const void* first, const void* second);
+
+
+/**
+ * compare_first_seqs function compares 2 labels of the concurrent symbol table by the sequence numbers of their first events (for qsort
+ * function).
+ *
+ * @param first - a pointer to the pointer to the first label.
+ * @param second - a pointer to the pointer to the second label.
+ * @return - a negative number, 0 or a positive number like strcmp function.
+ */
+int compare_first_seqs(const void* first, const void* second);
+
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * This file contains all functions related to the dependency ('.d') file of the 'assembler'. The files a source file reads ('.include' and
+ * '.incbin' files) are recorded while the source file is processed, so the '.d' file is written without reading the source file again.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "dependency.h"
+#include "emergency_free_mem.h"
+
+static dep_ptr head_dep = NULL;	/* the first dependency of the currently processed source file */
+static dep_ptr curr_dep = NULL;	/* the last dependency of the currently processed source file */
+
+
+/**
+ * add_dependency function adds a file to the dependencies of the currently processed source file, unless it was already added.
+ *
+ * @param path - the name of the file.
+ */
+void add_dependency(const char* path)
+{
+	dep_ptr d;
+
+	for(d = head_dep; d != NULL; d = d -> next) {
+		if(strcmp(d -> path, path) == 0) {
+			return;
+		}
+	}
+
+	d = malloc(sizeof(dependency));
+
+	/* verify if malloc worked as expected */
+	if(d == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	d -> path = malloc(strlen(path) + 1);
+
+	/* verify if malloc worked as expected */
+	if(d -> path == NULL)
+	{
+		free(d);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	strcpy(d -> path, path);
+	d -> next = NULL;
+
+	if(head_dep == NULL) {
+		head_dep = d;
+	}
+	else curr_dep -> next = d;
+	curr_dep = d;
+}
+
+
+/**
+ * create_dependency_file function creates the '.d' file of the currently processed source file.
+ *
+ * @param fn - the name of the source file (with .as extension).
+ */
+void create_dependency_file(const char* fn)
+{
+	char* file_name;
+	FILE* fp;
+	dep_ptr d;
+
+	file_name = malloc(strlen(fn) + 1);	/* .d and .ob extensions are not longer than .as extension, +1 for string terminator char */
+
+	/* verify if malloc worked as expected */
+	if(file_name == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	strcpy(file_name, fn);
+	file_name[strlen(file_name) - 3] = '\0'; /* remove .as extension */
+	strcat(file_name, D_EXTENSION);	/* add .d extension */
+
+	fp = fopen(file_name, "w+");
+
+	if(fp == NULL) {
+		free(file_name);
+		printf("Could not create dependency file.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	/* the rule of the object file */
+	file_name[strlen(file_name) - 2] = '\0'; /* remove .d extension */
+	write_dependency_path(fp, file_name);
+	fputs(OB_TARGET_EXTENSION ": ", fp);
+	write_dependency_path(fp, fn);
+	for(d = head_dep; d != NULL; d = d -> next) {
+		fputs(" \\\n ", fp);
+		write_dependency_path(fp, d -> path);
+	}
+	fputc('\n', fp);
+
+	/* an empty rule for every dependency */
+	for(d = head_dep; d != NULL; d = d -> next) {
+		fputc('\n', fp);
+		write_dependency_path(fp, d -> path);
+		fputs(":\n", fp);
+	}
+
+	strcat(file_name, D_EXTENSION);
+	printf("\nFile '%s' has been created successfully!", file_name);
+
+	fclose(fp);
+	free(file_name);
+}
+
+
+/**
+ * write_dependency_path function writes a file name to the '.d' file, escaping the characters make treats as special.
+ *
+ * @param fp - the pointer to the '.d' file.
+ * @param path - the name of the file.
+ */
+void write_dependency_path(FILE* fp, const char* path)
+{
+	for(; *path != '\0'; path++)
+	{
+		if(*path == ' ' || *path == '#' || *path == ':') {
+			fputc('\\', fp);
+		}
+		else if(*path == '$') {
+			fputc('$', fp);	/* make escapes '$' as "$$" */
+		}
+		fputc(*path, fp);
+	}
+}
+
+
+/**
+ * free_dependencies function frees the dependencies of the currently processed source file.
+ */
+void free_dependencies()
+{
+	dep_ptr d;
+
+	while(head_dep != NULL)
+	{
+		d = head_dep;
+		head_dep = d -> next;
+		free(d -> path);
+		free(d);
+	}
+	curr_dep = NULL;
+}
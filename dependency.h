@@ -0,0 +1,53 @@
+#ifndef DEPENDENCY_H
+#define DEPENDENCY_H
+#define D_EXTENSION ".d"
+#define OB_TARGET_EXTENSION ".ob"	/* the target of the rule in the '.d' file */
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+
+
+/* a pointer to struct dependency */
+typedef struct dependency* dep_ptr;
+
+/* a struct that represents a file the currently processed source file depends on (list) */
+typedef struct dependency {
+	char* path;	/* the name of the file, as it appeared in the '.include' / '.incbin' line */
+	dep_ptr next;
+} dependency;
+
+
+/**
+ * add_dependency function adds a file to the dependencies of the currently processed source file. A file that was already added is ignored,
+ * so every file appears once, in the order it was first read.
+ *
+ * @param path - the name of the file.
+ */
+void add_dependency(const char* path);
+
+
+/**
+ * create_dependency_file function creates the '.d' file of the currently processed source file. The file is a make rule:
+ * "file.ob: file.as dependencies..." followed by an empty rule for every dependency, so make doesn't fail when an included file is deleted.
+ *
+ * @param fn - the name of the source file (with .as extension).
+ */
+void create_dependency_file(const char* fn);
+
+
+/**
+ * write_dependency_path function writes a file name to the '.d' file, escaping the characters make treats as special.
+ *
+ * @param fp - the pointer to the '.d' file.
+ * @param path - the name of the file.
+ */
+void write_dependency_path(FILE* fp, const char* path);
+
+
+/**
+ * free_dependencies function frees the dependencies of the currently processed source file.
+ */
+void free_dependencies();
+
+
+#endif
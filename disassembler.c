@@ -0,0 +1,270 @@
+/**
+ * This is the main file of the 'disassembler'. It prints assembled images ('.ob' files) as assembly, decoding every word with the tables of
+ * the instruction set (see 'isa.h').
+ * Usage: disassembler [-s] [-b] image...
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "disassembler.h"
+#include "emergency_free_mem.h"
+
+om_ptr curr_image = NULL;	/* the image currently printed */
+machine_ptr curr_machine = NULL;	/* the machine a snapshot is restored into */
+const char** curr_labels = NULL;	/* the labels of the image currently printed, see create_symbol_index function */
+const char** curr_refs = NULL;	/* the external labels of the image currently printed */
+
+
+/* main function */
+int main(int argc, char* argv[])
+{
+	int snapshots;
+	int benchmark;
+	int failed;
+	int i;
+
+	if(argc < 2) {
+		printf("No images to disassemble. Usage: disassembler [-s] [-b] image...\n");
+		exit(EXIT_FAILURE);
+	}
+
+	snapshots = 0;
+	benchmark = 0;
+	for(i = 1; i < argc; i++) {
+		if(strcmp(argv[i], SNAPSHOT_INPUT_OPTION) == 0) {
+			snapshots = 1;
+		}
+		else if(strcmp(argv[i], BENCHMARK_OPTION) == 0) {
+			benchmark = 1;
+		}
+		else if(argv[i][0] == '-') {
+			printf("Unknown option '%s'. Program terminated.\n", argv[i]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	for(failed = 0, i = 1; i < argc; i++) {
+		if(argv[i][0] == '-') {
+			continue;
+		}
+		if(benchmark && !snapshots) {
+			if(!benchmark_image(argv[i])) {
+				failed++;
+			}
+		}
+		else if(!(snapshots ? disassemble_snapshot(argv[i]) : disassemble_image(argv[i]))) {
+			failed++;
+		}
+	}
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+/**
+ * disassemble_image function prints an image as assembly.
+ *
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the image was printed, otherwise 0 is returned.
+ */
+int disassemble_image(const char* name)
+{
+	isa_image img;
+
+	curr_image = load_object_module(name);
+	if(curr_image == NULL) {
+		return 0;
+	}
+
+	curr_labels = create_symbol_index(curr_image -> entries, curr_image -> ic + curr_image -> dc);
+	curr_refs = create_symbol_index(curr_image -> externs, curr_image -> ic + curr_image -> dc);
+
+	img.words = curr_image -> words;
+	img.words_num = curr_image -> ic + curr_image -> dc;
+	img.code_num = curr_image -> ic;
+	img.first_addr = FIRST_ADDRESS;
+	img.labels = curr_labels;
+	img.refs = curr_refs;
+
+	printf("; image '%s%s': %d code words, %d data words\n", name, OB_EXTENSION, curr_image -> ic, curr_image -> dc);
+	print_disassembly(&img, curr_image -> tags);
+
+	free((void*) curr_labels);
+	curr_labels = NULL;
+	free((void*) curr_refs);
+	curr_refs = NULL;
+	free_object_modules(&curr_image);
+
+	return 1;
+}
+
+
+/**
+ * disassemble_snapshot function prints the memory saved in the snapshot of an image as assembly.
+ *
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the snapshot was printed, otherwise 0 is returned.
+ */
+int disassemble_snapshot(const char* name)
+{
+	isa_image img;
+	int memory_end;
+
+	curr_machine = restore_snapshot(name);
+	if(curr_machine == NULL) {
+		return 0;
+	}
+
+	for(memory_end = MEMORY_SIZE; memory_end > curr_machine -> code_end && curr_machine -> memory[memory_end - 1] == 0; memory_end--)
+		;
+
+	img.words = curr_machine -> memory + FIRST_ADDRESS;
+	img.words_num = memory_end - FIRST_ADDRESS;
+	img.code_num = curr_machine -> code_end - FIRST_ADDRESS;
+	img.first_addr = FIRST_ADDRESS;
+	img.labels = NULL;
+	img.refs = NULL;
+
+	printf("; snapshot '%s%s': %d code words, %d data words, pc %04d\n", name, SNAPSHOT_EXTENSION, img.code_num, img.words_num - img.code_num,
+		curr_machine -> pc);
+	print_disassembly(&img, NULL);
+
+	free(curr_machine);
+	curr_machine = NULL;
+
+	return 1;
+}
+
+
+/**
+ * benchmark_image function loads an image BENCHMARK_ROUNDS times and prints the fastest load.
+ *
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the image was loaded, otherwise 0 is returned.
+ */
+int benchmark_image(const char* name)
+{
+	char* file_name;
+	FILE* fp;
+	clock_t start;
+	double seconds, best;
+	long bytes;
+	long words;
+	int i;
+
+	file_name = module_file_name(name, OB_EXTENSION);
+	fp = fopen(file_name, "rb");
+	free(file_name);
+	bytes = 0;
+	if(fp != NULL) {
+		fseek(fp, 0, SEEK_END);
+		bytes = ftell(fp);
+		fclose(fp);
+	}
+
+	for(best = -1, words = 0, i = 0; i < BENCHMARK_ROUNDS; i++) {
+		start = clock();
+		curr_image = load_object_module(name);
+		seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+		if(curr_image == NULL) {
+			return 0;
+		}
+		words = curr_image -> ic + curr_image -> dc;
+		free_object_modules(&curr_image);
+		if(best < 0 || seconds < best) {
+			best = seconds;
+		}
+	}
+
+	if(best > 0) {
+		printf("%s: %ld words (%ld bytes) loaded in %.3f ms, %.1f million words per second, %.1f MB per second\n", name, words, bytes,
+			best * 1000, words / best / 1000000, bytes / best / 1000000);
+	}
+	else printf("%s: %ld words (%ld bytes) loaded in less than the resolution of the clock\n", name, words, bytes);
+
+	return 1;
+}
+
+
+/**
+ * print_disassembly function prints the words of an image as assembly.
+ *
+ * @param img - a pointer to the image.
+ * @param tags - the A/R/E tag of every word, or NULL if the tags are not known.
+ */
+void print_disassembly(const isa_image* img, const char* tags)
+{
+	char text[DISASSEMBLY_TEXT_LENGTH];
+	char label[MAX_SYMBOL_LENGTH + 2];	/* +2 for ':' and the string terminator char */
+	int len;
+	int i;
+
+	for(i = 0; i < img -> words_num; i += len) {
+		len = disassemble(img, i, text);
+		label[0] = '\0';
+		if(img -> labels != NULL && img -> labels[i] != NULL) {
+			sprintf(label, "%.*s:", MAX_SYMBOL_LENGTH, img -> labels[i]);
+		}
+		printf("%04d  %03X %c  %-*s %s\n", img -> first_addr + i, img -> words[i] & ISA_WORD_MASK, tags != NULL ? tags[i] : '-',
+			MAX_SYMBOL_LENGTH + 1, label, text);
+	}
+}
+
+
+/**
+ * create_symbol_index function creates an array of the labels of a list of symbol references, indexed by their addresses in an image.
+ *
+ * @param head - the head of the list.
+ * @param words_num - the number of words of the image.
+ * @return - the array (must be freed), or NULL if the list is empty.
+ */
+const char** create_symbol_index(sr_ptr head, int words_num)
+{
+	const char** index;
+	sr_ptr p;
+
+	if(head == NULL) {
+		return NULL;
+	}
+
+	index = calloc(words_num + 1, sizeof(char*));	/* +1 so an empty image doesn't ask for 0 bytes */
+
+	/* verify if calloc worked as expected */
+	if(index == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(p = head; p != NULL; p = p -> next) {
+		if(p -> addr >= FIRST_ADDRESS && p -> addr < FIRST_ADDRESS + words_num) {
+			index[p -> addr - FIRST_ADDRESS] = p -> label;
+		}
+	}
+
+	return index;
+}
+
+
+/**
+ * emergency_free_mem function frees all memory allocated during the execution. This function is called ONLY if any memory allocation fails.
+ * This function is not included in any .header file ('only in emergency_free.mem_h') to prevent using it accidentally.
+ */
+void emergency_free_mem()
+{
+	free_object_modules(&curr_image);
+	if(curr_machine != NULL) {
+		free(curr_machine);
+	}
+	curr_machine = NULL;
+	if(curr_labels != NULL) {
+		free((void*) curr_labels);
+	}
+	curr_labels = NULL;
+	if(curr_refs != NULL) {
+		free((void*) curr_refs);
+	}
+	curr_refs = NULL;
+}
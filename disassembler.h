@@ -0,0 +1,65 @@
+#ifndef DISASSEMBLER_H
+#define DISASSEMBLER_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>	/* for clock function */
+#include "object_module.h"
+#include "machine.h"
+#include "snapshot.h"
+#include "isa.h"
+#define SNAPSHOT_INPUT_OPTION "-s"	/* disassemble the memory saved in <image>.snap (see 'snapshot.h') instead of <image>.ob */
+#define BENCHMARK_OPTION "-b"	/* load the images without printing them and report the throughput of the loader (see load_object_module) */
+#define BENCHMARK_ROUNDS 5	/* the number of times an image is loaded by benchmark_image function, the fastest is reported */
+
+
+/**
+ * disassemble_image function prints an image as assembly, one instruction or data word in a line: its address, its first word and A/R/E tag,
+ * the label defined at its address, and the instruction. The labels are taken from the '.ent' and '.ext' files of the image.
+ *
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the image was printed, otherwise 0 is returned.
+ */
+int disassemble_image(const char* name);
+
+
+/**
+ * disassemble_snapshot function prints the memory saved in the snapshot of an image as assembly, like disassemble_image function (a snapshot
+ * has no tags and no labels).
+ *
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the snapshot was printed, otherwise 0 is returned.
+ */
+int disassemble_snapshot(const char* name);
+
+
+/**
+ * benchmark_image function loads an image BENCHMARK_ROUNDS times and prints the fastest load: the words and bytes of the '.ob' file read per
+ * second.
+ *
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the image was loaded, otherwise 0 is returned.
+ */
+int benchmark_image(const char* name);
+
+
+/**
+ * print_disassembly function prints the words of an image as assembly.
+ *
+ * @param img - a pointer to the image.
+ * @param tags - the A/R/E tag of every word, or NULL if the tags are not known.
+ */
+void print_disassembly(const isa_image* img, const char* tags);
+
+
+/**
+ * create_symbol_index function creates an array of the labels of a list of symbol references, indexed by their addresses in an image.
+ *
+ * @param head - the head of the list.
+ * @param words_num - the number of words of the image (references outside of it are ignored).
+ * @return - the array (must be freed, the labels belong to the list), or NULL if the list is empty.
+ */
+const char** create_symbol_index(sr_ptr head, int words_num);
+
+
+#endif
@@ -134,7 +134,7 @@ void add_error(int ln, ERR_VALUE err, err_ptr * curr, err_ptr * head, const char
 	{UNDEFINED_LABEL, "Undefined label."},
 
 	/* error_messages[35] */
-	{LABEL_NAME_LIKE_KEYWORD_NAME, "Label name like keyword name. Keywords: data,\nstring, entry, extern, PSW."},
+	{LABEL_NAME_LIKE_KEYWORD_NAME, "Label name like keyword name. Keywords: data,\nstring, incbin, fill, space, include, entry, extern,\nmcr, endmcr, PSW."},
 
 	/* error_messages[36] */
 	{UNDEFINED_LABEL_IN_DESTINATION_OPERAND, "Undefined label in destination operand."},
@@ -169,7 +169,49 @@ void add_error(int ln, ERR_VALUE err, err_ptr * curr, err_ptr * head, const char
 	/* error_messages[46] */
 	{DATA_DOESNT_END_WITH_A_NUMBER, "Data doesn't end with an integer."},
         
-	/* error_messages[47 */
+	/* error_messages[47] */
+	{MISSING_INFORMATION_AFTER_INCBIN, "Missing information after .incbin."},
+
+	/* error_messages[48] */
+	{INCBIN_BAD_SYNTAX, "Invalid .incbin syntax. A file name between\nquatation marks is expected, optionally followed by\na comma and the word size (8 or 12)."},
+
+	/* error_messages[49] */
+	{INCBIN_FILE_NOT_FOUND, "The file of .incbin could not be opened."},
+        
+	/* error_messages[50] */
+	{MISSING_INFORMATION_AFTER_FILL, "Missing information after .fill/.space."},
+
+	/* error_messages[51] */
+	{INVALID_FILL, "Invalid .fill/.space operands. A non negative\nnumber of words that fits in the memory is\nexpected, .fill may be followed by a comma and\nthe value of the words."},
+        
+	/* error_messages[52] */
+	{INVALID_MACRO_NAME, "Invalid macro definition. A valid name (same rules\nlike of a label) is expected after mcr."},
+
+	/* error_messages[53] */
+	{DUPLICATE_MACRO_NAME, "Failed attempt to duplicate a macro."},
+
+	/* error_messages[54] */
+	{MISSING_ENDMCR, "Macro definition doesn't end with endmcr."},
+        
+	/* error_messages[55] */
+	{MISSING_INFORMATION_AFTER_INCLUDE, "Missing information after .include."},
+
+	/* error_messages[56] */
+	{INCLUDE_BAD_SYNTAX, "Invalid .include syntax. A file name between\nquatation marks is expected."},
+
+	/* error_messages[57] */
+	{INCLUDE_FILE_NOT_FOUND, "The file of .include could not be opened."},
+        
+	/* error_messages[58] */
+	{LABEL_BEFORE_INCLUDE, "A label can't be defined before .include."},
+
+	/* error_messages[59] */
+	{INCLUDE_NESTED_TOO_DEEP, "Includes are nested too deep (an included file\nprobably includes itself)."},
+        
+	/* error_messages[60] */
+	{INCBIN_TOO_LARGE, "The file of .incbin doesn't fit in the memory."},
+
+	/* error_messages[61] */
 	{NO_ERRORS, "No errors."}
 
 	};
@@ -4,7 +4,7 @@
 #include <stdio.h>  /* for printf */
 #include <string.h> /* for strlen */
 #include "line_details.h"   /* for ERR_VALUE enum */
-#define NUM_OF_ERRORS 48    /* Number of all possible errors of the 'assembler' */
+#define NUM_OF_ERRORS 62    /* Number of all possible errors of the 'assembler' */
 
 
 /* error_node struct pointer definition */
@@ -16,6 +16,14 @@ static int curr_line;  /* current line in currently processed file */
 line_details* ptr = NULL;   /* line details struct will be initialized later in the code for saving the processed line relevant information */
 mcl_ptr head_mcl_ptr;  /* the head pointer to the memory_code_line list's node (the list is defined in 'memory_image.h') */
 mdl_ptr head_mdl_ptr;  /* the head pointer to the memory_data_line list's node (the list is defined in 'memory_image.h') */
+static mcl_ptr curr_mcl_ptr;  /* the current pointer to the memory_line list's node (the list is defined in 'memory_image.h') */
+static mdl_ptr curr_mdl_ptr;  /* the current pointer to the memory_line list's node */
+static rel_ptr head_rel_ptr;  /* the head pointer to the relocation table, filled by second_pass_label_check function (defined in 'memory_image.h') */
+static rel_ptr curr_rel_ptr;  /* the current pointer to the relocation table */
+static int IC;  /* the instruction counter */
+static int DC;  /* the data counter */
+static int include_depth;  /* the number of '.include' lines currently processed (nested) */
+static const char* lines_file;  /* the file the currently processed lines come from (the source file or an included file) */
 
 /**
  * file_processor is the main function of this file. It gets the file from 'main.c' and it operates all needed actions in order to process the file.
@@ -29,27 +37,22 @@ int file_processor(FILE** fp, const char* fn)
    /* variables definitions */
 	FILE* file; /* the pointer to the currently processed file */
 	const char* file_name;  /* the name of the currently processed file */
-	int IC;  /* the instruction counter */
-	int DC;  /* the data counter */
-	int line_len;  /* the length of the currently processed line */
-	char buffer[MAX_BUFFER_LENGTH];  /* currently processed line is stored in this buffer */
-	LINE_TYPE type;  /* used in 'switch case' in this funtion (file_processor function) as a result value from line_parser (in 'parser.c') function */
-	int i;  /* reusable index variable for loops in this file */
-
-	mcl_ptr curr_mcl_ptr;  /* the current pointer to the memory_line list's node (the list is defined in 'memory_image.h') */
-	mdl_ptr curr_mdl_ptr;  /* the current pointer to the memory_line list's node */
+	char* line;  /* the currently processed line, after macro expansion (see 'preprocessor.c') */
    
    /* variables initializations */
 	file = *fp;
 	file_name = fn;
 	IC = 100;
 	DC = 0;
-	curr_line = 1;
+	curr_line = 0;
+	include_depth = 0;
+	lines_file = file_name;
 	head_mcl_ptr = NULL;
 	curr_mcl_ptr = NULL;
 	head_mdl_ptr = NULL;
 	curr_mdl_ptr = NULL;
-	type = UNDEFINED_LINE;
+	head_rel_ptr = NULL;
+	curr_rel_ptr = NULL;
 
 	ptr = malloc(sizeof(line_details));
 
@@ -65,378 +68,548 @@ int file_processor(FILE** fp, const char* fn)
 	ptr -> src_adr = no_type;
 	ptr -> dest_adr = no_type;
 
-	while(fgets(buffer, MAX_BUFFER_LENGTH, file) != NULL)
-	{
+	start_preprocessor(file, file_name);
 
-		/* START - line length handling */
-		line_len = strlen(buffer);
+	if(is_pipeline_requested() && start_pipeline()) {	/* the lines are read and parsed on threads of their own, see 'pipeline.h' */
+		pipeline_processor(file_name);
+		end_pipeline();
+	}
+	else while((line = next_line(&curr_line)) != NULL)
+	{
 		ptr -> err = NO_ERRORS;  /* make sure its initialized as NO_ERRORS */
-		if(!feof(*fp)) {
-			if(is_long_line(line_len, count_whitespaces(buffer))) {
-				error_controller(curr_line, LONG_LINE, file_name);  /* add error */
-				if(!is_line_ending_with_newline_char(buffer, line_len)) {
-					find_next_line(fp);  /* line is too long, find where next line starts */
-				}
-				curr_line++;
-				continue;
-			}
+
+		line_processor(line_parser(line, ptr), file_name);
+	}
+
+	end_preprocessor();
+
+
+	/* update all DC values according to updated IC */	
+	update_DC(head_mdl_ptr, IC);
+	update_symb_table(IC);
+
+	/* check if all entry labels were defined correctly */
+	check_entry_labels();
+
+	/* verify that all labels that were used as operands were defined correctly */
+	second_pass_label_check(head_mcl_ptr, file_name);
+
+	/* final check if no errors occurred before creating files */
+	if(!were_errors() && (is_link_mode() || is_test_mode())) {	/* the module is linked with the other files / executed in memory, see link_program
+									 * function and 'tester.h' */
+		add_program_module(head_mcl_ptr, head_mdl_ptr, (IC-100), DC);
+		if(is_dependency_file_requested()) {
+			create_dependency_file(file_name);
+		}
+	}
+	else if(!were_errors() && !is_benchmark_mode()) {	/* nothing is written in benchmark mode, see benchmark_file function */
+		create_output_files(head_mcl_ptr, head_mdl_ptr, file_name, (IC-100), DC);	/* the '.ob', '.ent' and '.ext' files, see 'output_files.h' */
+		if(is_relocation_file_requested()) {
+			create_relocation_file(head_rel_ptr, file_name);
+		}
+		else remove_relocation_file(file_name);	/* a '.rel' file of an older version of the module doesn't match the new '.ob' file */
+		if(is_dependency_file_requested()) {
+			create_dependency_file(file_name);
 		}
-		/* END - line length handling */
+	}
 
+	/* frees */
+	free_code_image_nodes(&head_mcl_ptr);
+	head_mcl_ptr = NULL;
+	free_data_image_nodes(&head_mdl_ptr);
+	head_mdl_ptr = NULL;
+	free_relocation_nodes(&head_rel_ptr);
+	head_rel_ptr = NULL;
+	free(ptr);	/* free line_details struct */
+	ptr = NULL;
+	free_tokens_buffer();
+	free_dependencies();
 
-		type = line_parser(buffer, ptr);
+	if(!were_errors()) {
+		return 1;
+	}
+	else return 0;
+}
 
-       /* this 'switch case' gets a result from line_parser funtion (in 'parser.c') and handles it according to the result */
-		switch(type) {
-			case EMPTY:  /* Result from line_parser: an empty line */
-			{
-				curr_line++;
-				continue;
-			}
 
-			case COMMENT:  /* Result from line_parser: a comment line */
-			{
-				curr_line++;
-				continue;
-			}
+/**
+ * pipeline_processor function processes the lines the pipeline parsed, in order, like the serial loop of file_processor function.
+ *
+ * @param file_name - the name of the currently processed file.
+ */
+void pipeline_processor(const char* file_name)
+{
+	pipeline_batch* b;
+	int last;
+	int e;	/* the index of the next error of the preprocessor in the batch */
+	int i;
 
-			case ENTRY:  /* Result from line_parser: an entry line */
-			{
-				symb_controller(ptr -> label, IC, entry, &(ptr -> err));
-				break;
+	do {
+		b = next_parsed_batch();
+
+		for(i = 0, e = 0; i <= b -> lines_num; i++)
+		{
+			for(; e < b -> errors_num && b -> errors[e].before == i; e++) {	/* the errors found while the line was read */
+				error_controller(b -> errors[e].line, b -> errors[e].err, file_name);  /* add error */
 			}
 
-			case EXTERN:  /* Result from line_parser: an extern line */
-			{
-				symb_controller(ptr -> label, IC, external, &(ptr -> err));
-				break;
+			if(i < b -> lines_num) {
+				curr_line = b -> line_nums[i];
+				*ptr = b -> details[i];	/* the line details, like line_parser function has just filled them */
+				line_processor(b -> types[i], file_name);
 			}
+		}
 
-			case GUIDANCE_DATA_WITH_LABEL: /* Result from line_parser: a line that contains a label with data */
-			{
-				symb_controller(ptr -> label, DC, data, &(ptr -> err));
-				if(!were_errors())
-				{
-					for(i = 0; i < ptr -> num_in_data_array; i++) {
-						insert_memory_data_line(&head_mdl_ptr, &curr_mdl_ptr, DC, ptr -> data[i], ABSOLUTE);
-						DC++;
-					}
-				}
+		last = b -> last;
+		release_batch(b);
+	} while(!last);
+}
 
-				break;
-			}
 
-			case GUIDANCE_DATA_WITHOUT_LABEL:  /* Result from line_parser: a line that contains only data */
-			{
-				for(i = 0; i < ptr -> num_in_data_array; i++) {
-					insert_memory_data_line(&head_mdl_ptr, &curr_mdl_ptr, DC, ptr -> data[i], ABSOLUTE);
-					DC++;
-				}
+/**
+ * line_processor function processes a parsed line according to its type: it triggers the creation of the symbol, memory image and error nodes
+ * of the line. All relevant information of the line is taken from the line_details struct that line_parser function filled.
+ *
+ * @param type - the type of the line, the result of line_parser function.
+ * @param file_name - the name of the currently processed file.
+ */
+void line_processor(LINE_TYPE type, const char* file_name)
+{
+	char* val_ptr;  /* walks over the '.data' / '.string' payload while it's inserted to the data image */
+	int words;  /* the number of words an '.incbin' file added to the data image */
+	char* full_path;  /* the path of an '.incbin' file, relative to the directory of the file of the line (see resolve_path function) */
+
+	/* this 'switch case' gets a result from line_parser funtion (in 'parser.c') and handles it according to the result */
+	switch(type) {
+		case EMPTY:  /* Result from line_parser: an empty line */
+		{
+			break;
+		}
 
-				break;
-			}		
+		case COMMENT:  /* Result from line_parser: a comment line */
+		{
+			break;
+		}
 
-			case GUIDANCE_STRING_WITH_LABEL:  /* Result from line_parser: a line that contains a label with string */
-			{
-				symb_controller(ptr -> label, DC, data, &(ptr -> err));
-                
-				for(i = 0; i < strlen(ptr -> string); i++) {
-					insert_memory_data_line(&head_mdl_ptr, &curr_mdl_ptr, DC, ptr -> string[i], ABSOLUTE);
-					DC++;
-				}
-				insert_memory_data_line(&head_mdl_ptr, &curr_mdl_ptr, DC, 0, ABSOLUTE);	/* string null terminator */
-				DC++;
+		case ENTRY:  /* Result from line_parser: an entry line */
+		{
+			symb_controller(ptr -> label, IC, entry, &(ptr -> err));
+			break;
+		}
 
-				break;
-			}
+		case EXTERN:  /* Result from line_parser: an extern line */
+		{
+			symb_controller(ptr -> label, IC, external, &(ptr -> err));
+			break;
+		}
 
-			case GUIDANCE_STRING_WITHOUT_LABEL:  /* Result from line_parser: a line that contains only string */
+		case GUIDANCE_DATA_WITH_LABEL: /* Result from line_parser: a line that contains a label with data */
+		{
+			symb_controller(ptr -> label, DC, data, &(ptr -> err));
+			if(!were_errors())
 			{
-				for(i = 0; i < strlen(ptr -> string); i++) {
-					insert_memory_data_line(&head_mdl_ptr, &curr_mdl_ptr, DC, ptr -> string[i], ABSOLUTE);
+				val_ptr = ptr -> payload;
+				while(*val_ptr != '\0') {	/* payload is a valid data, numbers separated by commas */
+					insert_memory_data_line(&head_mdl_ptr, &curr_mdl_ptr, DC, (int) strtol(val_ptr, &val_ptr, 10), ABSOLUTE);
 					DC++;
+					if(*val_ptr == ',') {
+						val_ptr++;
+					}
 				}
+			}
 
-				break;
+			break;
+		}
+
+		case GUIDANCE_DATA_WITHOUT_LABEL:  /* Result from line_parser: a line that contains only data */
+		{
+			val_ptr = ptr -> payload;
+			while(*val_ptr != '\0') {	/* payload is a valid data, numbers separated by commas */
+				insert_memory_data_line(&head_mdl_ptr, &curr_mdl_ptr, DC, (int) strtol(val_ptr, &val_ptr, 10), ABSOLUTE);
+				DC++;
+				if(*val_ptr == ',') {
+					val_ptr++;
+				}
 			}
 
-			case INSTRUCTION_WITH_LABEL_2_OPERANDS:  /* Result from line_parser: a line that contains an operation, a label and 2 operands */
-			{
-				symb_controller(ptr -> label, IC, code, &(ptr -> err));
+			break;
+		}		
 
-				/* START - OPERATION TO MEMORY */
-				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_bits, ABSOLUTE, NO_OPERAND);
-				/* END - OPERATION TO MEMORY */
+		case GUIDANCE_STRING_WITH_LABEL:  /* Result from line_parser: a line that contains a label with string */
+		{
+			symb_controller(ptr -> label, DC, data, &(ptr -> err));
+               
+			for(val_ptr = ptr -> payload; *val_ptr != '\0'; val_ptr++) {
+				insert_memory_data_line(&head_mdl_ptr, &curr_mdl_ptr, DC, *val_ptr, ABSOLUTE);
+				DC++;
+			}
+			insert_memory_data_line(&head_mdl_ptr, &curr_mdl_ptr, DC, 0, ABSOLUTE);	/* string null terminator */
+			DC++;
 
-				IC++;
+			break;
+		}
+
+		case GUIDANCE_STRING_WITHOUT_LABEL:  /* Result from line_parser: a line that contains only string */
+		{
+			for(val_ptr = ptr -> payload; *val_ptr != '\0'; val_ptr++) {
+				insert_memory_data_line(&head_mdl_ptr, &curr_mdl_ptr, DC, *val_ptr, ABSOLUTE);
+				DC++;
+			}
 
+			break;
+		}
 
-				/* START - SOURCE TO MEMORY */
-				if(ptr -> src_adr == immediate) {
-					strcpy(ptr -> num_to_mem, ptr -> source);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, SOURCE_OP);
+		case GUIDANCE_INCBIN_WITH_LABEL:  /* Result from line_parser: a line that contains a label with a binary file */
+		{
+			symb_controller(ptr -> label, DC, data, &(ptr -> err));
+			if(!were_errors())
+			{
+				full_path = resolve_path(ptr -> payload);
+				words = insert_memory_data_blob(&head_mdl_ptr, &curr_mdl_ptr, DC, full_path, ptr -> incbin_bits, ABSOLUTE, MEMORY_SIZE - IC - DC);
+				if(words == -1) {
+					error_controller(curr_line, INCBIN_FILE_NOT_FOUND, file_name);  /* add error */
 				}
-				else if(ptr -> src_adr == direct) {
-					strcpy(ptr -> lbl_to_mem, ptr -> source);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, SOURCE_OP);
+				else if(words == -2) {	/* the words don't fit after the code and data so far */
+					error_controller(curr_line, INCBIN_TOO_LARGE, file_name);  /* add error */
 				}
-				else if(ptr -> src_adr == regis_direct) {
-					strcpy(ptr -> num_to_mem, regis_to_num(ptr -> source));
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, SOURCE_OP);
+				else {
+					DC += words;
+					add_dependency(full_path);
 				}
-				/* END - SOURCE TO MEMORY */
+				free(full_path);
+			}
 
-				IC++;
+			break;
+		}
 
-				/* START - DESTINATION TO MEMORY */
-				if(ptr -> dest_adr == immediate) {
-					strcpy(ptr -> num_to_mem, ptr -> destination);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
-				}
-				else if(ptr -> dest_adr == direct) {
-					strcpy(ptr -> lbl_to_mem, ptr -> destination);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, DESTINATION_OP);
+		case GUIDANCE_INCBIN_WITHOUT_LABEL:  /* Result from line_parser: a line that contains only a binary file */
+		{
+			full_path = resolve_path(ptr -> payload);
+			words = insert_memory_data_blob(&head_mdl_ptr, &curr_mdl_ptr, DC, full_path, ptr -> incbin_bits, ABSOLUTE, MEMORY_SIZE - IC - DC);
+			if(words == -1) {
+				error_controller(curr_line, INCBIN_FILE_NOT_FOUND, file_name);  /* add error */
+			}
+			else if(words == -2) {	/* the words don't fit after the code and data so far */
+				error_controller(curr_line, INCBIN_TOO_LARGE, file_name);  /* add error */
+			}
+			else {
+				DC += words;
+				add_dependency(full_path);
+			}
+			free(full_path);
+
+			break;
+		}
+
+		case GUIDANCE_FILL_WITH_LABEL:  /* Result from line_parser: a line that contains a label with a words reservation */
+		{
+			symb_controller(ptr -> label, DC, data, &(ptr -> err));
+			if(!were_errors())
+			{
+				if(ptr -> fill_count > MEMORY_SIZE - IC - DC) {	/* the words don't fit after the code and data so far */
+					error_controller(curr_line, INVALID_FILL, file_name);  /* add error */
 				}
-				else if(ptr -> dest_adr == regis_direct) {
-					strcpy(ptr -> num_to_mem, regis_to_num(ptr -> destination));
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
+				else {
+					insert_memory_data_run(&head_mdl_ptr, &curr_mdl_ptr, DC, ptr -> fill_count, ptr -> fill_value, ABSOLUTE);
+					DC += ptr -> fill_count;
 				}
-				/* END - DESTINATION TO MEMORY */
+			}
 
-				IC++;
+			break;
+		}
 
-				break;
+		case GUIDANCE_FILL_WITHOUT_LABEL:  /* Result from line_parser: a line that contains only a words reservation */
+		{
+			if(ptr -> fill_count > MEMORY_SIZE - IC - DC) {	/* the words don't fit after the code and data so far */
+				error_controller(curr_line, INVALID_FILL, file_name);  /* add error */
+			}
+			else {
+				insert_memory_data_run(&head_mdl_ptr, &curr_mdl_ptr, DC, ptr -> fill_count, ptr -> fill_value, ABSOLUTE);
+				DC += ptr -> fill_count;
 			}
 
-			case INSTRUCTION_WITH_LABEL_1_OPERAND:  /* Result from line_parser: a line that contains an operation, a label and 1 operand */
-			{
-				symb_controller(ptr -> label, IC, code, &(ptr -> err));
-                
-				ptr -> src_adr = 0;
+			break;
+		}
 
-				/* START - OPERATION TO MEMORY */
-				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_bits, ABSOLUTE, NO_OPERAND);
-				/* END - OPERATION TO MEMORY */
+		case INSTRUCTION_WITH_LABEL_2_OPERANDS:  /* Result from line_parser: a line that contains an operation, a label and 2 operands */
+		{
+			symb_controller(ptr -> label, IC, code, &(ptr -> err));
 
-				IC++;
+			/* START - OPERATION TO MEMORY */
+			insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_bits, ABSOLUTE, NO_OPERAND);
+			/* END - OPERATION TO MEMORY */
 
-				/* START - DESTINATION TO MEMORY */
-				if(ptr -> dest_adr == immediate) {
-					strcpy(ptr -> num_to_mem, ptr -> destination);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
-				}
-				else if(ptr -> dest_adr == direct) {
-					strcpy(ptr -> lbl_to_mem, ptr -> destination);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, DESTINATION_OP);
-				}
-				else if(ptr -> dest_adr == regis_direct) {
-					strcpy(ptr -> num_to_mem, regis_to_num(ptr -> destination));
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
-				}
-				else if(ptr -> dest_adr == relative) {
-					strcpy(ptr -> lbl_to_mem, ptr -> destination);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, relative_operand, ABSOLUTE, DESTINATION_OP);
-				}
-				/* END - DESTINATION TO MEMORY */
+			IC++;
 
-				IC++;
 
-				break;
+			/* START - SOURCE TO MEMORY */
+			if(ptr -> src_adr == immediate) {
+				strcpy(ptr -> num_to_mem, ptr -> source);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, SOURCE_OP);
 			}
+			else if(ptr -> src_adr == direct) {
+				strcpy(ptr -> lbl_to_mem, ptr -> source);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, SOURCE_OP);
+			}
+			else if(ptr -> src_adr == regis_direct) {
+				strcpy(ptr -> num_to_mem, regis_to_num(ptr -> source));
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, SOURCE_OP);
+			}
+			/* END - SOURCE TO MEMORY */
 
-			case INSTRUCTION_WITH_LABEL_NO_OPERANDS:  /* Result from line_parser: a line that contains an operation and a label */
-			{
-				symb_controller(ptr -> label, IC, code, &(ptr -> err));
-             
-				/* START - OPERATION TO MEMORY */
-				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, no_ops, ABSOLUTE, NO_OPERAND);
-				/* END - OPERATION TO MEMORY */
-
-				IC++;
+			IC++;
 
-				break;
+			/* START - DESTINATION TO MEMORY */
+			if(ptr -> dest_adr == immediate) {
+				strcpy(ptr -> num_to_mem, ptr -> destination);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
 			}
+			else if(ptr -> dest_adr == direct) {
+				strcpy(ptr -> lbl_to_mem, ptr -> destination);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, DESTINATION_OP);
+			}
+			else if(ptr -> dest_adr == regis_direct) {
+				strcpy(ptr -> num_to_mem, regis_to_num(ptr -> destination));
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
+			}
+			/* END - DESTINATION TO MEMORY */
 
-			case INSTRUCTION_WITHOUT_LABEL_2_OPERANDS:  /* Result from line_parser: a line that contains an operation and 2 operands */
-			{
-				/* START - OPERATION TO MEMORY */
-				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_bits, ABSOLUTE, NO_OPERAND);
-				/* END - OPERATION TO MEMORY */
-
-				IC++;
+			IC++;
 
-				/* START - SOURCE TO MEMORY */
-				if(ptr -> src_adr == immediate) {
-					strcpy(ptr -> num_to_mem, ptr -> source);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, SOURCE_OP);
-				}
-				else if(ptr -> src_adr == direct) {
-					strcpy(ptr -> lbl_to_mem, ptr -> source);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, SOURCE_OP);
-				}
-				else if(ptr -> src_adr == regis_direct) {
-					strcpy(ptr -> num_to_mem, regis_to_num(ptr -> source));
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, SOURCE_OP);
-				}
-				/* END - SOURCE TO MEMORY */
+			break;
+		}
 
-				IC++;
+		case INSTRUCTION_WITH_LABEL_1_OPERAND:  /* Result from line_parser: a line that contains an operation, a label and 1 operand */
+		{
+			symb_controller(ptr -> label, IC, code, &(ptr -> err));
+               
+			ptr -> src_adr = 0;
 
-				/* START - DESTINATION TO MEMORY */
-				if(ptr -> dest_adr == immediate) {
-					strcpy(ptr -> num_to_mem, ptr -> destination);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
-				}
-				else if(ptr -> dest_adr == direct) {
-					strcpy(ptr -> lbl_to_mem, ptr -> destination);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, DESTINATION_OP);
-				}
-				else if(ptr -> dest_adr == regis_direct) {
-					strcpy(ptr -> num_to_mem, regis_to_num(ptr -> destination));
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
-				}
-				/* END - DESTINATION TO MEMORY */
+			/* START - OPERATION TO MEMORY */
+			insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_bits, ABSOLUTE, NO_OPERAND);
+			/* END - OPERATION TO MEMORY */
 
-				IC++;
+			IC++;
 
-				break;
+			/* START - DESTINATION TO MEMORY */
+			if(ptr -> dest_adr == immediate) {
+				strcpy(ptr -> num_to_mem, ptr -> destination);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
 			}
+			else if(ptr -> dest_adr == direct) {
+				strcpy(ptr -> lbl_to_mem, ptr -> destination);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, DESTINATION_OP);
+			}
+			else if(ptr -> dest_adr == regis_direct) {
+				strcpy(ptr -> num_to_mem, regis_to_num(ptr -> destination));
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
+			}
+			else if(ptr -> dest_adr == relative) {
+				strcpy(ptr -> lbl_to_mem, ptr -> destination);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, relative_operand, ABSOLUTE, DESTINATION_OP);
+			}
+			/* END - DESTINATION TO MEMORY */
 
-			case INSTRUCTION_WITHOUT_LABEL_1_OPERAND:  /* Result from line_parser: a line that contains an operation and 1 operand */
-			{
-				ptr -> src_adr = 0;
-
-				/* START - OPERATION TO MEMORY */
-				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_bits, ABSOLUTE, NO_OPERAND);
-				/* END - OPERATION TO MEMORY */
+			IC++;
 
-				IC++;
+			break;
+		}
 
-				/* START - DESTINATION TO MEMORY */
-				if(ptr -> dest_adr == immediate) {
-					strcpy(ptr -> num_to_mem, ptr -> destination);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
-				}
-				else if(ptr -> dest_adr == direct) {
-					strcpy(ptr -> lbl_to_mem, ptr -> destination);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, DESTINATION_OP);
-				}
-				else if(ptr -> dest_adr == regis_direct) {
-					strcpy(ptr -> num_to_mem, regis_to_num(ptr -> destination));
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
-				}
-				else if(ptr -> dest_adr == relative) {
-					strcpy(ptr -> lbl_to_mem, ptr -> destination);
-					insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, relative_operand, ABSOLUTE, DESTINATION_OP);
-				}
-				/* END - DESTINATION TO MEMORY */
+		case INSTRUCTION_WITH_LABEL_NO_OPERANDS:  /* Result from line_parser: a line that contains an operation and a label */
+		{
+			symb_controller(ptr -> label, IC, code, &(ptr -> err));
+            
+			/* START - OPERATION TO MEMORY */
+			insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, no_ops, ABSOLUTE, NO_OPERAND);
+			/* END - OPERATION TO MEMORY */
 
-				IC++;
+			IC++;
 
-				break;
-			}
+			break;
+		}
 
-			case INSTRUCTION_WITHOUT_LABEL_NO_OPERANDS:  /* Result from line_parser: a line that contains only an operation */
-			{
-				/* START - OPERATION TO MEMORY */
-				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, no_ops, ABSOLUTE, NO_OPERAND);
-				/* END - OPERATION TO MEMORY */
+		case INSTRUCTION_WITHOUT_LABEL_2_OPERANDS:  /* Result from line_parser: a line that contains an operation and 2 operands */
+		{
+			/* START - OPERATION TO MEMORY */
+			insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_bits, ABSOLUTE, NO_OPERAND);
+			/* END - OPERATION TO MEMORY */
 
-				IC++;
+			IC++;
 
-				break;
+			/* START - SOURCE TO MEMORY */
+			if(ptr -> src_adr == immediate) {
+				strcpy(ptr -> num_to_mem, ptr -> source);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, SOURCE_OP);
 			}
-
-			case INVALID_LINE:  /* Result from line_parser: error was found during parsing */
-			{
-				error_controller(curr_line, ptr -> err, file_name);  /* add error */
-				break;
+			else if(ptr -> src_adr == direct) {
+				strcpy(ptr -> lbl_to_mem, ptr -> source);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, SOURCE_OP);
+			}
+			else if(ptr -> src_adr == regis_direct) {
+				strcpy(ptr -> num_to_mem, regis_to_num(ptr -> source));
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, SOURCE_OP);
 			}
+			/* END - SOURCE TO MEMORY */
 
-			case UNDEFINED_LINE:	/* something went wrong if reached here */
-			{
-				error_controller(curr_line, UNKNOWN_LINE, file_name);
-				break;
+			IC++;
+
+			/* START - DESTINATION TO MEMORY */
+			if(ptr -> dest_adr == immediate) {
+				strcpy(ptr -> num_to_mem, ptr -> destination);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
+			}
+			else if(ptr -> dest_adr == direct) {
+				strcpy(ptr -> lbl_to_mem, ptr -> destination);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, DESTINATION_OP);
+			}
+			else if(ptr -> dest_adr == regis_direct) {
+				strcpy(ptr -> num_to_mem, regis_to_num(ptr -> destination));
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
 			}
+			/* END - DESTINATION TO MEMORY */
+
+			IC++;
+
+			break;
 		}
 
-		curr_line++;
-	}
+		case INSTRUCTION_WITHOUT_LABEL_1_OPERAND:  /* Result from line_parser: a line that contains an operation and 1 operand */
+		{
+			ptr -> src_adr = 0;
 
+			/* START - OPERATION TO MEMORY */
+			insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_bits, ABSOLUTE, NO_OPERAND);
+			/* END - OPERATION TO MEMORY */
 
-	/* update all DC values according to updated IC */	
-	update_DC(head_mdl_ptr, IC);
-	update_symb_table(IC);
+			IC++;
 
-	/* check if all entry labels were defined correctly */
-	check_entry_labels();
+			/* START - DESTINATION TO MEMORY */
+			if(ptr -> dest_adr == immediate) {
+				strcpy(ptr -> num_to_mem, ptr -> destination);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
+			}
+			else if(ptr -> dest_adr == direct) {
+				strcpy(ptr -> lbl_to_mem, ptr -> destination);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, direct_operand, RELOCATABLE, DESTINATION_OP);
+			}
+			else if(ptr -> dest_adr == regis_direct) {
+				strcpy(ptr -> num_to_mem, regis_to_num(ptr -> destination));
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, line_type_number, ABSOLUTE, DESTINATION_OP);
+			}
+			else if(ptr -> dest_adr == relative) {
+				strcpy(ptr -> lbl_to_mem, ptr -> destination);
+				insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, relative_operand, ABSOLUTE, DESTINATION_OP);
+			}
+			/* END - DESTINATION TO MEMORY */
 
-	/* verify that all labels that were used as operands were defined correctly */
-	second_pass_label_check(head_mcl_ptr, file_name);
+			IC++;
 
-	/* final check if no errors occurred before creating files */
-	if(!were_errors()) {
-		create_image_hexa_file(head_mcl_ptr, head_mdl_ptr, file_name, (IC-100), DC);
-		create_ent_file(file_name);	/* a check if entry labels appeared is made inside this funtion */
-		if(was_extern_label_as_operand(head_mcl_ptr)) {	/* make sure extern label/s appeared before creating externals file */
-			create_extern_file(head_mcl_ptr, file_name);
+			break;
 		}
-	}
 
-	/* frees */
-	free_code_image_nodes(&head_mcl_ptr);
-	head_mcl_ptr = NULL;
-	free_data_image_nodes(&head_mdl_ptr);
-	head_mdl_ptr = NULL;
-	free(ptr);	/* free line_details struct */
-	ptr = NULL;
+		case INSTRUCTION_WITHOUT_LABEL_NO_OPERANDS:  /* Result from line_parser: a line that contains only an operation */
+		{
+			/* START - OPERATION TO MEMORY */
+			insert_memory_code_line(&head_mcl_ptr, &curr_mcl_ptr, IC, no_ops, ABSOLUTE, NO_OPERAND);
+			/* END - OPERATION TO MEMORY */
 
-	if(!were_errors()) {
-		return 1;
-	}
-	else return 0;
-}
+			IC++;
 
+			break;
+		}
 
-/**
- * find_next_line function finds where the new line starts at.
- *
- * @param fp - the pointer to the pointer which points to the file.
- */
-void find_next_line(FILE** fp)
-{
-	char ch;
+		case INCLUDE:  /* Result from line_parser: an include line */
+		{
+			include_processor(ptr -> payload, file_name);
+			break;
+		}
+
+		case INVALID_LINE:  /* Result from line_parser: error was found during parsing */
+		{
+			error_controller(curr_line, ptr -> err, file_name);  /* add error */
+			break;
+		}
 
-	while(1) {  /* Find the new line (or EOF) */
-		ch = fgetc(*fp);
-		if(ch == EOF || ch == '\n')
+		case UNDEFINED_LINE:	/* something went wrong if reached here */
+		{
+			error_controller(curr_line, UNKNOWN_LINE, file_name);
 			break;
+		}
 	}
 }
 
 
 /**
- * is_long_line function checks whether the line is too long. (MAX_LINE_LENGTH defined at 'line.details.h' and is equal to 81)
+ * include_processor function processes the lines of an included file, taken from the include cache (see 'include_cache.c'), as if they
+ * were written in place of the '.include' line. Errors in the included lines are reported at the line of the '.include'.
  *
- * @param fp - a pointer to the pointer which points to the file.
- * @return - 1 if line is too long, otherwise 0 is returned.
+ * @param path - the name of the included file.
+ * @param file_name - the name of the currently processed file.
  */
-int is_long_line(int line_len, int white_spaces_quantt)
+void include_processor(const char* path, const char* file_name)
 {
-	return (line_len - white_spaces_quantt > MAX_LINE_LENGTH) ? 1 : 0;
+	inc_ptr f;
+	pl_ptr p;
+	char* full_path;
+	const char* including_file;
+
+	if(include_depth == MAX_INCLUDE_DEPTH) {
+		error_controller(curr_line, INCLUDE_NESTED_TOO_DEEP, file_name);  /* add error */
+		return;
+	}
+
+	full_path = resolve_path(path);
+	f = get_include_file(full_path);
+	if(f == NULL) {
+		free(full_path);
+		error_controller(curr_line, INCLUDE_FILE_NOT_FOUND, file_name);  /* add error */
+		return;
+	}
+	add_dependency(full_path);
+
+	including_file = lines_file;
+	lines_file = full_path;	/* the names of files in the included lines are relative to the included file */
+	include_depth++;
+	for(p = f -> lines_head; p != NULL; p = p -> next)
+	{
+		*ptr = p -> ld;	/* the stored line details, like line_parser function has just filled them */
+		line_processor(p -> type, file_name);
+	}
+	include_depth--;
+	lines_file = including_file;
+	free(full_path);
 }
 
 
 /**
- * is_line_ending_with_newline_char function checks whether the line is ending with a newline char.
+ * resolve_path function returns the path of a file named in a line, relative to the directory of the file the line comes from.
  *
- * @param line - a pointer to the start of the line.
- * @param line_len - the length of the line.
- * @return - 1 if line is ending with newline char, otherwise 0 is returned.
+ * @param path - the name of the file, as it appeared in the line.
+ * @return - the path of the file (must be freed).
  */
-int is_line_ending_with_newline_char(char* line, int line_len)
+char* resolve_path(const char* path)
 {
-	return line[line_len-1] == '\n' ? 1 : 0;
+	const char* slash;
+	char* full_path;
+	int dir_len;
+
+	slash = strrchr(lines_file, '/');
+	dir_len = (path[0] == '/' || slash == NULL) ? 0 : slash - lines_file + 1;	/* absolute paths and files in the current directory are kept */
+
+	full_path = malloc(dir_len + strlen(path) + 1);
+
+	/* verify if malloc worked as expected */
+	if(full_path == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	strncpy(full_path, lines_file, dir_len);
+	strcpy(full_path + dir_len, path);
+
+	return full_path;
 }
 
 
@@ -548,49 +721,37 @@ void update_DC(mdl_ptr node, int IC)
 /**
  * second_pass_label_check function checks whether all label used as operands were correctly defined.
  * The function does not return anything but if it finds any errors, it triggers an error edition which is checked later in the code to determine
- * next actions.
+ * next actions. Every direct operand that was resolved is added to the relocation table (it's a relocatable or external word).
+ * The labels are resolved by resolve_operands function (in 'main.c'), the errors are added here.
  *
  * @param node - a pointer to the head of the list of code memory image.
  * @param fn - the name of the file currently being checked.
  */
 void second_pass_label_check(mcl_ptr node, const char* fn)
 {
-	int res;
+	mcl_ptr* operands;
+	ERR_VALUE* errors;
+	long operands_num;
+	long i;
 
-	while(node != NULL)
+	operands_num = resolve_operands(node, &operands, &errors);	/* the operands are resolved on a pool of threads */
+
+	/* the errors and relocations are added in the order of the code image, like if the operands were resolved one by one */
+	for(i = 0; i < operands_num; i++)
 	{
-		if(node -> mlt == direct_operand) /* check if all labels used as direct operands were defined correctly */
-		{
-			res = symb_check(node -> l -> lbl);
-			if(res != -1) {
-				sprintf(node -> mem_val, "%d", res);
-				if(is_extern_lbl(node -> l -> lbl)) {
-					node -> memory_type = EXTERNAL;
-				}
-			}
-			else {
-				curr_line = node -> l -> lbl_line; /* update the line in which the label is in the original input file */
-				if(node -> l -> op_type == SOURCE_OP) {
-					error_controller(curr_line, UNDEFINED_LABEL_IN_SOURCE_OPERAND, fn);  /* add error */
-				}
-				else if(node -> l -> op_type == DESTINATION_OP) {
-					error_controller(curr_line, UNDEFINED_LABEL_IN_DESTINATION_OPERAND, fn);  /* add error */
-				}
+		if(errors[i] == NO_ERRORS) {
+			if(operands[i] -> mlt == direct_operand) {
+				insert_relocation(&head_rel_ptr, &curr_rel_ptr, operands[i] -> IC, operands[i] -> memory_type);
 			}
 		}
-		else if(node -> mlt == relative_operand) /* check if all labels used as relative operands were defined correctly */
-		{
-			res = symb_check(node -> l -> lbl);
-			if(res != -1) {
-				sprintf(node -> mem_val, "%d", (res - (node -> IC)));
-			}
-			else {
-				curr_line = node -> l -> lbl_line; /* update the line in which the label is in the original input file */
-				error_controller(curr_line, UNDEFINED_LABEL_IN_DESTINATION_OPERAND, fn);  /* add error */
-			}
+		else {
+			curr_line = operands[i] -> l -> lbl_line; /* update the line in which the label is in the original input file */
+			error_controller(curr_line, errors[i], fn);  /* add error */
 		}
-		node = node -> next;
 	}
+
+	free(operands);
+	free(errors);
 }
 
 
@@ -615,8 +776,13 @@ void handler_free_mem()
 	head_mcl_ptr = NULL;
 	free_data_image_nodes(&head_mdl_ptr);
 	head_mdl_ptr = NULL;
+	free_relocation_nodes(&head_rel_ptr);
+	head_rel_ptr = NULL;
 	if(ptr != NULL) {
 		free(ptr);	/* free line_details struct */
 	}
 	ptr = NULL;
+	end_preprocessor();
+	free_tokens_buffer();
+	free_dependencies();
 }
@@ -1,6 +1,5 @@
 #ifndef HANDLER_H
 #define HANDLER_H
-#define MAX_BUFFER_LENGTH 128
 #define ABSOLUTE 'A'
 #define RELOCATABLE 'R'
 #define EXTERNAL 'E'
@@ -14,6 +13,10 @@
 #include "main_functions.h"
 #include "handler_functions_for_memory.h"
 #include "memory_image.h"
+#include "preprocessor.h"
+#include "include_cache.h"
+#include "dependency.h"
+#include "pipeline.h"
 
 
 /**
@@ -29,30 +32,45 @@ int file_processor(FILE** fp, const char* fn);
 
 
 /**
- * find_next_line function finds where the new line starts at.
+ * pipeline_processor function is the encoder stage of the pipeline (PIPELINE_OPTION): it processes the lines the pipeline read and parsed
+ * (see start_pipeline function in 'pipeline.h'), in order, with line_processor function. The errors the preprocessor found are added before
+ * the line they were found with, so the errors, the symbol table and the memory image are the same as the serial loop creates.
  *
- * @param fp - the pointer to the pointer which points to the file.
+ * @param file_name - the name of the currently processed file.
  */
-void find_next_line(FILE** fp);
+void pipeline_processor(const char* file_name);
 
 
 /**
- * is_long_line function checks whether the line is too long. (MAX_LINE_LENGTH defined at 'line.details.h' and is equal to 81)
+ * line_processor function processes a parsed line according to its type: it triggers the creation of the symbol, memory image and error nodes
+ * of the line. All relevant information of the line is taken from the line_details struct that line_parser function filled.
  *
- * @param fp - a pointer to the pointer which points to the file.
- * @return - 1 if line is too long, otherwise 0 is returned.
+ * @param type - the type of the line, the result of line_parser function (see LINE_TYPE enum in 'line_details.h').
+ * @param file_name - the name of the currently processed file.
  */
-int is_long_line(int line_len, int white_spaces_quantt);
+void line_processor(LINE_TYPE type, const char* file_name);
 
 
 /**
- * is_line_ending_with_newline_char function checks whether the line is ending with a newline char.
+ * include_processor function processes the lines of an included file as if they were written in place of the '.include' line.
+ * The lines are taken from the include cache (see 'include_cache.h'), so every file is read and parsed once per program execution.
+ * Errors in the included lines are reported at the line of the '.include'. Macros are not expanded in included files.
+ * The name of the file is relative to the directory of the file of the '.include' line (see resolve_path function).
  *
- * @param line - a pointer to the start of the line.
- * @param line_len - the length of the line.
- * @return - 1 if line is ending with newline char, otherwise 0 is returned.
+ * @param path - the name of the included file.
+ * @param file_name - the name of the currently processed file.
  */
-int is_line_ending_with_newline_char(char* line, int line_len);
+void include_processor(const char* path, const char* file_name);
+
+
+/**
+ * resolve_path function returns the path of a file named in an '.include' or '.incbin' line: a relative name is relative to the directory of
+ * the file the line comes from (the source file, or the included file for lines of an included file), not to the current directory.
+ *
+ * @param path - the name of the file, as it appeared in the line.
+ * @return - the path of the file (must be freed).
+ */
+char* resolve_path(const char* path);
 
 
 /**
@@ -82,7 +100,9 @@ void update_DC(mdl_ptr node, int IC);
 /**
  * second_pass_label_check function checks whether all label used as operands were correctly defined.
  * The function does not return anything but if it finds any error, it triggers an error edition which is checked later in the code to determine
- * next actions.
+ * next actions. Every direct operand that was resolved is added to the relocation table (see create_relocation_file function in 'memory_image.h').
+ * The operands are resolved on a pool of threads (see resolve_label_operands function in 'label_resolver.h'), then the errors are added and
+ * the relocations are inserted in the order of the code image, so the messages and tables are the same as if they were resolved one by one.
  *
  * @param node - a pointer to the head of the list of code memory image.
  * @param fn - the name of the file currently being checked.
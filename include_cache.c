@@ -0,0 +1,195 @@
+/**
+ * This file contains all functions related to the include cache of the 'assembler'. Files named in '.include' lines are read and parsed once,
+ * and their parsed lines are kept until the program ends, so a file that is included many times (by one or by many source files) costs
+ * one read and one parse. 'handler.c' processes the stored lines exactly like lines it has just parsed.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _XOPEN_SOURCE 700	/* for realpath function */
+#include "include_cache.h"
+#include "emergency_free_mem.h"
+
+static inc_ptr head_inc = NULL;	/* the head of the include cache */
+
+
+/**
+ * get_include_file function returns the parsed lines of a file named in an '.include' line, the file is read and parsed only the first time.
+ *
+ * @param path - the name of the file, as it appeared in the '.include' line.
+ * @return - a pointer to the file in the include cache, or NULL if the file could not be opened.
+ */
+inc_ptr get_include_file(const char* path)
+{
+	char* canonical;
+	inc_ptr f;
+	FILE* fp;
+	char* buffer;
+	int buffer_size;
+	char* line;
+	line_details ld;
+	LINE_TYPE type;
+
+	canonical = realpath(path, NULL);
+	if(canonical == NULL) {
+		return NULL;
+	}
+
+	for(f = head_inc; f != NULL; f = f -> next) {
+		if(strcmp(f -> path, canonical) == 0) {
+			free(canonical);
+			return f;
+		}
+	}
+
+	fp = fopen(canonical, "r");
+	if(fp == NULL) {
+		free(canonical);
+		return NULL;
+	}
+
+	f = malloc(sizeof(include_file));
+
+	/* verify if malloc worked as expected */
+	if(f == NULL)
+	{
+		free(canonical);
+		fclose(fp);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	f -> path = canonical;
+	f -> lines_head = NULL;
+	f -> lines_curr = NULL;
+	f -> next = head_inc;
+	head_inc = f;	/* added before it's parsed, so an allocation failure while parsing frees it */
+
+	buffer = NULL;
+	buffer_size = 0;
+
+	while((line = read_long_line(fp, &buffer, &buffer_size)) != NULL)
+	{
+		ld.err = NO_ERRORS;
+		ld.src_adr = no_type;
+		ld.dest_adr = no_type;
+
+		if(!is_extended_mode() && is_long_line(strlen(line), count_whitespaces(line))) {	/* no line length limit in extended mode */
+			type = INVALID_LINE;
+			ld.err = LONG_LINE;
+		}
+		else type = line_parser(line, &ld);
+
+		if(type != EMPTY && type != COMMENT) {
+			add_parsed_line(f, type, &ld);
+		}
+	}
+
+	free(buffer);
+	fclose(fp);
+
+	return f;
+}
+
+
+/**
+ * add_parsed_line function adds a copy of a parsed line to the end of the lines of a file in the include cache.
+ *
+ * @param f - a pointer to the file in the include cache.
+ * @param type - the result of line_parser function.
+ * @param ld - a pointer to the line details line_parser function filled.
+ */
+void add_parsed_line(inc_ptr f, LINE_TYPE type, line_details* ld)
+{
+	pl_ptr p;
+
+	p = malloc(sizeof(parsed_line));
+
+	/* verify if malloc worked as expected */
+	if(p == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	p -> type = type;
+	p -> ld = *ld;
+	p -> payload = NULL;
+	p -> next = NULL;
+
+	if(has_payload(type)) {	/* the payload points into the line buffer, which is reused for the next line */
+		p -> payload = malloc(strlen(ld -> payload) + 1);
+
+		/* verify if malloc worked as expected */
+		if(p -> payload == NULL)
+		{
+			free(p);
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+		strcpy(p -> payload, ld -> payload);
+	}
+	p -> ld.payload = p -> payload;
+
+	if(f -> lines_head == NULL) {
+		f -> lines_head = p;
+	}
+	else f -> lines_curr -> next = p;
+	f -> lines_curr = p;
+}
+
+
+/**
+ * has_payload function checks whether line_details.payload is set for a line type.
+ *
+ * @param type - the type of the line.
+ * @return - 1 if the line type has a payload, otherwise 0 is returned.
+ */
+int has_payload(LINE_TYPE type)
+{
+	switch(type) {
+		case GUIDANCE_DATA_WITH_LABEL:
+		case GUIDANCE_DATA_WITHOUT_LABEL:
+		case GUIDANCE_STRING_WITH_LABEL:
+		case GUIDANCE_STRING_WITHOUT_LABEL:
+		case GUIDANCE_INCBIN_WITH_LABEL:
+		case GUIDANCE_INCBIN_WITHOUT_LABEL:
+		case INCLUDE:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+
+/**
+ * free_include_cache function frees all files in the include cache.
+ */
+void free_include_cache()
+{
+	inc_ptr f;
+	pl_ptr p;
+
+	while(head_inc != NULL)
+	{
+		f = head_inc;
+		head_inc = f -> next;
+
+		while(f -> lines_head != NULL)
+		{
+			p = f -> lines_head;
+			f -> lines_head = p -> next;
+			if(p -> payload != NULL) {
+				free(p -> payload);
+			}
+			free(p);
+		}
+
+		free(f -> path);
+		free(f);
+	}
+}
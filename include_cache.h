@@ -0,0 +1,75 @@
+#ifndef INCLUDE_CACHE_H
+#define INCLUDE_CACHE_H
+#define MAX_INCLUDE_DEPTH 16	/* deeper nesting means an include cycle */
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "line_details.h"
+#include "parser.h"	/* for line_parser function */
+#include "preprocessor.h"	/* for read_long_line and is_long_line functions */
+#include "main_functions.h"
+
+
+/* a pointer to struct parsed_line */
+typedef struct parsed_line* pl_ptr;
+
+/* a struct that represents a line of an included file, as line_parser function parsed it (list) */
+typedef struct parsed_line {
+	LINE_TYPE type;	/* the result of line_parser function */
+	line_details ld;	/* the line details line_parser function filled, ld.payload points to 'payload' */
+	char* payload;	/* a copy of the payload of the line (NULL if the line type has no payload) */
+	pl_ptr next;
+} parsed_line;
+
+
+/* a pointer to struct include_file */
+typedef struct include_file* inc_ptr;
+
+/* a struct that represents a file in the include cache (list). A file is read and parsed once, no matter how many times it's included */
+typedef struct include_file {
+	char* path;	/* the canonical path of the file */
+	pl_ptr lines_head;	/* the first parsed line of the file */
+	pl_ptr lines_curr;	/* the last parsed line of the file */
+	inc_ptr next;
+} include_file;
+
+
+/**
+ * get_include_file function returns the parsed lines of a file named in an '.include' line. The first time a file is requested, it's read and
+ * every line is parsed (line_parser function) and stored in the include cache; later requests (from the same or from other source files)
+ * get the stored lines. Files are identified by their canonical path, so different names of the same file share one cache entry.
+ * Empty and comment lines are not stored. Lines that are too long (standard mode) are stored as invalid lines with LONG_LINE error.
+ *
+ * @param path - the name of the file, as it appeared in the '.include' line.
+ * @return - a pointer to the file in the include cache, or NULL if the file could not be opened.
+ */
+inc_ptr get_include_file(const char* path);
+
+
+/**
+ * add_parsed_line function adds a copy of a parsed line to the end of the lines of a file in the include cache.
+ *
+ * @param f - a pointer to the file in the include cache.
+ * @param type - the result of line_parser function.
+ * @param ld - a pointer to the line details line_parser function filled.
+ */
+void add_parsed_line(inc_ptr f, LINE_TYPE type, line_details* ld);
+
+
+/**
+ * has_payload function checks whether line_details.payload is set for a line type.
+ *
+ * @param type - the type of the line.
+ * @return - 1 if the line type has a payload, otherwise 0 is returned.
+ */
+int has_payload(LINE_TYPE type);
+
+
+/**
+ * free_include_cache function frees all files in the include cache.
+ * This function must be called after the last source file was processed.
+ */
+void free_include_cache();
+
+
+#endif
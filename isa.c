@@ -0,0 +1,287 @@
+/**
+ * This file contains the description of the instruction set and all functions related to encoding and decoding its words, shared by the
+ * 'assembler', the 'simulator', the 'tracedump' and the 'disassembler'.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "isa.h"
+
+
+/* Array of all operations, indexed by ops enum */
+static const isa_operation operations[] = {
+
+	{mov, "mov", 0, 0, 2},
+	{cmp, "cmp", 1, 0, 2},
+	{add, "add", 2, 10, 2},
+	{sub, "sub", 2, 11, 2},
+	{lea, "lea", 4, 0, 2},
+	{clr, "clr", 5, 10, 1},
+	{not, "not", 5, 11, 1},
+	{inc, "inc", 5, 12, 1},
+	{dec, "dec", 5, 13, 1},
+	{jmp, "jmp", 9, 10, 1},
+	{bne, "bne", 9, 11, 1},
+	{jsr, "jsr", 9, 12, 1},
+	{red, "red", 12, 0, 1},
+	{prn, "prn", 13, 0, 1},
+	{rts, "rts", 14, 0, 0},
+	{stop, "stop", 15, 0, 0}
+
+};
+
+
+/* Array of the operations of every opcode, indexed by the opcode */
+static const isa_opcode opcodes[OPCODES_NUM] = {
+
+	{mov, 0, 1},
+	{cmp, 0, 1},
+	{add, 10, 2},
+	{no_op, 0, 0},
+	{lea, 0, 1},
+	{clr, 10, 4},
+	{no_op, 0, 0},
+	{no_op, 0, 0},
+	{no_op, 0, 0},
+	{jmp, 10, 3},
+	{no_op, 0, 0},
+	{no_op, 0, 0},
+	{red, 0, 1},
+	{prn, 0, 1},
+	{rts, 0, 1},
+	{stop, 0, 1}
+
+};
+
+
+/**
+ * isa_operation_of function returns the description of an operation.
+ *
+ * @param op - the operation.
+ * @return - a pointer to the description.
+ */
+const isa_operation* isa_operation_of(ops op)
+{
+	return &(operations[op]);
+}
+
+
+/**
+ * isa_find_mnemonic function returns the operation of a mnemonic.
+ *
+ * @param str - the mnemonic.
+ * @return - the operation, or no_op if 'str' is not a mnemonic.
+ */
+ops isa_find_mnemonic(const char* str)
+{
+	int i;
+
+	for(i = 0; i < (int) (sizeof(operations) / sizeof(operations[0])); i++) {
+		if(strcmp(str, operations[i].mnemonic) == 0) {
+			return operations[i].op;
+		}
+	}
+
+	return no_op;
+}
+
+
+/**
+ * isa_decode function returns the operation of the first word of an instruction.
+ *
+ * @param word - the word.
+ * @return - the operation, or no_op if the word is not an operation.
+ */
+ops isa_decode(int word)
+{
+	const isa_opcode* oc;
+	int ind;
+
+	oc = &(opcodes[(word >> 8) & (OPCODES_NUM - 1)]);
+	ind = ((word >> 4) & 0xF) - oc -> first_funct;
+
+	if(word < 0 || word > ISA_WORD_MASK || ind < 0 || ind >= oc -> functs_num) {
+		return no_op;
+	}
+
+	return (ops) (oc -> first + ind);
+}
+
+
+/**
+ * isa_decode_operand function decodes an operand word.
+ *
+ * @param mode - the addressing type of the operand.
+ * @param word - the operand word.
+ * @param addr - the address of the operand word.
+ * @param res - an address of an integer where to store the decoded operand.
+ * @return - 1 if the operand is valid, otherwise 0 is returned.
+ */
+int isa_decode_operand(addressing_type mode, int word, int addr, int* res)
+{
+	int r;
+
+	switch(mode)
+	{
+		case immediate:
+			*res = to_signed(word);
+			return 1;
+
+		case direct:
+			*res = word;
+			return 1;
+
+		case relative:
+			*res = addr + to_signed(word);
+			return 1;
+
+		case regis_direct:	/* the word has one bit set, the bit of the register */
+			for(r = 0; r < ISA_REGISTERS_NUM && word != (1 << r); r++);
+			*res = r;
+			return r < ISA_REGISTERS_NUM;
+
+		default:
+			return 0;
+	}
+}
+
+
+/**
+ * isa_binary function writes the low bits of a value as a string of '0' and '1' chars.
+ *
+ * @param val - the value.
+ * @param bits - the number of bits.
+ * @param str - a string where to store the bits.
+ */
+void isa_binary(int val, int bits, char* str)
+{
+	int i;
+
+	for(i = 0; i < bits; i++) {
+		str[i] = ((val >> (bits - 1 - i)) & 1) ? '1' : '0';
+	}
+	str[bits] = '\0';
+}
+
+
+/**
+ * operands_num function returns the number of operands of an operation.
+ *
+ * @param op - the operation.
+ * @return - the number of operands (0, 1 or 2).
+ */
+int operands_num(ops op)
+{
+	return operations[op].operands;
+}
+
+
+/**
+ * to_signed function converts a 12 bits word to a signed integer.
+ *
+ * @param word - the word.
+ * @return - the signed value.
+ */
+int to_signed(int word)
+{
+	return (word & ISA_SIGN_BIT) ? (word & ISA_WORD_MASK) - (ISA_WORD_MASK + 1) : (word & ISA_WORD_MASK);
+}
+
+
+/**
+ * disassemble function writes the instruction that starts at a word of an image as assembly.
+ *
+ * @param img - a pointer to the image.
+ * @param ind - the index of the word in the image.
+ * @param text - a string where to store the instruction.
+ * @return - the number of words written.
+ */
+int disassemble(const isa_image* img, int ind, char* text)
+{
+	addressing_type modes[2];
+	int operands[2];
+	int word;
+	int num;
+	int i;
+	ops op;
+
+	word = img -> words[ind];
+	op = ind < img -> code_num ? isa_decode(word) : no_op;
+	num = op != no_op ? operations[op].operands : 0;
+
+	/* the source operand is the first operand word of a 2 operands instruction, the destination operand is the last one */
+	modes[0] = (addressing_type) (num == 2 ? (word >> 2) & 3 : word & 3);
+	modes[1] = (addressing_type) (word & 3);
+	if(op != no_op && ind + 1 + num > img -> code_num) {
+		op = no_op;
+	}
+	for(i = 0; op != no_op && i < num; i++) {
+		if(!isa_decode_operand(modes[i], img -> words[ind + 1 + i], img -> first_addr + ind + 1 + i, &(operands[i]))) {
+			op = no_op;
+		}
+	}
+
+	if(op == no_op) {
+		sprintf(text, ".data %d", to_signed(word));	/* not an instruction */
+		return 1;
+	}
+
+	strcpy(text, operations[op].mnemonic);
+	for(i = 0; i < num; i++) {
+		strcat(text, i == 0 ? " " : ", ");
+		disassemble_operand(img, ind + 1 + i, modes[i], operands[i], text + strlen(text));
+	}
+
+	return 1 + num;
+}
+
+
+/**
+ * disassemble_operand function writes a decoded operand as assembly.
+ *
+ * @param img - a pointer to the image.
+ * @param ind - the index of the operand word in the image.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand.
+ * @param text - a string where to store the operand.
+ */
+void disassemble_operand(const isa_image* img, int ind, addressing_type mode, int operand, char* text)
+{
+	const char* name;
+
+	name = NULL;
+	if(mode == direct || mode == relative) {
+		if(img -> refs != NULL && img -> refs[ind] != NULL) {
+			name = img -> refs[ind];
+		}
+		else if(img -> labels != NULL && operand >= img -> first_addr && operand < img -> first_addr + img -> words_num) {
+			name = img -> labels[operand - img -> first_addr];
+		}
+	}
+
+	switch(mode)
+	{
+		case immediate:
+			sprintf(text, "#%d", operand);
+			break;
+
+		case direct:
+			if(name != NULL) {
+				strcpy(text, name);
+			}
+			else sprintf(text, "%04d", operand);
+			break;
+
+		case relative:
+			if(name != NULL) {
+				sprintf(text, "%%%s", name);
+			}
+			else sprintf(text, "%%%04d", operand);
+			break;
+
+		default:
+			sprintf(text, "r%d", operand);
+			break;
+	}
+}
@@ -0,0 +1,148 @@
+#ifndef ISA_H
+#define ISA_H
+#include <stdio.h>
+#include <string.h>
+#include "line_details.h"	/* for ops and addressing_type enums */
+#define OPCODES_NUM 16	/* the opcode is 4 bits */
+#define ISA_WORD_MASK 0xFFF	/* a word is 12 bits */
+#define ISA_SIGN_BIT 0x800
+#define ISA_REGISTERS_NUM 8
+#define MEMORY_SIZE 4096	/* addresses are 12 bits */
+#define FIRST_ADDRESS 100	/* the address of the first word of every program (and of every object module) */
+#define DISASSEMBLY_TEXT_LENGTH (MAX_LINE_LENGTH + 2 * MAX_OPERAND_AND_LABEL_LENGTH)	/* the size of the text of an instruction, see disassemble */
+
+
+/*
+ * The description of the instruction set, shared by the 'assembler' (encoding), the 'simulator' (decoding) and the 'disassembler'.
+ * The first word of an instruction is:
+ *   bits 11-8 opcode, bits 7-4 funct, bits 3-2 source addressing type, bits 1-0 destination addressing type
+ * and every operand has one more word:
+ *   immediate - the value, direct - the address, relative - the distance from the operand word to the address, register - the bit of the
+ *   register (1 << r)
+ */
+
+
+/* a struct that represents an operation of the instruction set */
+typedef struct isa_operation {
+	ops op;
+	const char* mnemonic;
+	int opcode;
+	int funct;
+	int operands;	/* the number of operands (0, 1 or 2) */
+} isa_operation;
+
+
+/* a struct that represents the operations of one opcode, so a word is decoded with one lookup: the operations of an opcode are consecutive
+ * in ops enum, and so are their funct values */
+typedef struct isa_opcode {
+	ops first;	/* the first operation of the opcode, no_op if the opcode is not used */
+	int first_funct;	/* the funct of the first operation */
+	int functs_num;	/* the number of operations of the opcode */
+} isa_opcode;
+
+
+/* a struct that represents words to disassemble, the words of an image or the memory of a machine */
+typedef struct isa_image {
+	const int* words;
+	int words_num;
+	int code_num;	/* the number of code words, the words after them are data */
+	int first_addr;	/* the address of words[0] */
+	const char** labels;	/* the label defined at the address of every word (NULL if none), or NULL if the image has no labels */
+	const char** refs;	/* the external label every operand word refers to (NULL if none), or NULL if the image has no externals */
+} isa_image;
+
+
+/**
+ * isa_operation_of function returns the description of an operation.
+ *
+ * @param op - the operation (not no_op).
+ * @return - a pointer to the description.
+ */
+const isa_operation* isa_operation_of(ops op);
+
+
+/**
+ * isa_find_mnemonic function returns the operation of a mnemonic.
+ *
+ * @param str - the mnemonic.
+ * @return - the operation, or no_op if 'str' is not a mnemonic.
+ */
+ops isa_find_mnemonic(const char* str);
+
+
+/**
+ * isa_decode function returns the operation of the first word of an instruction, with one lookup in the table of the opcodes.
+ *
+ * @param word - the word.
+ * @return - the operation, or no_op if the opcode and funct of the word are not an operation.
+ */
+ops isa_decode(int word);
+
+
+/**
+ * isa_decode_operand function decodes an operand word.
+ *
+ * @param mode - the addressing type of the operand.
+ * @param word - the operand word.
+ * @param addr - the address of the operand word (relative operands are relative to it).
+ * @param res - an address of an integer where to store the decoded operand: immediate - the value, direct / relative - the address,
+ *              register - the number of the register.
+ * @return - 1 if the operand is valid (a register word must have one bit set), otherwise 0 is returned.
+ */
+int isa_decode_operand(addressing_type mode, int word, int addr, int* res);
+
+
+/**
+ * isa_binary function writes the low bits of a value as a string of '0' and '1' chars, most significant bit first.
+ *
+ * @param val - the value.
+ * @param bits - the number of bits.
+ * @param str - a string where to store the bits (at least bits + 1 chars).
+ */
+void isa_binary(int val, int bits, char* str);
+
+
+/**
+ * operands_num function returns the number of operands of an operation.
+ *
+ * @param op - the operation.
+ * @return - the number of operands (0, 1 or 2).
+ */
+int operands_num(ops op);
+
+
+/**
+ * to_signed function converts a 12 bits word to a signed integer (two's complement).
+ *
+ * @param word - the word.
+ * @return - the signed value.
+ */
+int to_signed(int word);
+
+
+/**
+ * disassemble function writes the instruction that starts at a word of an image as assembly ("mnemonic operands"). Direct and relative
+ * operands are written as the labels they refer to if the image has them, otherwise as addresses. A word that doesn't start a valid
+ * instruction in the code, and every data word, is written as ".data value".
+ *
+ * @param img - a pointer to the image.
+ * @param ind - the index of the word in the image.
+ * @param text - a string where to store the instruction (at least DISASSEMBLY_TEXT_LENGTH chars).
+ * @return - the number of words written (the length of the instruction, or 1).
+ */
+int disassemble(const isa_image* img, int ind, char* text);
+
+
+/**
+ * disassemble_operand function writes a decoded operand as assembly.
+ *
+ * @param img - a pointer to the image.
+ * @param ind - the index of the operand word in the image.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand (see isa_decode_operand function).
+ * @param text - a string where to store the operand.
+ */
+void disassemble_operand(const isa_image* img, int ind, addressing_type mode, int operand, char* text);
+
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * This file contains all functions related to resolving the labels used as operands in the 'assembler' after the first pass: the operands of
+ * the code image are resolved on a pool of threads against a hash table of the symbol table, which doesn't change anymore.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for threads */
+#include <pthread.h>
+#include <unistd.h>
+#include "label_resolver.h"
+#include "handler.h"	/* for SOURCE_OP and EXTERNAL, included after the other headers since 'parser.h' defines single letter macros */
+#include "emergency_free_mem.h"
+
+
+/**
+ * resolve_label_operands function gives every direct and relative operand of the code image the address of its label, on a pool of threads.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_symb_node - the pointer to the head-symbol-table-linked-list.
+ * @param operands - a pointer to where to store the array of the operands.
+ * @param errors - a pointer to where to store the array of the errors of the operands.
+ * @return - the number of operands.
+ */
+long resolve_label_operands(mcl_ptr head_mcl_node, symb_ptr head_symb_node, mcl_ptr** operands, ERR_VALUE** errors)
+{
+	pthread_t threads[MAX_RESOLVER_THREADS];
+	operand_range ranges[MAX_RESOLVER_THREADS];
+	label_index index;
+	mcl_ptr node;
+	long operands_num;
+	int threads_num;
+	int created;
+	int i;
+
+	for(operands_num = 0, node = head_mcl_node; node != NULL; node = node -> next) {
+		if(node -> mlt == direct_operand || node -> mlt == relative_operand) {
+			operands_num++;
+		}
+	}
+
+	*operands = malloc((operands_num + 1) * sizeof(mcl_ptr));	/* +1 so a code image without operands doesn't ask for 0 bytes */
+	*errors = malloc((operands_num + 1) * sizeof(ERR_VALUE));
+
+	/* verify if malloc worked as expected */
+	if(*operands == NULL || *errors == NULL)
+	{
+		free(*operands);
+		free(*errors);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(operands_num = 0, node = head_mcl_node; node != NULL; node = node -> next) {
+		if(node -> mlt == direct_operand || node -> mlt == relative_operand) {
+			(*operands)[operands_num++] = node;
+		}
+	}
+
+	if(operands_num == 0) {
+		return 0;
+	}
+
+	build_label_index(head_symb_node, &index);
+
+	threads_num = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if(threads_num > MAX_RESOLVER_THREADS) {
+		threads_num = MAX_RESOLVER_THREADS;
+	}
+	if(threads_num > operands_num / MIN_OPERANDS_PER_RESOLVER) {
+		threads_num = (int) (operands_num / MIN_OPERANDS_PER_RESOLVER);
+	}
+	if(threads_num < 1) {
+		threads_num = 1;
+	}
+
+	for(i = 0; i < threads_num; i++) {	/* disjoint ranges of operands, every word and error is written by one thread */
+		ranges[i].index = &index;
+		ranges[i].operands = *operands;
+		ranges[i].errors = *errors;
+		ranges[i].from = operands_num * i / threads_num;
+		ranges[i].to = operands_num * (i + 1) / threads_num;
+	}
+
+	/* the first range is resolved by this thread, a range whose thread could not be created too */
+	for(created = 0, i = 1; i < threads_num; i++) {
+		if(pthread_create(&threads[i], NULL, resolve_operand_range, &ranges[i]) != 0) {
+			break;
+		}
+		created++;
+	}
+	resolve_operand_range(&ranges[0]);
+	for(i = created + 1; i < threads_num; i++) {
+		resolve_operand_range(&ranges[i]);
+	}
+	for(i = 1; i <= created; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	free(index.slots);
+
+	return operands_num;
+}
+
+
+/**
+ * resolve_operand_range function resolves a range of operands of the code image.
+ *
+ * @param arg - a pointer to the range.
+ * @return - NULL.
+ */
+void* resolve_operand_range(void* arg)
+{
+	operand_range* range;
+	mcl_ptr node;
+	symb_ptr symbol;
+	long i;
+
+	range = (operand_range*) arg;
+
+	for(i = range -> from; i < range -> to; i++)
+	{
+		node = range -> operands[i];
+		symbol = find_label_index(range -> index, node -> l -> lbl);
+
+		if(symbol == NULL) {
+			range -> errors[i] = (node -> mlt == direct_operand && node -> l -> op_type == SOURCE_OP) ?
+				UNDEFINED_LABEL_IN_SOURCE_OPERAND : UNDEFINED_LABEL_IN_DESTINATION_OPERAND;
+			continue;
+		}
+
+		range -> errors[i] = NO_ERRORS;
+		if(node -> mlt == direct_operand) {
+			sprintf(node -> mem_val, "%d", symbol -> addr);
+			if(symbol -> attr == external) {
+				node -> memory_type = EXTERNAL;
+			}
+		}
+		else sprintf(node -> mem_val, "%d", (symbol -> addr - (node -> IC)));
+	}
+
+	return NULL;
+}
+
+
+/**
+ * build_label_index function creates the hash table of a symbol table.
+ *
+ * @param head - the pointer to the head-symbol-table-linked-list.
+ * @param index - a pointer to where to store the hash table.
+ */
+void build_label_index(symb_ptr head, label_index* index)
+{
+	symb_ptr symbol;
+	unsigned long slots_num;
+	unsigned long slot;
+	long symbols_num;
+
+	for(symbols_num = 0, symbol = head; symbol != NULL; symbol = symbol -> next) {
+		symbols_num++;
+	}
+
+	for(slots_num = 1; slots_num < (unsigned long) symbols_num * 2; slots_num *= 2)	/* at most half of the slots are used */
+		;
+
+	index -> slots = calloc(slots_num, sizeof(symb_ptr));
+	index -> mask = slots_num - 1;
+
+	/* verify if calloc worked as expected */
+	if(index -> slots == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(symbol = head; symbol != NULL; symbol = symbol -> next)
+	{
+		slot = label_hash(symbol -> label) & index -> mask;
+		while(index -> slots[slot] != NULL && strcmp(index -> slots[slot] -> label, symbol -> label) != 0) {
+			slot = (slot + 1) & index -> mask;
+		}
+		if(index -> slots[slot] == NULL) {	/* the first symbol with this label is kept */
+			index -> slots[slot] = symbol;
+		}
+	}
+}
+
+
+/**
+ * find_label_index function searches for a label in the hash table of a symbol table.
+ *
+ * @param index - a pointer to the hash table.
+ * @param label - the label.
+ * @return - a pointer to the symbol if found, otherwise NULL is returned.
+ */
+symb_ptr find_label_index(const label_index* index, const char* label)
+{
+	unsigned long slot;
+
+	for(slot = label_hash(label) & index -> mask; index -> slots[slot] != NULL; slot = (slot + 1) & index -> mask) {
+		if(strcmp(index -> slots[slot] -> label, label) == 0) {
+			return index -> slots[slot];
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * label_hash function returns the hash value of a label (djb2 hash).
+ *
+ * @param label - the label.
+ * @return - the hash value.
+ */
+unsigned long label_hash(const char* label)
+{
+	unsigned long hash;
+
+	hash = 5381;
+	while(*label != '\0') {
+		hash = hash * 33 + (unsigned char)*label++;
+	}
+
+	return hash;
+}
@@ -0,0 +1,86 @@
+#ifndef LABEL_RESOLVER_H
+#define LABEL_RESOLVER_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "line_details.h"	/* for ERR_VALUE enum */
+#include "memory_image.h"
+#include "symbol_table.h"
+#define MAX_RESOLVER_THREADS 16	/* the maximum number of threads that resolve the operands of one source file */
+#define MIN_OPERANDS_PER_RESOLVER 8192	/* fewer operands than this are not worth a thread of their own */
+
+
+/* a struct that represents the symbol table after the first pass, when it doesn't change anymore: the symbols are stored in an open addressing
+ * hash table (the number of slots is a power of 2, at least twice the number of symbols), which is only read by the threads */
+typedef struct label_index {
+	symb_ptr* slots;	/* the symbols, NULL for an empty slot */
+	unsigned long mask;	/* the number of slots - 1 */
+} label_index;
+
+
+/* a struct that represents the operands one thread resolves: a range of the operands of the code image, and where their errors are stored */
+typedef struct operand_range {
+	const label_index* index;	/* the symbol table */
+	mcl_ptr* operands;	/* the direct and relative operands of the whole code image, in the order of the list */
+	ERR_VALUE* errors;	/* the error of every operand (NO_ERRORS if its label was found) */
+	long from;	/* the index of the first operand of the range */
+	long to;	/* the index after the last operand of the range */
+} operand_range;
+
+
+/**
+ * resolve_label_operands function gives every direct and relative operand of the code image the address of its label, like second_pass_lbl
+ * and is_extern_symb functions in 'symbol_table.h' (an external label makes the word EXTERNAL). After the first pass the symbol table is final
+ * and every operand is resolved on its own, so the operands are split into ranges that are resolved on separate threads (one per processor, up
+ * to MAX_RESOLVER_THREADS) against a hash table of the symbols. Nothing is reported here: the error of every operand is stored in the order of
+ * the list, so the caller reports them (and adds the relocations) in the same order as if they were resolved one by one.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_symb_node - the pointer to the head-symbol-table-linked-list.
+ * @param operands - a pointer to where to store the array of the operands (must be freed).
+ * @param errors - a pointer to where to store the array of the errors of the operands (must be freed): NO_ERRORS, or
+ * UNDEFINED_LABEL_IN_SOURCE_OPERAND / UNDEFINED_LABEL_IN_DESTINATION_OPERAND if the label is not in the symbol table.
+ * @return - the number of operands.
+ */
+long resolve_label_operands(mcl_ptr head_mcl_node, symb_ptr head_symb_node, mcl_ptr** operands, ERR_VALUE** errors);
+
+
+/**
+ * resolve_operand_range function resolves a range of operands of the code image.
+ *
+ * @param arg - a pointer to the range (operand_range struct), the signature of a thread function.
+ * @return - NULL.
+ */
+void* resolve_operand_range(void* arg);
+
+
+/**
+ * build_label_index function creates the hash table of a symbol table. If a label appears twice, the first one is kept (like second_pass_lbl
+ * function finds it).
+ *
+ * @param head - the pointer to the head-symbol-table-linked-list.
+ * @param index - a pointer to where to store the hash table.
+ */
+void build_label_index(symb_ptr head, label_index* index);
+
+
+/**
+ * find_label_index function searches for a label in the hash table of a symbol table.
+ *
+ * @param index - a pointer to the hash table.
+ * @param label - the label.
+ * @return - a pointer to the symbol if found, otherwise NULL is returned.
+ */
+symb_ptr find_label_index(const label_index* index, const char* label);
+
+
+/**
+ * label_hash function returns the hash value of a label (djb2 hash), the slot is the hash value masked by the number of slots.
+ *
+ * @param label - the label.
+ * @return - the hash value.
+ */
+unsigned long label_hash(const char* label);
+
+
+#endif
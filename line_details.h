@@ -4,7 +4,6 @@
 #define MAX_STRING_SIZE 100
 #define WORD_IN_MACHINE 12
 #define NUMBER_OF_ADDRESSING_TYPES 4
-#define MAX_DATA_SIZE 60
 #define MAX_OPERATION_LENGTH 4
 #define MAX_OPERAND_AND_LABEL_LENGTH 31
 #define MAX_FILE_NAME_LENGTH 30
@@ -12,7 +11,8 @@
 
 /* An enum with all possible line types. It's used as output form function 'line_parser' from 'parser.c' file */
 typedef enum {EMPTY, COMMENT, ENTRY, EXTERN, GUIDANCE_DATA_WITH_LABEL, GUIDANCE_DATA_WITHOUT_LABEL, GUIDANCE_STRING_WITH_LABEL,
-GUIDANCE_STRING_WITHOUT_LABEL, INSTRUCTION_WITH_LABEL_2_OPERANDS, INSTRUCTION_WITH_LABEL_1_OPERAND,
+GUIDANCE_STRING_WITHOUT_LABEL, GUIDANCE_INCBIN_WITH_LABEL, GUIDANCE_INCBIN_WITHOUT_LABEL,
+GUIDANCE_FILL_WITH_LABEL, GUIDANCE_FILL_WITHOUT_LABEL, INCLUDE, INSTRUCTION_WITH_LABEL_2_OPERANDS, INSTRUCTION_WITH_LABEL_1_OPERAND,
 INSTRUCTION_WITH_LABEL_NO_OPERANDS, INSTRUCTION_WITHOUT_LABEL_2_OPERANDS,
 INSTRUCTION_WITHOUT_LABEL_1_OPERAND, INSTRUCTION_WITHOUT_LABEL_NO_OPERANDS, INVALID_LINE, UNDEFINED_LINE} LINE_TYPE;
 
@@ -31,7 +31,10 @@ INVALID_CHARACTER_BETWEEN_OPERANDS, REDUNDANT_INFORMATION_IN_OPERANDS_AREA, BAD_
 MISSING_INFORMATION_AFTER_STRING, UNKNOWN_LINE, MISSING_INFORMATION_AFTER_LABEL, UNDEFINED_LABEL, LABEL_NAME_LIKE_KEYWORD_NAME, 
 UNDEFINED_LABEL_IN_DESTINATION_OPERAND, UNDEFINED_LABEL_IN_SOURCE_OPERAND, ENTLY_LABEL_EXISTS_TRY_TO_ADD_EXTERN_LABEL, EXTERN_LABEL_EXISTS_TRY_TO_ADD_ENTRY_LABEL, LABEL_EXISTS_IN_CODE_TRY_TO_ADD_DATA_LABEL,
 LABEL_EXISTS_IN_DATA_TRY_TO_ADD_CODE_LABEL, DUPLICATE_CODE_LABEL_ATTEMPT, DUPLICATE_DATA_LABEL_ATTEMPT, UNDEFINED_ENTRY_LABEL, FILE_NAME_LONGER_THAN_ALLOWED,
-DATA_DOESNT_END_WITH_A_NUMBER, NO_ERRORS
+DATA_DOESNT_END_WITH_A_NUMBER, MISSING_INFORMATION_AFTER_INCBIN, INCBIN_BAD_SYNTAX, INCBIN_FILE_NOT_FOUND,
+MISSING_INFORMATION_AFTER_FILL, INVALID_FILL,
+INVALID_MACRO_NAME, DUPLICATE_MACRO_NAME, MISSING_ENDMCR, MISSING_INFORMATION_AFTER_INCLUDE, INCLUDE_BAD_SYNTAX,
+INCLUDE_FILE_NOT_FOUND, LABEL_BEFORE_INCLUDE, INCLUDE_NESTED_TOO_DEEP, INCBIN_TOO_LARGE, NO_ERRORS
 }
 ERR_VALUE;
 
@@ -75,9 +78,10 @@ typedef struct line_details{
 	char destination[MAX_OPERAND_AND_LABEL_LENGTH + 1];	/* store here if destination operand was in line */
 	addressing_type src_adr;	/* the addressing type of the source operand, addressing type enum is defind in this file */
 	addressing_type dest_adr;	/* the addressing type of the destination operand, addressing type enum is defind in this file */
-	char string[MAX_STRING_SIZE];	/* used to store the string comes after '.string' here */
-	int data[MAX_DATA_SIZE];	/* used to store the data comes after '.data' here */
-	int num_in_data_array;	/* used to store the quantity of the data that came after '.data' here */
+	char* payload;	/* points (inside the parsed line) to the validated string after '.string', the comma separated data after '.data' or the file name after '.incbin' / '.include' */
+	int incbin_bits;	/* the size (8 or 12) of the words read from the '.incbin' file */
+	int fill_count;	/* the number of words reserved by '.fill' / '.space' */
+	int fill_value;	/* the value of the words reserved by '.fill' / '.space' */
 	char num_to_mem[WORD_IN_MACHINE + 1];	/* store here the number needed for 'memory_image.c' file to retrieve */
 	char lbl_to_mem[MAX_OPERAND_AND_LABEL_LENGTH + 1];	/* store here the label needed for 'memory_image.c' file to retrieve */
 	ERR_VALUE err;	/* store here the err enum value here for 'handler.c' to trigger an error creation and addition */
@@ -0,0 +1,419 @@
+/**
+ * This file contains all functions related to linking assembled modules in the 'linker'. Entry labels of all modules are stored in a hash
+ * table (the global symbol table), so resolving an external label costs the same no matter how many modules are linked.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "link.h"
+#include "emergency_free_mem.h"
+
+static gs_ptr* global_table = NULL;	/* the global symbol table, each bucket is a list of symbols */
+static int global_table_size = 0;	/* the number of buckets of the global symbol table */
+static int globals_num = 0;	/* the number of symbols in the global symbol table */
+
+
+/**
+ * link_modules function links a list of modules into one image and writes it to '<out>.ob'.
+ *
+ * @param head - the head of the list of modules.
+ * @param archives - the head of the list of archives (NULL if there are no archives).
+ * @param out - the name of the linked image (without extension).
+ * @return - 1 if the image was written, otherwise 0 is returned.
+ */
+int link_modules(om_ptr head, ar_ptr archives, const char* out)
+{
+	om_ptr m;
+	int total_ic;
+	int total_dc;
+
+	for(m = head; m != NULL; m = m -> next) {
+		add_global_symbols(m);
+	}
+
+	if(archives != NULL) {
+		extract_archive_members(head, archives);
+	}
+
+	layout_modules(head, &total_ic, &total_dc);
+
+	for(m = head; m != NULL; m = m -> next) {
+		relocate_module(m);
+	}
+
+	if(were_link_errors()) {
+		return 0;
+	}
+
+	create_linked_file(head, out, total_ic, total_dc);
+
+	return 1;
+}
+
+
+/**
+ * extract_archive_members function loads the archive members that define external labels of the modules that aren't defined yet.
+ *
+ * @param head - the head of the list of modules.
+ * @param archives - the head of the list of archives.
+ */
+void extract_archive_members(om_ptr head, ar_ptr archives)
+{
+	om_ptr m;
+	om_ptr tail;
+	om_ptr member_module;
+	sr_ptr ext;
+	ar_ptr a;
+	int member;
+
+	for(tail = head; tail -> next != NULL; tail = tail -> next);
+
+	for(m = head; m != NULL; m = m -> next) {	/* members added to the end of the list are checked too */
+		for(ext = m -> externs; ext != NULL; ext = ext -> next)
+		{
+			if(find_global(ext -> label) != NULL) {
+				continue;
+			}
+
+			member = -1;
+			for(a = archives; a != NULL && (member = archive_find_symbol(a, ext -> label)) == -1; a = a -> next);
+
+			if(member == -1 || a -> loaded[member]) {	/* undefined labels are reported by relocate_module function */
+				continue;
+			}
+
+			member_module = archive_load_member(a, member);
+			if(member_module != NULL) {
+				tail -> next = member_module;
+				tail = member_module;
+				add_global_symbols(member_module);
+			}
+		}
+	}
+}
+
+
+/**
+ * layout_modules function sets the code_base and data_base of every module.
+ *
+ * @param head - the head of the list of modules.
+ * @param total_ic - an address of an integer where to store the number of code words of the linked image.
+ * @param total_dc - an address of an integer where to store the number of data words of the linked image.
+ */
+void layout_modules(om_ptr head, int* total_ic, int* total_dc)
+{
+	om_ptr m;
+
+	*total_ic = 0;
+	*total_dc = 0;
+
+	for(m = head; m != NULL; m = m -> next) {
+		m -> code_base = FIRST_ADDRESS + *total_ic;
+		*total_ic += m -> ic;
+	}
+
+	for(m = head; m != NULL; m = m -> next) {
+		m -> data_base = FIRST_ADDRESS + *total_ic + *total_dc;
+		*total_dc += m -> dc;
+	}
+}
+
+
+/**
+ * add_global_symbols function stores the entry labels of a module in the global symbol table.
+ *
+ * @param m - a pointer to the module.
+ */
+void add_global_symbols(om_ptr m)
+{
+	sr_ptr entry;
+	char* file_name;
+
+	for(entry = m -> entries; entry != NULL; entry = entry -> next)
+	{
+		if(find_global(entry -> label) != NULL) {
+			file_name = module_diagnostic_name(m, ENT_EXTENSION);
+			link_error(file_name, entry -> line, "Entry label is already defined in another module.", entry -> label);
+			free(file_name);
+			continue;
+		}
+		insert_global(entry, m);
+	}
+}
+
+
+/**
+ * relocate_module function relocates the 'R' words of a module and patches the words listed in its '.ext' file.
+ *
+ * @param m - a pointer to the module.
+ */
+void relocate_module(om_ptr m)
+{
+	sr_ptr ext;
+	gs_ptr symbol;
+	char* file_name;
+	int addr;
+	int i;
+
+	if(m -> relocs != NULL) {	/* only the words listed in the '.rel' file */
+		for(i = 0; i < m -> relocs_num; i++) {
+			if(m -> tags[m -> relocs[i]] == 'R') {
+				relocate_word(m, m -> relocs[i]);
+			}
+		}
+	}
+	else {
+		for(i = 0; i < m -> ic + m -> dc; i++) {
+			if(m -> tags[i] == 'R') {
+				relocate_word(m, i);
+			}
+		}
+	}
+
+	for(ext = m -> externs; ext != NULL; ext = ext -> next)
+	{
+		i = ext -> addr - FIRST_ADDRESS;
+		symbol = find_global(ext -> label);
+
+		if(i < 0 || i >= m -> ic || m -> tags[i] != 'E') {
+			file_name = module_diagnostic_name(m, EXT_EXTENSION);
+			link_error(file_name, ext -> line, "The address isn't of an external word of the module.", ext -> label);
+			free(file_name);
+			continue;
+		}
+
+		if(symbol == NULL) {
+			file_name = module_diagnostic_name(m, EXT_EXTENSION);
+			link_error(file_name, ext -> line, "Undefined external label. No module defines it as an entry.", ext -> label);
+			free(file_name);
+			continue;
+		}
+
+		addr = relocate_address(symbol -> module, symbol -> entry -> addr);
+		if(addr > MAX_WORD_VALUE) {
+			file_name = module_diagnostic_name(m, EXT_EXTENSION);
+			link_error(file_name, ext -> line, "The linked address doesn't fit in a word (the linked image is too large).", ext -> label);
+			free(file_name);
+		}
+		m -> words[i] = addr;
+		m -> tags[i] = 'R';
+	}
+}
+
+
+/**
+ * relocate_word function moves an 'R' word of a module to the new address of the code / data it points to.
+ *
+ * @param m - a pointer to the module.
+ * @param i - the index of the word in the module.
+ */
+void relocate_word(om_ptr m, int i)
+{
+	char* file_name;
+	int addr;
+
+	addr = relocate_address(m, m -> words[i]);
+	if(addr > MAX_WORD_VALUE) {
+		file_name = module_diagnostic_name(m, OB_EXTENSION);
+		link_error(file_name, m -> assembled ? 0 : i + 2, "The linked address doesn't fit in a word (the linked image is too large).", NULL);
+		free(file_name);
+	}
+	m -> words[i] = addr;
+}
+
+
+/**
+ * create_linked_file function writes the linked image to '<out>.ob'.
+ *
+ * @param head - the head of the list of modules.
+ * @param out - the name of the linked image (without extension).
+ * @param total_ic - the number of code words of the linked image.
+ * @param total_dc - the number of data words of the linked image.
+ */
+void create_linked_file(om_ptr head, const char* out, int total_ic, int total_dc)
+{
+	FILE* fp;
+	char* file_name;
+	om_ptr m;
+	int addr;
+	int i;
+
+	file_name = module_file_name(out, OB_EXTENSION);
+	fp = fopen(file_name, "w+");
+
+	if(fp == NULL) {
+		free(file_name);
+		printf("Could not create linked object file.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	fprintf(fp, "%d %d\n", total_ic, total_dc);
+
+	addr = FIRST_ADDRESS;
+	for(m = head; m != NULL; m = m -> next) {	/* the code of all modules */
+		for(i = 0; i < m -> ic; i++) {
+			fprintf(fp, "%04d %03X %c\n", addr++, m -> words[i], m -> tags[i]);
+		}
+	}
+	for(m = head; m != NULL; m = m -> next) {	/* the data of all modules */
+		for(i = m -> ic; i < m -> ic + m -> dc; i++) {
+			fprintf(fp, "%04d %03X %c\n", addr++, m -> words[i], m -> tags[i]);
+		}
+	}
+
+	printf("\nFile '%s' has been created successfully!", file_name);
+
+	fclose(fp);
+	free(file_name);
+}
+
+
+/**
+ * global_hash function returns the bucket of the global symbol table for 'label' (djb2 hash).
+ *
+ * @param label - the label.
+ * @return - the index of the bucket, from 0 to the size of the table - 1.
+ */
+unsigned int global_hash(const char* label)
+{
+	unsigned long hash;
+
+	hash = 5381;
+	while(*label != '\0') {
+		hash = hash * 33 + (unsigned char)*label++;
+	}
+
+	return hash % global_table_size;
+}
+
+
+/**
+ * find_global function searches for an entry label in the global symbol table.
+ *
+ * @param label - the label.
+ * @return - a pointer to the symbol if found, otherwise NULL is returned.
+ */
+gs_ptr find_global(const char* label)
+{
+	gs_ptr symbol;
+
+	if(global_table == NULL) {
+		return NULL;
+	}
+
+	for(symbol = global_table[global_hash(label)]; symbol != NULL; symbol = symbol -> next) {
+		if(strcmp(symbol -> entry -> label, label) == 0) {
+			return symbol;
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * insert_global function adds an entry label to the global symbol table.
+ *
+ * @param entry - the line of the '.ent' file that defines the label.
+ * @param m - the module that defines the label.
+ */
+void insert_global(sr_ptr entry, om_ptr m)
+{
+	gs_ptr symbol;
+	unsigned int bucket;
+
+	if(globals_num >= global_table_size) {	/* keep about one symbol per bucket */
+		grow_global_table();
+	}
+
+	symbol = malloc(sizeof(global_symbol));
+
+	/* verify if malloc worked as expected */
+	if(symbol == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	bucket = global_hash(entry -> label);
+	symbol -> entry = entry;
+	symbol -> module = m;
+	symbol -> next = global_table[bucket];
+	global_table[bucket] = symbol;
+	globals_num++;
+}
+
+
+/**
+ * grow_global_table function doubles the number of buckets of the global symbol table (or creates the table if it doesn't exist).
+ */
+void grow_global_table()
+{
+	gs_ptr* old_table;
+	int old_size;
+	gs_ptr symbol;
+	unsigned int bucket;
+	int i;
+
+	old_table = global_table;
+	old_size = global_table_size;
+
+	global_table_size = (old_size == 0) ? GLOBAL_TABLE_INITIAL_SIZE : old_size * 2;
+	global_table = calloc(global_table_size, sizeof(gs_ptr));
+
+	/* verify if calloc worked as expected */
+	if(global_table == NULL)
+	{
+		global_table = old_table;
+		global_table_size = old_size;
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(i = 0; i < old_size; i++)	/* move the symbols to their buckets in the new table */
+	{
+		while(old_table[i] != NULL)
+		{
+			symbol = old_table[i];
+			old_table[i] = symbol -> next;
+			bucket = global_hash(symbol -> entry -> label);
+			symbol -> next = global_table[bucket];
+			global_table[bucket] = symbol;
+		}
+	}
+
+	if(old_table != NULL) {
+		free(old_table);
+	}
+}
+
+
+/**
+ * free_global_table function frees the global symbol table.
+ */
+void free_global_table()
+{
+	gs_ptr symbol;
+	int i;
+
+	for(i = 0; i < global_table_size; i++)
+	{
+		while(global_table[i] != NULL)
+		{
+			symbol = global_table[i];
+			global_table[i] = symbol -> next;
+			free(symbol);
+		}
+	}
+
+	if(global_table != NULL) {
+		free(global_table);
+	}
+	global_table = NULL;
+	global_table_size = 0;
+	globals_num = 0;
+}
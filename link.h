@@ -0,0 +1,140 @@
+#ifndef LINK_H
+#define LINK_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "object_module.h"
+#include "archive.h"
+#define GLOBAL_TABLE_INITIAL_SIZE 1024	/* the number of buckets of the global symbol table, it doubles when it's full */
+
+
+/* a pointer to struct global_symbol */
+typedef struct global_symbol* gs_ptr;
+
+/* a struct that represents an entry label of one of the linked modules in the global symbol table. Symbols with the same hash value are
+ * chained in a list */
+typedef struct global_symbol {
+	sr_ptr entry;	/* the line of the '.ent' file that defined the symbol */
+	om_ptr module;	/* the module that defined the symbol */
+	gs_ptr next;	/* the next symbol in the same bucket of the global symbol table */
+} global_symbol;
+
+
+/**
+ * link_modules function links a list of modules into one image and writes it to '<out>.ob', in the format of the '.ob' files the 'assembler'
+ * creates (so the linked image can be loaded like any assembled file). Members of the archives that define labels the modules refer to are
+ * added to the end of the list (see extract_archive_members function). The code of all modules is placed first, in the order of the list,
+ * followed by the data of all modules. The entry labels of all modules are stored in the global symbol table, then every module is relocated
+ * and patched in one pass over its words: 'R' words are moved to the new address of the code / data they point to, and every word listed in the
+ * '.ext' file gets the address of the entry label it refers to (and becomes an 'R' word).
+ * Errors (undefined or duplicate labels, addresses that don't fit in a word) are reported with link_error function, and the image is not
+ * written if errors were found.
+ *
+ * @param head - the head of the list of modules.
+ * @param archives - the head of the list of archives (NULL if there are no archives).
+ * @param out - the name of the linked image (without extension).
+ * @return - 1 if the image was written, otherwise 0 is returned.
+ */
+int link_modules(om_ptr head, ar_ptr archives, const char* out);
+
+
+/**
+ * extract_archive_members function loads the archive members that define external labels of the modules that aren't defined yet, and adds
+ * them to the end of the list of modules (and their entry labels to the global symbol table). The externals of added members are resolved
+ * too, so a member may bring other members. Archives are searched in the order of the list, and a member is loaded once at most.
+ * Members that no module needs are never parsed.
+ *
+ * @param head - the head of the list of modules.
+ * @param archives - the head of the list of archives.
+ */
+void extract_archive_members(om_ptr head, ar_ptr archives);
+
+
+/**
+ * layout_modules function sets the code_base and data_base of every module.
+ *
+ * @param head - the head of the list of modules.
+ * @param total_ic - an address of an integer where to store the number of code words of the linked image.
+ * @param total_dc - an address of an integer where to store the number of data words of the linked image.
+ */
+void layout_modules(om_ptr head, int* total_ic, int* total_dc);
+
+
+/**
+ * add_global_symbols function stores the entry labels of a module in the global symbol table.
+ * An entry label that another module already defined is reported.
+ *
+ * @param m - a pointer to the module.
+ */
+void add_global_symbols(om_ptr m);
+
+
+/**
+ * relocate_module function relocates the 'R' words of a module and patches the words listed in its '.ext' file. If the module has a '.rel'
+ * file, only the words listed there are checked, otherwise every word of the module is.
+ *
+ * @param m - a pointer to the module.
+ */
+void relocate_module(om_ptr m);
+
+
+/**
+ * relocate_word function moves an 'R' word of a module to the new address of the code / data it points to.
+ *
+ * @param m - a pointer to the module.
+ * @param i - the index of the word in the module.
+ */
+void relocate_word(om_ptr m, int i);
+
+
+/**
+ * create_linked_file function writes the linked image to '<out>.ob'.
+ *
+ * @param head - the head of the list of modules.
+ * @param out - the name of the linked image (without extension).
+ * @param total_ic - the number of code words of the linked image.
+ * @param total_dc - the number of data words of the linked image.
+ */
+void create_linked_file(om_ptr head, const char* out, int total_ic, int total_dc);
+
+
+/**
+ * global_hash function returns the bucket of the global symbol table for 'label'.
+ *
+ * @param label - the label.
+ * @return - the index of the bucket, from 0 to the size of the table - 1.
+ */
+unsigned int global_hash(const char* label);
+
+
+/**
+ * find_global function searches for an entry label in the global symbol table.
+ *
+ * @param label - the label.
+ * @return - a pointer to the symbol if found, otherwise NULL is returned.
+ */
+gs_ptr find_global(const char* label);
+
+
+/**
+ * insert_global function adds an entry label to the global symbol table. The label must not exist in the table already.
+ *
+ * @param entry - the line of the '.ent' file that defines the label.
+ * @param m - the module that defines the label.
+ */
+void insert_global(sr_ptr entry, om_ptr m);
+
+
+/**
+ * grow_global_table function doubles the number of buckets of the global symbol table (or creates the table if it doesn't exist).
+ */
+void grow_global_table();
+
+
+/**
+ * free_global_table function frees the global symbol table.
+ */
+void free_global_table();
+
+
+#endif
@@ -0,0 +1,183 @@
+/**
+ * This is the main file of the 'linker'. It reads the modules the 'assembler' created (the names of the modules are given without extension,
+ * like the names of the source files given to the 'assembler') and links them into one image. Archives ('.oba' files) may be given too, only
+ * their members that define labels the modules need are linked. The 'linker' also creates archives.
+ * Usage: linker [-o name] [-i] module|archive.oba...
+ *        linker -c archive.oba module...
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "linker.h"
+#include "emergency_free_mem.h"
+
+/* module list pointers */
+om_ptr head_module = NULL;
+om_ptr curr_module = NULL;
+
+/* archive list pointers */
+ar_ptr head_archive = NULL;
+ar_ptr curr_archive = NULL;
+
+/* the names of the modules and archives, in the order they were given */
+char** names = NULL;
+
+
+/* main function */
+int main(int argc, char* argv[])
+{
+	/* variable definitions */
+	const char* out;
+	om_ptr m;
+	ar_ptr a;
+	int link_res;
+	int incremental;
+	int names_num;
+	int archives_num;
+	int i;
+
+	/* variable initializations */
+	out = DEFAULT_OUTPUT;
+	incremental = 0;
+	names_num = 0;
+	archives_num = 0;
+	i = 1;
+
+
+	/* create archive mode */
+	if(argc > 2 && strcmp(argv[1], CREATE_ARCHIVE_OPTION) == 0) {
+		if(!create_archive(argv[2], argv + 3, argc - 3)) {
+			printf("\n\n****  Creating the archive failed, %d errors detected  ****\n\n", were_link_errors());
+			return EXIT_FAILURE;
+		}
+		printf("\n\nModules have been archived successfully!\n\n");
+		return EXIT_SUCCESS;
+	}
+
+
+	names = malloc(argc * sizeof(char*));
+
+	/* verify if malloc worked as expected */
+	if(names == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		exit(EXIT_FAILURE);
+	}
+
+
+	/* get options from terminal input loop */
+	while(argv[i]) {
+		if(argv[i][0] == '-') {
+			if(strcmp(argv[i], OUTPUT_OPTION) == 0 && argv[i+1] != NULL) {
+				out = argv[++i];
+			}
+			else if(strcmp(argv[i], INCREMENTAL_OPTION) == 0) {
+				incremental = 1;
+			}
+			else {
+				printf("Unknown option '%s'. Program terminated.\n", argv[i]);
+				emergency_free_mem();
+				exit(EXIT_FAILURE);
+			}
+		}
+		else {
+			if(is_archive_name(argv[i])) {
+				archives_num++;
+			}
+			names[names_num++] = argv[i];
+		}
+		i++;
+	}
+
+
+	/* incremental relink, archives are always linked in full */
+	link_res = RELINK_FULL;
+	if(incremental && archives_num == 0 && names_num > 0) {
+		link_res = incremental_link(names, names_num, out);
+	}
+
+	if(link_res != RELINK_FULL) {
+		free(names);
+		names = NULL;
+		putchar('\n');
+		if(link_res == RELINK_FAILED) {
+			printf("\n****  Linking failed, %d errors detected  ****\n\n", were_link_errors());
+			return EXIT_FAILURE;
+		}
+		printf("\nModules have been linked successfully!\n\n");
+		return EXIT_SUCCESS;
+	}
+
+
+	/* get modules and archives loop */
+	for(i = 0; i < names_num; i++) {
+		if(is_archive_name(names[i])) {
+			a = open_archive(names[i]);
+			if(a != NULL) {
+				if(head_archive == NULL) {
+					head_archive = a;
+				}
+				else curr_archive -> next = a;
+				curr_archive = a;
+			}
+		}
+		else {
+			m = load_object_module(names[i]);
+			if(m != NULL) {
+				if(head_module == NULL) {
+					head_module = m;
+				}
+				else curr_module -> next = m;
+				curr_module = m;
+			}
+		}
+	}
+	free(names);
+	names = NULL;
+
+	if(head_module == NULL && !were_link_errors()) {
+		printf("No modules to link. Usage: linker [%s name] module|archive%s...\n", OUTPUT_OPTION, ARCHIVE_EXTENSION);
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	link_res = !were_link_errors() && link_modules(head_module, head_archive, out);
+
+	if(link_res && incremental && archives_num == 0) {
+		create_link_db(head_module, out);
+	}
+
+	free_global_table();
+	free_object_modules(&head_module);
+	curr_module = NULL;
+	close_archives(&head_archive);
+	curr_archive = NULL;
+
+	putchar('\n');
+	if(!link_res) {
+		printf("\n****  Linking failed, %d errors detected  ****\n\n", were_link_errors());
+		return EXIT_FAILURE;
+	}
+
+	printf("\nModules have been linked successfully!\n\n");
+	return EXIT_SUCCESS;
+}
+
+
+/**
+ * emergency_free_mem function frees all memory allocated during the execution. This function is called ONLY if any memory allocation fails.
+ * This function is not included in any .header file ('only in emergency_free.mem_h') to prevent using it accidentally.
+ */
+void emergency_free_mem()
+{
+	free_global_table();
+	free_object_modules(&head_module);
+	curr_module = NULL;
+	close_archives(&head_archive);
+	curr_archive = NULL;
+	if(names != NULL) {
+		free(names);
+	}
+	names = NULL;
+}
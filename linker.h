@@ -0,0 +1,15 @@
+#ifndef LINKER_H
+#define LINKER_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "object_module.h"
+#include "link.h"
+#include "relink.h"
+#define OUTPUT_OPTION "-o"	/* the name of the linked image follows */
+#define INCREMENTAL_OPTION "-i"	/* keep a link database, and relink only the modules that changed since the last link */
+#define CREATE_ARCHIVE_OPTION "-c"	/* create an archive (its name follows) of the modules instead of linking them */
+#define DEFAULT_OUTPUT "linked"	/* the name of the linked image if OUTPUT_OPTION wasn't given */
+
+
+#endif
@@ -0,0 +1,568 @@
+/**
+ * This file contains all functions related to running many instances (lanes) of one image in lockstep in the 'simulator'. Every step picks
+ * the lowest program counter of the lanes that are still running and executes its instruction for all lanes that are there, so the cost of
+ * dispatching an instruction is paid once for the whole group, and the loops over the lanes of a group touch consecutive words (the state is
+ * stored as struct of arrays). Lanes that take different branches run as separate groups until their program counters meet again.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "lockstep.h"
+#include "emergency_free_mem.h"
+
+
+/**
+ * create_lanes function creates a lane for every line of an input vectors file.
+ *
+ * @param mc - a pointer to the machine the image was loaded into.
+ * @param vectors_file - the name of the input vectors file.
+ * @return - a pointer to the lanes, or NULL if the file could not be read or is empty.
+ */
+lanes_ptr create_lanes(machine_ptr mc, const char* vectors_file)
+{
+	lanes_ptr ls;
+	char* vectors;
+	size_t len;
+	char* pos;
+	char* end;
+	int n, a, l, r;
+
+	vectors = read_whole_file(vectors_file, &len);
+	if(vectors == NULL) {
+		link_error(vectors_file, 0, "The input vectors file could not be opened.", NULL);
+		return NULL;
+	}
+
+	for(n = 0, pos = vectors; pos < vectors + len; n++) {	/* the number of lines, the last line may not end with a newline char */
+		end = memchr(pos, '\n', vectors + len - pos);
+		pos = end == NULL ? vectors + len : end + 1;
+	}
+	if(n == 0) {
+		free(vectors);
+		link_error(vectors_file, 0, "The input vectors file is empty. Every line is the input of one instance.", NULL);
+		return NULL;
+	}
+
+	ls = calloc(1, sizeof(lanes));
+
+	/* verify if calloc worked as expected */
+	if(ls == NULL)
+	{
+		free(vectors);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	ls -> mc = mc;
+	ls -> lanes_num = n;
+	ls -> vectors = vectors;
+	ls -> memory = malloc((size_t) MEMORY_SIZE * n * sizeof(int));
+	ls -> regs = calloc((size_t) REGISTERS_NUM * n, sizeof(int));
+	ls -> stack = malloc((size_t) MAX_STACK_DEPTH * n * sizeof(int));
+	ls -> sp = calloc(n, sizeof(int));
+	ls -> pc = malloc(n * sizeof(int));
+	ls -> zero = calloc(n, 1);
+	ls -> executed = calloc(n, sizeof(long));
+	ls -> done = calloc(n, 1);
+	ls -> status = calloc(n, sizeof(machine_status));
+	ls -> error = calloc(n, sizeof(char*));
+	ls -> input = malloc(n * sizeof(char*));
+	ls -> input_end = malloc(n * sizeof(char*));
+	ls -> output = calloc(n, sizeof(char*));
+	ls -> output_len = calloc(n, sizeof(int));
+	ls -> output_size = calloc(n, sizeof(int));
+	ls -> active = malloc(n * sizeof(int));
+	ls -> group = malloc(n * sizeof(int));
+
+	/* verify if malloc / calloc worked as expected */
+	if(ls -> memory == NULL || ls -> regs == NULL || ls -> stack == NULL || ls -> sp == NULL || ls -> pc == NULL || ls -> zero == NULL ||
+			ls -> executed == NULL || ls -> done == NULL || ls -> status == NULL || ls -> error == NULL || ls -> input == NULL ||
+			ls -> input_end == NULL || ls -> output == NULL || ls -> output_len == NULL || ls -> output_size == NULL || ls -> active == NULL ||
+			ls -> group == NULL)
+	{
+		free_lanes(&ls);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(a = 0; a < MEMORY_SIZE; a++) {
+		for(l = 0; l < n; l++) {
+			ls -> memory[a * n + l] = mc -> memory[a];
+		}
+	}
+	for(r = 0; r < REGISTERS_NUM; r++) {
+		for(l = 0; l < n; l++) {
+			ls -> regs[r * n + l] = mc -> regs[r];
+		}
+	}
+	for(a = 0; a < mc -> sp; a++) {	/* a machine restored from a snapshot may be inside a routine */
+		for(l = 0; l < n; l++) {
+			ls -> stack[a * n + l] = mc -> stack[a];
+		}
+	}
+
+	for(l = 0, pos = vectors; l < n; l++) {
+		end = memchr(pos, '\n', vectors + len - pos);
+		ls -> input[l] = pos;
+		ls -> input_end[l] = end == NULL ? vectors + len : end;
+		pos = end == NULL ? vectors + len : end + 1;
+
+		ls -> pc[l] = mc -> pc;
+		ls -> sp[l] = mc -> sp;
+		ls -> zero[l] = mc -> zero;
+		ls -> active[l] = l;
+	}
+	ls -> active_num = n;
+
+	return ls;
+}
+
+
+/**
+ * run_lanes function executes all lanes until every lane stopped, failed or reached the step limit.
+ *
+ * @param ls - a pointer to the lanes.
+ * @param max_steps - the maximum number of instructions every lane executes, or NO_STEP_LIMIT.
+ * @return - the number of instructions executed by all lanes together.
+ */
+long run_lanes(lanes_ptr ls, long max_steps)
+{
+	decoded_instruction* d;
+	int* g;
+	int k;
+	int addr;
+	int same;
+	int ended;
+	long total;
+	int j, l;
+
+	same = 0;
+	total = 0;
+
+	while(ls -> active_num > 0)
+	{
+		/* the group is the lanes with the lowest program counter, usually all lanes. Lanes that were together and didn't branch still are */
+		addr = ls -> pc[ls -> active[0]];
+		if(!same) {
+			same = 1;
+			for(j = 1; j < ls -> active_num; j++) {
+				l = ls -> active[j];
+				if(ls -> pc[l] != addr) {
+					same = 0;
+					if(ls -> pc[l] < addr) {
+						addr = ls -> pc[l];
+					}
+				}
+			}
+		}
+
+		if(same && max_steps == NO_STEP_LIMIT) {
+			g = ls -> active;
+			k = ls -> active_num;
+		}
+		else {
+			g = ls -> group;
+			k = 0;
+			for(j = 0; j < ls -> active_num; j++) {
+				l = ls -> active[j];
+				if(ls -> pc[l] != addr) {
+					continue;
+				}
+				if(ls -> executed[l] == max_steps) {
+					end_lanes(ls, &l, 1, MACHINE_STEP_LIMIT, NULL);
+				}
+				else g[k++] = l;
+			}
+		}
+
+		if(max_steps != NO_STEP_LIMIT) {	/* the instructions of every lane are counted only when they are limited */
+			for(j = 0; j < k; j++) {
+				ls -> executed[g[j]]++;
+			}
+		}
+		total += k;
+
+		ended = k == 0 || step_group(ls, addr, g, k);
+		if(ended) {	/* remove the lanes that are done */
+			for(j = 0, k = 0; j < ls -> active_num; j++) {
+				l = ls -> active[j];
+				if(!ls -> done[l]) {
+					ls -> active[k++] = l;
+				}
+				else if(ls -> status[l] == MACHINE_ERROR) {	/* the instruction was not executed */
+					total--;
+				}
+			}
+			ls -> active_num = k;
+		}
+
+		if(same && !ended && addr >= FIRST_ADDRESS && addr < ls -> mc -> code_end) {
+			d = &(ls -> mc -> code[addr]);
+			same = d -> op != bne && d -> op != rts && !((d -> op == jmp || d -> op == jsr) && d -> dest_mode == regis_direct);
+		}
+		else same = 0;
+	}
+
+	return total;
+}
+
+
+/**
+ * step_group function executes the instruction at an address for a group of lanes.
+ *
+ * @param ls - a pointer to the lanes.
+ * @param addr - the address.
+ * @param g - the lanes of the group.
+ * @param k - the number of lanes in the group.
+ * @return - 1 if lanes of the group are done after the instruction, otherwise 0 is returned.
+ */
+int step_group(lanes_ptr ls, int addr, int* g, int k)
+{
+	decoded_instruction* d;
+	int* src;
+	int* dest;
+	int* target;
+	int src_imm, dest_imm, target_const;
+	int src_mask, dest_mask, target_mask;
+	int next;
+	int ended;
+	int n;
+	int j, l, c;
+
+	n = ls -> lanes_num;
+	ended = 0;
+
+	if(addr < FIRST_ADDRESS || addr >= ls -> mc -> code_end) {
+		end_lanes(ls, g, k, MACHINE_ERROR, "The program counter is outside of the code.");
+		return 1;
+	}
+
+	d = &(ls -> mc -> code[addr]);
+	next = addr + d -> length;
+	src = lane_operand(ls, d -> src_mode, d -> src, &src_imm, &src_mask);
+	dest = lane_operand(ls, d -> dest_mode, d -> dest, &dest_imm, &dest_mask);
+
+	if(d -> dest_mode == regis_direct) {	/* the target of a jump */
+		target = ls -> regs + d -> dest * n;
+		target_mask = -1;
+	}
+	else {
+		target_const = d -> dest;
+		target = &target_const;
+		target_mask = 0;
+	}
+
+	/* the destination operand is the same word in all lanes, so writing to an immediate operand / to the code is checked once */
+	if(writes_operand(d -> op)) {
+		if(d -> dest_mode == immediate || (d -> op == lea && d -> src_mode != direct && d -> src_mode != relative)) {
+			end_lanes(ls, g, k, MACHINE_ERROR, "Invalid instruction.");
+			return 1;
+		}
+		if(d -> dest_mode != regis_direct && d -> dest < ls -> mc -> code_end) {
+			end_lanes(ls, g, k, MACHINE_ERROR, "Stores to the code are not supported when instances run in lockstep.");
+			return 1;
+		}
+	}
+
+	switch(d -> op)
+	{
+		case mov:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				dest[l] = src[l & src_mask];
+				ls -> pc[l] = next;
+			}
+			break;
+
+		case cmp:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				ls -> zero[l] = ((src[l & src_mask] - dest[l & dest_mask]) & WORD_MASK) == 0;
+				ls -> pc[l] = next;
+			}
+			break;
+
+		case add:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				dest[l] = (dest[l] + src[l & src_mask]) & WORD_MASK;
+				ls -> pc[l] = next;
+			}
+			break;
+
+		case sub:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				dest[l] = (dest[l] - src[l & src_mask]) & WORD_MASK;
+				ls -> pc[l] = next;
+			}
+			break;
+
+		case lea:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				dest[l] = d -> src;
+				ls -> pc[l] = next;
+			}
+			break;
+
+		case clr:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				dest[l] = 0;
+				ls -> pc[l] = next;
+			}
+			break;
+
+		case not:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				dest[l] = ~dest[l] & WORD_MASK;
+				ls -> pc[l] = next;
+			}
+			break;
+
+		case inc:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				dest[l] = (dest[l] + 1) & WORD_MASK;
+				ls -> pc[l] = next;
+			}
+			break;
+
+		case dec:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				dest[l] = (dest[l] - 1) & WORD_MASK;
+				ls -> pc[l] = next;
+			}
+			break;
+
+		case jmp:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				ls -> pc[l] = target[l & target_mask];
+			}
+			break;
+
+		case bne:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				ls -> pc[l] = ls -> zero[l] ? next : target[l & target_mask];
+			}
+			break;
+
+		case jsr:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				if(ls -> sp[l] == MAX_STACK_DEPTH) {
+					end_lanes(ls, &l, 1, MACHINE_ERROR, "Stack overflow. Too many nested 'jsr' calls.");
+					ended = 1;
+					continue;
+				}
+				ls -> stack[(ls -> sp[l])++ * n + l] = next;
+				ls -> pc[l] = target[l & target_mask];
+			}
+			break;
+
+		case red:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				c = ls -> input[l] < ls -> input_end[l] ? (unsigned char) *(ls -> input[l]++) : EOF;
+				dest[l] = c & WORD_MASK;
+				ls -> pc[l] = next;
+			}
+			break;
+
+		case prn:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				lane_putchar(ls, l, dest[l & dest_mask] & 0xFF);
+				ls -> pc[l] = next;
+			}
+			break;
+
+		case rts:
+			for(j = 0; j < k; j++) {
+				l = g[j];
+				if(ls -> sp[l] == 0) {
+					end_lanes(ls, &l, 1, MACHINE_ERROR, "Stack underflow. 'rts' without 'jsr'.");
+					ended = 1;
+					continue;
+				}
+				ls -> pc[l] = ls -> stack[--(ls -> sp[l]) * n + l];
+			}
+			break;
+
+		case stop:
+			end_lanes(ls, g, k, MACHINE_STOPPED, NULL);
+			return 1;
+
+		default:
+			end_lanes(ls, g, k, MACHINE_ERROR, "Invalid instruction.");
+			return 1;
+	}
+
+	return ended;
+}
+
+
+/**
+ * lane_operand function resolves an operand to the array of its values in all lanes.
+ *
+ * @param ls - a pointer to the lanes.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand.
+ * @param imm - where the value of an immediate operand is stored.
+ * @param mask - an address of an integer where to store the mask.
+ * @return - the array of the values.
+ */
+int* lane_operand(lanes_ptr ls, addressing_type mode, int operand, int* imm, int* mask)
+{
+	*mask = -1;
+
+	if(mode == regis_direct) {
+		return ls -> regs + operand * ls -> lanes_num;
+	}
+	else if(mode == immediate) {
+		*imm = operand & WORD_MASK;
+		*mask = 0;
+		return imm;
+	}
+
+	return ls -> memory + operand * ls -> lanes_num;
+}
+
+
+/**
+ * end_lanes function marks lanes of a group as done.
+ *
+ * @param ls - a pointer to the lanes.
+ * @param g - the lanes of the group.
+ * @param k - the number of lanes in the group.
+ * @param status - the result of the lanes.
+ * @param error - the description of the error if status is MACHINE_ERROR, otherwise NULL.
+ */
+void end_lanes(lanes_ptr ls, int* g, int k, machine_status status, const char* error)
+{
+	int j;
+
+	for(j = 0; j < k; j++) {
+		ls -> done[g[j]] = 1;
+		ls -> status[g[j]] = status;
+		ls -> error[g[j]] = error;
+		if(status == MACHINE_ERROR) {	/* the instruction was not executed */
+			ls -> executed[g[j]]--;
+		}
+	}
+}
+
+
+/**
+ * lane_putchar function adds a character to the output of a lane.
+ *
+ * @param ls - a pointer to the lanes.
+ * @param l - the lane.
+ * @param c - the character.
+ */
+void lane_putchar(lanes_ptr ls, int l, int c)
+{
+	char* temp;
+
+	if(ls -> output_len[l] == ls -> output_size[l]) {
+		temp = realloc(ls -> output[l], ls -> output_size[l] == 0 ? LANE_OUTPUT_INITIAL_SIZE : ls -> output_size[l] * 2);
+
+		/* verify if realloc worked as expected */
+		if(temp == NULL)
+		{
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+
+		ls -> output[l] = temp;
+		ls -> output_size[l] = ls -> output_size[l] == 0 ? LANE_OUTPUT_INITIAL_SIZE : ls -> output_size[l] * 2;
+	}
+
+	ls -> output[l][ls -> output_len[l]++] = c;
+}
+
+
+/**
+ * print_lanes function prints the output of every lane in a line of its own, and the error of lanes that failed.
+ *
+ * @param ls - a pointer to the lanes.
+ * @return - the number of lanes that failed.
+ */
+int print_lanes(lanes_ptr ls)
+{
+	int failed;
+	int l;
+
+	for(failed = 0, l = 0; l < ls -> lanes_num; l++)
+	{
+		printf("%d: ", l + 1);
+		if(ls -> output_len[l] > 0) {
+			fwrite(ls -> output[l], 1, ls -> output_len[l], stdout);
+		}
+
+		if(ls -> status[l] == MACHINE_ERROR) {
+			printf(" [Runtime error, address %04d: %s]", ls -> pc[l], ls -> error[l]);
+			failed++;
+		}
+		else if(ls -> status[l] == MACHINE_STEP_LIMIT) {
+			printf(" [Stopped after %ld instructions (the limit).]", ls -> executed[l]);
+		}
+		putchar('\n');
+	}
+
+	return failed;
+}
+
+
+/**
+ * free_lanes function frees the lanes (not their machine).
+ *
+ * @param ls - the pointer to the pointer to the lanes.
+ */
+void free_lanes(lanes_ptr* ls)
+{
+	int l;
+
+	if(*ls == NULL) {
+		return;
+	}
+
+	if((*ls) -> output != NULL) {
+		for(l = 0; l < (*ls) -> lanes_num; l++) {
+			if((*ls) -> output[l] != NULL) {
+				free((*ls) -> output[l]);
+			}
+		}
+	}
+
+	/* free(NULL) does nothing, so arrays that were not allocated are fine */
+	free((*ls) -> memory);
+	free((*ls) -> regs);
+	free((*ls) -> stack);
+	free((*ls) -> sp);
+	free((*ls) -> pc);
+	free((*ls) -> zero);
+	free((*ls) -> executed);
+	free((*ls) -> done);
+	free((*ls) -> status);
+	free((*ls) -> error);
+	free((*ls) -> input);
+	free((*ls) -> input_end);
+	free((*ls) -> output);
+	free((*ls) -> output_len);
+	free((*ls) -> output_size);
+	free((*ls) -> active);
+	free((*ls) -> group);
+	free((*ls) -> vectors);
+	free(*ls);
+	*ls = NULL;
+}
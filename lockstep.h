@@ -0,0 +1,130 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "machine.h"
+#define LANE_OUTPUT_INITIAL_SIZE 64	/* the size of the output buffer of a lane, it doubles when it's full */
+
+
+/* a pointer to struct lanes */
+typedef struct lanes* lanes_ptr;
+
+/* a struct that represents N instances (lanes) of one image that run in lockstep. The state is stored as struct of arrays: the value of
+ * register r of lane l is regs[r * lanes_num + l], and the value of address a of lane l is memory[a * lanes_num + l], so an instruction
+ * executed by many lanes touches consecutive words. The code is decoded once and shared by all lanes */
+typedef struct lanes {
+	machine_ptr mc;	/* the machine the image was loaded into, for its decoded code and its memory at the start */
+	int lanes_num;
+	int* memory;	/* MEMORY_SIZE * lanes_num words */
+	int* regs;	/* REGISTERS_NUM * lanes_num words */
+	int* stack;	/* MAX_STACK_DEPTH * lanes_num return addresses */
+	int* sp;
+	int* pc;
+	char* zero;
+	long* executed;	/* the number of instructions executed by every lane, counted only when there is a step limit */
+	char* done;	/* 1 if the lane stopped, failed or reached the step limit */
+	machine_status* status;	/* the result of every lane, valid when the lane is done */
+	const char** error;	/* the description of the error of every lane that failed */
+	const char** input;	/* the next character of the input vector of every lane ('red') */
+	const char** input_end;
+	char** output;	/* the output of every lane ('prn') */
+	int* output_len;
+	int* output_size;
+	int* active;	/* the lanes that are not done */
+	int active_num;
+	int* group;	/* the lanes executed in the current step */
+	char* vectors;	/* the contents of the input vectors file */
+} lanes;
+
+
+/**
+ * create_lanes function creates a lane for every line of an input vectors file. Every lane starts with the memory of the machine, and reads
+ * the characters of its line with 'red' (after the end of the line 'red' reads -1, like getchar at end of file).
+ *
+ * @param mc - a pointer to the machine the image was loaded into (see create_machine function in 'machine.h'). It must not be freed before the
+ *             lanes are.
+ * @param vectors_file - the name of the input vectors file.
+ * @return - a pointer to the lanes, or NULL if the file could not be read or is empty.
+ */
+lanes_ptr create_lanes(machine_ptr mc, const char* vectors_file);
+
+
+/**
+ * run_lanes function executes all lanes until every lane stopped, failed or reached the step limit. In every step the lanes with the lowest
+ * program counter execute its instruction together (so lanes that took different branches join again where the branches meet), and the
+ * instruction is dispatched once for all of them.
+ *
+ * @param ls - a pointer to the lanes.
+ * @param max_steps - the maximum number of instructions every lane executes, or NO_STEP_LIMIT.
+ * @return - the number of instructions executed by all lanes together.
+ */
+long run_lanes(lanes_ptr ls, long max_steps);
+
+
+/**
+ * step_group function executes the instruction at an address for a group of lanes.
+ *
+ * @param ls - a pointer to the lanes.
+ * @param addr - the address.
+ * @param g - the lanes of the group.
+ * @param k - the number of lanes in the group.
+ * @return - 1 if lanes of the group are done after the instruction, otherwise 0 is returned.
+ */
+int step_group(lanes_ptr ls, int addr, int* g, int k);
+
+
+/**
+ * lane_operand function resolves an operand to the array of its values in all lanes. The value for lane l is the returned array at index
+ * (l & mask): an immediate operand is one value, so its mask is 0.
+ *
+ * @param ls - a pointer to the lanes.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand (see decoded_instruction struct in 'machine.h').
+ * @param imm - where the value of an immediate operand is stored.
+ * @param mask - an address of an integer where to store the mask.
+ * @return - the array of the values.
+ */
+int* lane_operand(lanes_ptr ls, addressing_type mode, int operand, int* imm, int* mask);
+
+
+/**
+ * end_lanes function marks lanes of a group as done.
+ *
+ * @param ls - a pointer to the lanes.
+ * @param g - the lanes of the group.
+ * @param k - the number of lanes in the group.
+ * @param status - the result of the lanes.
+ * @param error - the description of the error if status is MACHINE_ERROR, otherwise NULL.
+ */
+void end_lanes(lanes_ptr ls, int* g, int k, machine_status status, const char* error);
+
+
+/**
+ * lane_putchar function adds a character to the output of a lane.
+ *
+ * @param ls - a pointer to the lanes.
+ * @param l - the lane.
+ * @param c - the character.
+ */
+void lane_putchar(lanes_ptr ls, int l, int c);
+
+
+/**
+ * print_lanes function prints the output of every lane in a line of its own, "LANE: OUTPUT", and the error of lanes that failed.
+ *
+ * @param ls - a pointer to the lanes.
+ * @return - the number of lanes that failed.
+ */
+int print_lanes(lanes_ptr ls);
+
+
+/**
+ * free_lanes function frees the lanes (not their machine).
+ *
+ * @param ls - the pointer to the pointer to the lanes.
+ */
+void free_lanes(lanes_ptr* ls);
+
+
+#endif
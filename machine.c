@@ -0,0 +1,511 @@
+/**
+ * This file contains all functions related to executing assembled images in the 'simulator'. The code of the image is decoded once, when it's
+ * loaded, into an array indexed by address, and the simulator dispatches on the decoded operation with one dense switch, so executing an
+ * instruction never extracts bits of a word or searches the operation table.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "machine.h"
+#include "profiler.h"	/* for the calls / returns of a profiled execution */
+#include "trace.h"	/* for the records of a traced execution */
+#include "emergency_free_mem.h"
+
+
+/**
+ * create_machine function creates a machine and loads a module into its memory.
+ *
+ * @param m - a pointer to the module.
+ * @return - a pointer to the machine, or NULL if the module can't be loaded.
+ */
+machine_ptr create_machine(om_ptr m)
+{
+	machine_ptr mc;
+
+	if(!check_image(m)) {
+		return NULL;
+	}
+
+	mc = calloc(1, sizeof(machine));
+
+	/* verify if calloc worked as expected */
+	if(mc == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	load_machine(mc, m);
+
+	return mc;
+}
+
+
+/**
+ * check_image function checks whether a module can be loaded into a machine.
+ *
+ * @param m - a pointer to the module.
+ * @return - 1 if the module can be loaded, otherwise 0 is returned.
+ */
+int check_image(om_ptr m)
+{
+	char* file_name;
+	int i;
+
+	file_name = module_file_name(m -> name, OB_EXTENSION);
+
+	if(FIRST_ADDRESS + m -> ic + m -> dc > MEMORY_SIZE) {
+		link_error(file_name, 1, "The image is larger than the memory of the machine.", NULL);
+		free(file_name);
+		return 0;
+	}
+
+	for(i = 0; i < m -> ic + m -> dc; i++) {
+		if(m -> tags[i] == 'E') {
+			link_error(file_name, i + 2, "The image has external words, it must be linked before it's executed.", NULL);
+			free(file_name);
+			return 0;
+		}
+	}
+	free(file_name);
+
+	return 1;
+}
+
+
+/**
+ * load_machine function resets a machine and loads a module into its memory.
+ *
+ * @param mc - a pointer to the machine.
+ * @param m - a pointer to the module.
+ */
+void load_machine(machine_ptr mc, om_ptr m)
+{
+	char* output;
+	int output_size;
+	int i;
+
+	output = mc -> output;	/* the output buffer is kept, so a machine that runs many images allocates it once */
+	output_size = mc -> output_size;
+	memset(mc, 0, sizeof(machine));
+	mc -> output = output;
+	mc -> output_size = output_size;
+
+	for(i = 0; i < m -> ic + m -> dc; i++) {
+		mc -> memory[FIRST_ADDRESS + i] = m -> words[i];
+	}
+	mc -> code_end = FIRST_ADDRESS + m -> ic;
+	mc -> pc = FIRST_ADDRESS;
+
+	for(i = FIRST_ADDRESS; i < mc -> code_end; i++) {
+		predecode(mc, i);
+	}
+}
+
+
+/**
+ * run_machine function executes instructions from the current pc until 'stop', an error or the step limit.
+ *
+ * @param mc - a pointer to the machine.
+ * @param max_steps - the maximum number of instructions to execute, or NO_STEP_LIMIT.
+ * @return - MACHINE_STOPPED, MACHINE_STEP_LIMIT or MACHINE_ERROR.
+ */
+machine_status run_machine(machine_ptr mc, long max_steps)
+{
+	decoded_instruction* ins;
+	long* counts;
+	int observed;
+	int pc;
+	int val;
+	int c;
+	long executed;
+	machine_status res;
+
+	pc = mc -> pc;
+	executed = mc -> executed;
+	counts = mc -> prof == NULL ? NULL : mc -> prof -> counts;
+	observed = counts != NULL || mc -> trace != NULL;	/* one check per instruction when the execution is neither profiled nor traced */
+	mc -> error = NULL;
+
+	for(;;)
+	{
+		if(pc < FIRST_ADDRESS || pc >= mc -> code_end) {
+			mc -> error = "The program counter is outside of the code.";
+			res = MACHINE_ERROR;
+			break;
+		}
+		if(executed == max_steps) {
+			res = MACHINE_STEP_LIMIT;
+			break;
+		}
+
+		ins = &(mc -> code[pc]);
+		executed++;
+		if(observed) {
+			if(counts != NULL) {
+				counts[pc]++;
+			}
+			if(mc -> trace != NULL) {
+				trace_step(mc -> trace, mc, pc);
+			}
+		}
+
+		switch(ins -> op)
+		{
+			case mov:
+				val = read_operand(mc, ins -> src_mode, ins -> src);
+				if(!write_operand(mc, ins -> dest_mode, ins -> dest, val)) {
+					break;
+				}
+				pc += ins -> length;
+				continue;
+
+			case cmp:
+				mc -> zero = ((read_operand(mc, ins -> src_mode, ins -> src) - read_operand(mc, ins -> dest_mode, ins -> dest)) & WORD_MASK) == 0;
+				pc += ins -> length;
+				continue;
+
+			case add:
+				val = read_operand(mc, ins -> dest_mode, ins -> dest) + read_operand(mc, ins -> src_mode, ins -> src);
+				if(!write_operand(mc, ins -> dest_mode, ins -> dest, val)) {
+					break;
+				}
+				pc += ins -> length;
+				continue;
+
+			case sub:
+				val = read_operand(mc, ins -> dest_mode, ins -> dest) - read_operand(mc, ins -> src_mode, ins -> src);
+				if(!write_operand(mc, ins -> dest_mode, ins -> dest, val)) {
+					break;
+				}
+				pc += ins -> length;
+				continue;
+
+			case lea:
+				if(ins -> src_mode != direct && ins -> src_mode != relative) {
+					break;
+				}
+				if(!write_operand(mc, ins -> dest_mode, ins -> dest, ins -> src)) {
+					break;
+				}
+				pc += ins -> length;
+				continue;
+
+			case clr:
+				if(!write_operand(mc, ins -> dest_mode, ins -> dest, 0)) {
+					break;
+				}
+				pc += ins -> length;
+				continue;
+
+			case not:
+				if(!write_operand(mc, ins -> dest_mode, ins -> dest, ~read_operand(mc, ins -> dest_mode, ins -> dest))) {
+					break;
+				}
+				pc += ins -> length;
+				continue;
+
+			case inc:
+				if(!write_operand(mc, ins -> dest_mode, ins -> dest, read_operand(mc, ins -> dest_mode, ins -> dest) + 1)) {
+					break;
+				}
+				pc += ins -> length;
+				continue;
+
+			case dec:
+				if(!write_operand(mc, ins -> dest_mode, ins -> dest, read_operand(mc, ins -> dest_mode, ins -> dest) - 1)) {
+					break;
+				}
+				pc += ins -> length;
+				continue;
+
+			case jmp:
+				pc = jump_target(mc, ins -> dest_mode, ins -> dest);
+				continue;
+
+			case bne:
+				pc = mc -> zero ? pc + ins -> length : jump_target(mc, ins -> dest_mode, ins -> dest);
+				continue;
+
+			case jsr:
+				if(mc -> sp == MAX_STACK_DEPTH) {
+					mc -> error = "Stack overflow. Too many nested 'jsr' calls.";
+					break;
+				}
+				mc -> stack[mc -> sp++] = pc + ins -> length;
+				pc = jump_target(mc, ins -> dest_mode, ins -> dest);
+				if(counts != NULL) {
+					profile_call(mc -> prof, pc, executed);
+				}
+				continue;
+
+			case red:
+				c = machine_getchar(mc);
+				if(!write_operand(mc, ins -> dest_mode, ins -> dest, c)) {
+					break;
+				}
+				pc += ins -> length;
+				continue;
+
+			case prn:
+				machine_putchar(mc, read_operand(mc, ins -> dest_mode, ins -> dest) & 0xFF);
+				pc += ins -> length;
+				continue;
+
+			case rts:
+				if(mc -> sp == 0) {
+					mc -> error = "Stack underflow. 'rts' without 'jsr'.";
+					break;
+				}
+				pc = mc -> stack[--(mc -> sp)];
+				if(counts != NULL) {
+					profile_return(mc -> prof, executed);
+				}
+				continue;
+
+			case stop:
+				mc -> pc = pc;
+				mc -> executed = executed;
+				return MACHINE_STOPPED;
+
+			default:
+				break;
+		}
+
+		/* only instructions that could not be executed get here */
+		executed--;
+		if(counts != NULL) {
+			counts[pc]--;
+		}
+		if(mc -> error == NULL) {
+			mc -> error = "Invalid instruction.";
+		}
+		res = MACHINE_ERROR;
+		break;
+	}
+
+	mc -> pc = pc;
+	mc -> executed = executed;
+
+	return res;
+}
+
+
+/**
+ * read_operand function returns the value of a decoded operand.
+ *
+ * @param mc - a pointer to the machine.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand (see decoded_instruction struct).
+ * @return - the value of the operand (12 bits).
+ */
+int read_operand(machine_ptr mc, addressing_type mode, int operand)
+{
+	if(mode == regis_direct) {
+		return mc -> regs[operand];
+	}
+	else if(mode == immediate) {
+		return operand & WORD_MASK;
+	}
+
+	return mc -> memory[operand];
+}
+
+
+/**
+ * write_operand function stores a value in the register / memory word a decoded operand refers to.
+ *
+ * @param mc - a pointer to the machine.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand (see decoded_instruction struct).
+ * @param val - the value, only its 12 low bits are stored.
+ * @return - 1 if the value was stored, 0 if the operand can't be written (an immediate operand).
+ */
+int write_operand(machine_ptr mc, addressing_type mode, int operand, int val)
+{
+	if(mode == regis_direct) {
+		mc -> regs[operand] = val & WORD_MASK;
+		return 1;
+	}
+	else if(mode == immediate) {
+		return 0;
+	}
+
+	store_word(mc, operand, val & WORD_MASK);
+	return 1;
+}
+
+
+/**
+ * jump_target function returns the address a jump operand refers to.
+ *
+ * @param mc - a pointer to the machine.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand (see decoded_instruction struct).
+ * @return - the address.
+ */
+int jump_target(machine_ptr mc, addressing_type mode, int operand)
+{
+	if(mode == regis_direct) {
+		return mc -> regs[operand];
+	}
+
+	return operand;	/* an immediate jump target is not valid, it's caught as a program counter outside of the code */
+}
+
+
+/**
+ * predecode function decodes the instruction that starts at an address of the code.
+ *
+ * @param mc - a pointer to the machine.
+ * @param addr - the address.
+ */
+void predecode(machine_ptr mc, int addr)
+{
+	decoded_instruction* d;
+	int word;
+	ops op;
+
+	d = &(mc -> code[addr]);
+	word = mc -> memory[addr];
+
+	d -> op = no_op;
+	d -> length = 1;
+	d -> src_mode = (addressing_type) ((word >> 2) & 3);
+	d -> dest_mode = (addressing_type) (word & 3);
+	d -> src = 0;
+	d -> dest = 0;
+
+	op = isa_decode(word);
+	if(op == no_op) {
+		return;
+	}
+
+	d -> length = 1 + operands_num(op);
+	if(addr + d -> length > mc -> code_end) {
+		d -> length = 1;
+		return;
+	}
+
+	if(operands_num(op) == 2) {
+		if(!decode_operand(d -> src_mode, mc -> memory[addr + 1], addr + 1, &(d -> src)) ||
+				!decode_operand(d -> dest_mode, mc -> memory[addr + 2], addr + 2, &(d -> dest))) {
+			return;
+		}
+	}
+	else if(operands_num(op) == 1) {
+		if(!decode_operand(d -> dest_mode, mc -> memory[addr + 1], addr + 1, &(d -> dest))) {
+			return;
+		}
+	}
+
+	d -> op = op;
+}
+
+
+/**
+ * decode_operand function decodes an operand word.
+ *
+ * @param mode - the addressing type of the operand.
+ * @param word - the operand word.
+ * @param addr - the address of the operand word.
+ * @param res - an address of an integer where to store the decoded operand.
+ * @return - 1 if the operand is valid, otherwise 0 is returned.
+ */
+int decode_operand(addressing_type mode, int word, int addr, int* res)
+{
+	if(!isa_decode_operand(mode, word, addr, res)) {
+		return 0;
+	}
+
+	return mode != relative || (*res >= 0 && *res < MEMORY_SIZE);
+}
+
+
+/**
+ * writes_operand function checks whether an operation writes to its destination operand.
+ *
+ * @param op - the operation.
+ * @return - 1 if the operation writes to its destination operand, otherwise 0 is returned.
+ */
+int writes_operand(ops op)
+{
+	return (op <= dec && op != cmp) || op == red;
+}
+
+
+/**
+ * store_word function writes a word to the memory.
+ *
+ * @param mc - a pointer to the machine.
+ * @param addr - the address (must be a valid address).
+ * @param val - the value.
+ */
+void store_word(machine_ptr mc, int addr, int val)
+{
+	int i;
+
+	mc -> memory[addr] = val;
+
+	if(addr < mc -> code_end) {	/* self modifying code, an instruction is up to 3 words long */
+		mc -> code_writes++;
+		mc -> last_code_write = addr;
+		for(i = addr - 2; i <= addr; i++) {
+			if(i >= FIRST_ADDRESS) {
+				predecode(mc, i);
+			}
+		}
+	}
+}
+
+
+/**
+ * machine_getchar function reads the next input character of a machine ('red').
+ *
+ * @param mc - a pointer to the machine.
+ * @return - the character, or -1 at the end of the input.
+ */
+int machine_getchar(machine_ptr mc)
+{
+	if(!mc -> redirected) {
+		return getchar();
+	}
+
+	return mc -> input < mc -> input_end ? (unsigned char) *(mc -> input++) : -1;
+}
+
+
+/**
+ * machine_putchar function writes an output character of a machine ('prn').
+ *
+ * @param mc - a pointer to the machine.
+ * @param c - the character.
+ */
+void machine_putchar(machine_ptr mc, int c)
+{
+	char* temp;
+
+	if(!mc -> redirected) {
+		putchar(c);
+		return;
+	}
+
+	if(mc -> output_len == mc -> output_size) {
+		temp = realloc(mc -> output, mc -> output_size == 0 ? MACHINE_OUTPUT_INITIAL_SIZE : mc -> output_size * 2);
+
+		/* verify if realloc worked as expected */
+		if(temp == NULL)
+		{
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+
+		mc -> output = temp;
+		mc -> output_size = mc -> output_size == 0 ? MACHINE_OUTPUT_INITIAL_SIZE : mc -> output_size * 2;
+	}
+
+	mc -> output[mc -> output_len++] = c;
+}
@@ -0,0 +1,205 @@
+#ifndef MACHINE_H
+#define MACHINE_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "line_details.h"	/* for ops and addressing_type enums */
+#include "object_module.h"
+#include "isa.h"
+#define REGISTERS_NUM ISA_REGISTERS_NUM
+#define MAX_STACK_DEPTH 1024	/* the number of nested 'jsr' calls */
+#define WORD_MASK ISA_WORD_MASK
+#define SIGN_BIT ISA_SIGN_BIT
+#define NO_STEP_LIMIT -1L
+#define MACHINE_OUTPUT_INITIAL_SIZE 64	/* the size of the output buffer of a redirected machine, it doubles when it's full */
+
+
+/* the results of run_machine function */
+typedef enum {MACHINE_STOPPED, MACHINE_STEP_LIMIT, MACHINE_ERROR} machine_status;
+
+
+/* a struct that represents an instruction decoded ahead of execution. Every address of the code is decoded (operand words too, they are never
+ * executed unless a jump lands on them), so the simulator never looks at the bits of a word while running */
+typedef struct decoded_instruction {
+	ops op;	/* no_op if the word is not a valid instruction */
+	int length;	/* the number of words of the instruction */
+	addressing_type src_mode;
+	addressing_type dest_mode;
+	int src;	/* immediate - the value, direct / relative - the address, register - the number of the register */
+	int dest;	/* like src */
+} decoded_instruction;
+
+
+/* a pointer to struct profile (see 'profiler.h') */
+typedef struct profile* profile_ptr;
+
+/* a pointer to struct trace (see 'trace.h') */
+typedef struct trace* trace_ptr;
+
+
+/* a pointer to struct machine */
+typedef struct machine* machine_ptr;
+
+/* a struct that represents the state of the simulated machine */
+typedef struct machine {
+	int memory[MEMORY_SIZE];
+	decoded_instruction code[MEMORY_SIZE];	/* the decoded instruction at every address of the code */
+	int regs[REGISTERS_NUM];
+	int stack[MAX_STACK_DEPTH];	/* the return addresses of 'jsr' */
+	int sp;	/* the number of addresses in the stack */
+	int pc;
+	int zero;	/* the zero flag, set by 'cmp' */
+	int code_end;	/* the address after the last code word */
+	long executed;	/* the number of instructions executed */
+	long code_writes;	/* the number of stores to the code, so translated code (see 'block_cache.h') knows when it's stale */
+	int last_code_write;	/* the address of the last store to the code */
+	const char* error;	/* the description of the error if run_machine function returned MACHINE_ERROR */
+	int redirected;	/* 1 if 'red' reads from input and 'prn' writes to output, otherwise the standard input / output are used */
+	const char* input;	/* the next input character */
+	const char* input_end;
+	char* output;	/* allocated by machine_putchar function, the caller frees it */
+	int output_len;
+	int output_size;
+	profile_ptr prof;	/* the profile of the execution, NULL if it's not profiled */
+	trace_ptr trace;	/* the trace of the execution, NULL if it's not traced */
+} machine;
+
+
+/**
+ * create_machine function creates a machine and loads a module into its memory at FIRST_ADDRESS (code first, then data, like the '.ob' file),
+ * then decodes its code. The module must be linked: images with external ('E') words are not loaded.
+ * Errors are reported with link_error function.
+ *
+ * @param m - a pointer to the module.
+ * @return - a pointer to the machine, or NULL if the module can't be loaded.
+ */
+machine_ptr create_machine(om_ptr m);
+
+
+/**
+ * check_image function checks whether a module can be loaded into a machine: it must fit in the memory and it must be linked.
+ * Errors are reported with link_error function.
+ *
+ * @param m - a pointer to the module.
+ * @return - 1 if the module can be loaded, otherwise 0 is returned.
+ */
+int check_image(om_ptr m);
+
+
+/**
+ * load_machine function resets a machine (keeping its output buffer) and loads a module into its memory, so one machine can run many images.
+ * The module must be checked with check_image function first.
+ *
+ * @param mc - a pointer to the machine.
+ * @param m - a pointer to the module.
+ */
+void load_machine(machine_ptr mc, om_ptr m);
+
+
+/**
+ * run_machine function executes instructions from the current pc until 'stop', an error or the step limit.
+ *
+ * @param mc - a pointer to the machine.
+ * @param max_steps - the maximum number of instructions to execute, or NO_STEP_LIMIT.
+ * @return - MACHINE_STOPPED if 'stop' was executed, MACHINE_STEP_LIMIT if the step limit was reached, MACHINE_ERROR if an instruction could not
+ *           be executed (mc -> error describes it and mc -> pc is its address).
+ */
+machine_status run_machine(machine_ptr mc, long max_steps);
+
+
+/**
+ * read_operand function returns the value of a decoded operand.
+ *
+ * @param mc - a pointer to the machine.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand (see decoded_instruction struct).
+ * @return - the value of the operand (12 bits).
+ */
+int read_operand(machine_ptr mc, addressing_type mode, int operand);
+
+
+/**
+ * write_operand function stores a value in the register / memory word a decoded operand refers to.
+ *
+ * @param mc - a pointer to the machine.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand (see decoded_instruction struct).
+ * @param val - the value, only its 12 low bits are stored.
+ * @return - 1 if the value was stored, 0 if the operand can't be written (an immediate operand).
+ */
+int write_operand(machine_ptr mc, addressing_type mode, int operand, int val);
+
+
+/**
+ * jump_target function returns the address a jump operand refers to ('jmp', 'bne' and 'jsr').
+ *
+ * @param mc - a pointer to the machine.
+ * @param mode - the addressing type of the operand.
+ * @param operand - the decoded operand (see decoded_instruction struct).
+ * @return - the address.
+ */
+int jump_target(machine_ptr mc, addressing_type mode, int operand);
+
+
+/**
+ * predecode function decodes the instruction that starts at an address of the code.
+ *
+ * @param mc - a pointer to the machine.
+ * @param addr - the address.
+ */
+void predecode(machine_ptr mc, int addr);
+
+
+/**
+ * decode_operand function decodes an operand word.
+ *
+ * @param mode - the addressing type of the operand.
+ * @param word - the operand word.
+ * @param addr - the address of the operand word (relative operands are relative to it).
+ * @param res - an address of an integer where to store the decoded operand (see decoded_instruction struct).
+ * @return - 1 if the operand is valid (see isa_decode_operand function in 'isa.h', and a relative operand must refer to the memory), otherwise
+ *           0 is returned.
+ */
+int decode_operand(addressing_type mode, int word, int addr, int* res);
+
+
+/**
+ * writes_operand function checks whether an operation writes to its destination operand.
+ *
+ * @param op - the operation.
+ * @return - 1 if the operation writes to its destination operand, otherwise 0 is returned.
+ */
+int writes_operand(ops op);
+
+
+/**
+ * store_word function writes a word to the memory. If the word is in the code, the instructions that may contain it are decoded again.
+ *
+ * @param mc - a pointer to the machine.
+ * @param addr - the address (must be a valid address).
+ * @param val - the value.
+ */
+void store_word(machine_ptr mc, int addr, int val);
+
+
+/**
+ * machine_getchar function reads the next input character of a machine ('red'): from its input if it's redirected, otherwise from the
+ * standard input.
+ *
+ * @param mc - a pointer to the machine.
+ * @return - the character, or -1 at the end of the input.
+ */
+int machine_getchar(machine_ptr mc);
+
+
+/**
+ * machine_putchar function writes an output character of a machine ('prn'): to its output buffer if it's redirected, otherwise to the
+ * standard output.
+ *
+ * @param mc - a pointer to the machine.
+ * @param c - the character.
+ */
+void machine_putchar(machine_ptr mc, int c);
+
+
+#endif
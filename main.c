@@ -21,62 +21,141 @@ symb_ptr curr_symb = NULL;
 char* fn = NULL;
 FILE* fp = NULL;
 
+/* command line options */
+static int extended_mode = 0;
+static int am_file_requested = 0;
+static int dependency_file_requested = 0;
+static int relocation_file_requested = 0;
+static int parallel_ob_requested = 0;
+static int pipeline_requested = 0;
+static int benchmark_mode = 0;
+static const char* link_output = NULL;	/* the name of the linked image in link mode (LINK_MODE_OPTION), NULL if link mode is off */
+static const char* test_directory = NULL;	/* the directory of the tests in test mode (TEST_MODE_OPTION), NULL if test mode is off */
+
+/* the modules assembled in link mode, in the order of the source files */
+static om_ptr head_program = NULL;
+static om_ptr curr_program = NULL;
+static int program_errors = 0;	/* the number of source files with errors in link mode */
+
 
 /* main function */
 int main(int argc, char* argv[])
 {
 	/* variable definitions */
-	int handler_res;
+	char** sources;
+	int sources_num;
+	int failed;
 	int i;
 
 	/* variable initializations */
-	handler_res = 0;
+	failed = 0;
 	i = 1;
 
 
-	/* get files from terminal input loop */
+	/* get options from terminal input loop */
 	while(argv[i]) {
-		fn = malloc(strlen(argv[i]) + 4); /* +3 for .as extension +1 for null string terminator */
-
-		if(fn == NULL) {
-			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
-			emergency_free_mem();
-			exit(EXIT_FAILURE);
+		if(argv[i][0] == '-') {
+			if(strcmp(argv[i], EXTENDED_MODE_OPTION) == 0) {
+				extended_mode = 1;
+			}
+			else if(strcmp(argv[i], AM_FILE_OPTION) == 0) {
+				am_file_requested = 1;
+			}
+			else if(strcmp(argv[i], DEPENDENCY_FILE_OPTION) == 0) {
+				dependency_file_requested = 1;
+			}
+			else if(strcmp(argv[i], RELOCATION_FILE_OPTION) == 0) {
+				relocation_file_requested = 1;
+			}
+			else if(strcmp(argv[i], PARALLEL_OB_OPTION) == 0) {
+				parallel_ob_requested = 1;
+			}
+			else if(strcmp(argv[i], PIPELINE_OPTION) == 0) {
+				pipeline_requested = 1;
+			}
+			else if(strcmp(argv[i], BENCHMARK_OPTION) == 0) {
+				benchmark_mode = 1;
+			}
+			else if(strcmp(argv[i], LINK_MODE_OPTION) == 0) {
+				if(argv[i + 1] == NULL || argv[i + 1][0] == '-') {
+					printf("Missing output name after option '%s'. Program terminated.\n", argv[i]);
+					exit(EXIT_FAILURE);
+				}
+				link_output = argv[++i];
+			}
+			else if(strcmp(argv[i], TEST_MODE_OPTION) == 0) {
+				if(argv[i + 1] == NULL || argv[i + 1][0] == '-') {
+					printf("Missing directory after option '%s'. Program terminated.\n", argv[i]);
+					exit(EXIT_FAILURE);
+				}
+				test_directory = argv[++i];
+			}
+			else {
+				printf("Unknown option '%s'. Program terminated.\n", argv[i]);
+				exit(EXIT_FAILURE);
+			}
 		}
-		strcpy(fn, argv[i]);
-		strcat(fn, AS_EXTENSION);
-		fp = fopen(fn, "r");
-		if(fp == NULL) {
-			printf("File not found. Program terminated.\n");
-			emergency_free_mem();
+		i++;
+	}
+	i = 1;
+
+	if(is_link_mode() && is_test_mode()) {
+		printf("Options '%s' and '%s' can't be used together. Program terminated.\n", LINK_MODE_OPTION, TEST_MODE_OPTION);
+		exit(EXIT_FAILURE);
+	}
+
+	if(is_benchmark_mode() && (is_link_mode() || is_test_mode())) {
+		printf("Option '%s' can't be used with '%s' or '%s'. Program terminated.\n", BENCHMARK_OPTION, LINK_MODE_OPTION, TEST_MODE_OPTION);
+		exit(EXIT_FAILURE);
+	}
+
+	/* test mode: every source file of the directory is a test */
+	if(is_test_mode()) {
+		sources = find_test_sources(test_directory, &sources_num);
+		if(sources == NULL) {
+			printf("Directory '%s' not found. Program terminated.\n", test_directory);
 			exit(EXIT_FAILURE);
 		}
 
-		if(strlen(argv[i]) > MAX_FILE_NAME_LENGTH) {
-			error_controller(0, FILE_NAME_LONGER_THAN_ALLOWED, fn);
+		for(i = 0; i < sources_num; i++) {
+			add_test_case(sources[i], assemble_file(sources[i]) ? curr_program : NULL);
 		}
+		free_test_sources(sources, sources_num);
+		free_include_cache();
 
-		handler_res = file_processor(&fp, fn);
+		failed = run_tests();
+		free_test_cases();
+		free_object_modules(&head_program);
+		head_program = NULL;
+		curr_program = NULL;
 
-		if(!handler_res || were_errors()) {
-			print_errors(head_err);
-		}
-		else {
-			putchar('\n');
-			putchar('\n');
-			printf("File '%s' has been assembled successfully!\n", fn);
+		return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+
+	/* get files from terminal input loop */
+	while(argv[i]) {
+		if(argv[i][0] == '-') {	/* options were handled above */
+			if(strcmp(argv[i], LINK_MODE_OPTION) == 0) {	/* skip the name of the linked image too */
+				i++;
+			}
+			i++;
+			continue;
 		}
 
-		fclose(fp);
-		free(fn);
-		fn = NULL;
-		free_symb_list(&head_symb);
-		head_symb = NULL;
-		free_error_nodes(&head_err);
-		head_err = NULL;
+		if(is_benchmark_mode()) {
+			benchmark_file(argv[i]);
+		}
+		else assemble_file(argv[i]);
 		i++;
 	}
 
+	free_include_cache();
+
+	if(is_link_mode()) {
+		link_program();
+	}
+
 	putchar('\n');
 	putchar('\n');
 	puts("***********************************************************");
@@ -90,6 +169,130 @@ int main(int argc, char* argv[])
 }
 
 
+/**
+ * assemble_file function assembles one source file and prints its errors. In link mode and in test mode the module of the file is added to the
+ * end of the list of modules (see add_program_module function).
+ *
+ * @param name - the name of the source file (without extension).
+ * @return - 1 if the file was assembled without errors, otherwise 0 is returned.
+ */
+int assemble_file(const char* name)
+{
+	const char* base;
+	int handler_res;
+	int assembled;
+
+	open_source_file(name);
+
+	base = is_test_mode() ? strrchr(name, '/') : NULL;	/* the directory of a test is not part of its name */
+	base = base == NULL ? name : base + 1;
+	if(strlen(base) > MAX_FILE_NAME_LENGTH) {
+		error_controller(0, FILE_NAME_LONGER_THAN_ALLOWED, fn);
+	}
+
+	handler_res = file_processor(&fp, fn);
+	assembled = handler_res && !were_errors();
+
+	if(!assembled) {
+		print_errors(head_err);
+		program_errors++;
+	}
+	else {
+		putchar('\n');
+		putchar('\n');
+		printf("File '%s' has been assembled successfully!\n", fn);
+	}
+
+	close_source_file();
+
+	return assembled;
+}
+
+
+/**
+ * benchmark_file function assembles a source file in memory with the serial loop and with the pipeline, and prints the fastest times.
+ *
+ * @param name - the name of the source file (without extension).
+ */
+void benchmark_file(const char* name)
+{
+	double best[2];	/* the fastest time of the serial loop and of the pipeline */
+	double start;
+	double seconds;
+	int requested;
+	int round;
+	int mode;
+
+	requested = pipeline_requested;
+
+	for(mode = 0; mode < 2; mode++)
+	{
+		pipeline_requested = mode;
+		for(round = 0; round < BENCHMARK_ROUNDS; round++)
+		{
+			open_source_file(name);
+			start = wall_clock();
+			file_processor(&fp, fn);
+			seconds = wall_clock() - start;
+			close_source_file();
+
+			if(round == 0 || seconds < best[mode]) {
+				best[mode] = seconds;
+			}
+		}
+	}
+
+	pipeline_requested = requested;
+
+	printf("%s%s: serial loop %.3f ms, pipeline %.3f ms", name, AS_EXTENSION, best[0] * 1000, best[1] * 1000);
+	if(best[1] > 0) {
+		printf(", speedup %.2f", best[0] / best[1]);
+	}
+	putchar('\n');
+}
+
+
+/**
+ * open_source_file function opens a source file for assembling.
+ *
+ * @param name - the name of the source file (without extension).
+ */
+void open_source_file(const char* name)
+{
+	fn = malloc(strlen(name) + 4); /* +3 for .as extension +1 for null string terminator */
+
+	if(fn == NULL) {
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+	strcpy(fn, name);
+	strcat(fn, AS_EXTENSION);
+	fp = fopen(fn, "r");
+	if(fp == NULL) {
+		printf("File not found. Program terminated.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+}
+
+
+/**
+ * close_source_file function closes the source file and frees its symbol table and errors.
+ */
+void close_source_file()
+{
+	fclose(fp);
+	fp = NULL;
+	free(fn);
+	fn = NULL;
+	free_symb_list(&head_symb);
+	head_symb = NULL;
+	free_error_nodes(&head_err);
+	head_err = NULL;
+}
+
+
 /**
  * error_controller function triggers 'error.c' file to create and insert an error to the errors list.
  *
@@ -152,16 +355,31 @@ int is_extern_lbl(char* lbl)
 
 
 /**
- * create_ent_file function creates an output entry file.
- * This function must be used ONLY if no errors were found during the execution of the 'assembler'.
+ * create_output_files function creates the '.ob', '.ent' and '.ext' files of the file currently processed, at the same time.
  *
- * @param fn - the name of the file of which the output file is being created.
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param fn - the name of the file of which the output files are being created.
+ * @param IC - the total lines of code were processed.
+ * @param DC - the total lines of data were processed.
  */
-void create_ent_file(const char* fn)
+void create_output_files(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, const char* fn, int IC, int DC)
 {
-    if(was_entry_label_as_operand(head_symb)) {	/* make sure entry label/s appeared before creating entries file */
-        create_entry_file(head_symb, fn);
-    }
+	emit_output_files(head_mcl_node, head_mdl_node, head_symb, fn, IC, DC);
+}
+
+
+/**
+ * resolve_operands function gives every label operand of the file currently processed the address of its label, on a pool of threads.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param operands - a pointer to where to store the array of the operands.
+ * @param errors - a pointer to where to store the array of the errors of the operands.
+ * @return - the number of operands.
+ */
+long resolve_operands(mcl_ptr head_mcl_node, mcl_ptr** operands, ERR_VALUE** errors)
+{
+	return resolve_label_operands(head_mcl_node, head_symb, operands, errors);
 }
 
 
@@ -220,6 +438,160 @@ char* get_file_name()
 }
 
 
+/**
+ * is_extended_mode function checks whether the 'assembler' runs in extended mode (EXTENDED_MODE_OPTION).
+ *
+ * @return - 1 if extended mode is on, otherwise 0 is returned.
+ */
+int is_extended_mode()
+{
+	return extended_mode;
+}
+
+
+/**
+ * is_am_file_requested function checks whether the source after macro expansion should be written to a '.am' file (AM_FILE_OPTION).
+ *
+ * @return - 1 if the '.am' file was requested, otherwise 0 is returned.
+ */
+int is_am_file_requested()
+{
+	return am_file_requested;
+}
+
+
+/**
+ * is_dependency_file_requested function checks whether a '.d' dependency file should be written for every source file (DEPENDENCY_FILE_OPTION).
+ *
+ * @return - 1 if the '.d' file was requested, otherwise 0 is returned.
+ */
+int is_dependency_file_requested()
+{
+	return dependency_file_requested;
+}
+
+
+/**
+ * is_relocation_file_requested function checks whether a '.rel' relocation file should be written for every source file (RELOCATION_FILE_OPTION).
+ *
+ * @return - 1 if the '.rel' file was requested, otherwise 0 is returned.
+ */
+int is_relocation_file_requested()
+{
+	return relocation_file_requested;
+}
+
+
+/**
+ * is_parallel_ob_requested function checks whether the '.ob' file should be written on a pool of threads (PARALLEL_OB_OPTION).
+ *
+ * @return - 1 if the parallel writer was requested, otherwise 0 is returned.
+ */
+int is_parallel_ob_requested()
+{
+	return parallel_ob_requested;
+}
+
+
+/**
+ * is_link_mode function checks whether the source files are assembled in memory and linked into one image (LINK_MODE_OPTION).
+ *
+ * @return - 1 if link mode is on, otherwise 0 is returned.
+ */
+int is_link_mode()
+{
+	return link_output != NULL;
+}
+
+
+/**
+ * is_pipeline_requested function checks whether the lines of the source files should be read and parsed on threads of their own
+ * (PIPELINE_OPTION).
+ *
+ * @return - 1 if the pipeline was requested, otherwise 0 is returned.
+ */
+int is_pipeline_requested()
+{
+	return pipeline_requested;
+}
+
+
+/**
+ * is_benchmark_mode function checks whether the source files are assembled in memory to time the serial loop and the pipeline
+ * (BENCHMARK_OPTION).
+ *
+ * @return - 1 if benchmark mode is on, otherwise 0 is returned.
+ */
+int is_benchmark_mode()
+{
+	return benchmark_mode;
+}
+
+
+/**
+ * is_test_mode function checks whether the source files of a directory are assembled in memory and executed as tests (TEST_MODE_OPTION).
+ *
+ * @return - 1 if test mode is on, otherwise 0 is returned.
+ */
+int is_test_mode()
+{
+	return test_directory != NULL;
+}
+
+
+/**
+ * add_program_module function creates a module from the code and data image and the symbol table of the file currently processed, and adds it
+ * to the end of the list of modules that are linked after all files were assembled.
+ * This function must be used ONLY if no errors were found during the execution of the 'assembler'.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param ic - the number of code words.
+ * @param dc - the number of data words.
+ */
+void add_program_module(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, int ic, int dc)
+{
+	om_ptr m;
+
+	m = create_object_module(fn);
+	m -> name[strlen(m -> name) - strlen(AS_EXTENSION)] = '\0';	/* remove .as extension */
+	m -> ic = ic;
+	m -> dc = dc;
+	m -> assembled = 1;
+
+	if(curr_program == NULL) {	/* added before the allocations below, so emergency_free_mem frees it */
+		head_program = m;
+	}
+	else curr_program -> next = m;
+	curr_program = m;
+
+	alloc_module_words(m);
+	fill_image_words(head_mcl_node, head_mdl_node, m -> words, m -> tags);
+	add_entry_refs(head_symb, &(m -> entries));
+	add_extern_refs(head_mcl_node, &(m -> externs));
+}
+
+
+/**
+ * link_program function links the modules assembled in link mode into '<name>.ob'. Undefined and duplicate entry / external labels are reported
+ * per module, at the lines of the source files. Nothing is linked if errors were found in any source file.
+ */
+void link_program()
+{
+	if(program_errors) {
+		printf("\nThe image '%s%s' was not linked because errors were found.\n", link_output, OB_EXTENSION);
+	}
+	else if(head_program != NULL) {
+		link_modules(head_program, NULL, link_output);
+	}
+
+	free_global_table();
+	free_object_modules(&head_program);
+	head_program = NULL;
+	curr_program = NULL;
+}
+
+
 /**
  * emergency_free_mem function frees all memory allocated during the execution. This function is called ONLY if any memory allocation fails.
  * It frees all the memory allocated until first memory allocation failure.
@@ -239,4 +611,10 @@ void emergency_free_mem()
 		fclose(fp);
 	}
 	handler_free_mem();
+	free_include_cache();
+	free_global_table();
+	free_test_cases();
+	free_object_modules(&head_program);
+	head_program = NULL;
+	curr_program = NULL;
 }
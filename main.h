@@ -1,6 +1,11 @@
 #ifndef MAIN_H
 #define MAIN_H
 #include <stdio.h>
+#include "link.h"	/* for link_modules function, included first since 'parser.h' defines single letter macros */
+#include "tester.h"	/* for test mode */
+#include "timing.h"	/* for wall_clock function, see benchmark_file function */
+#include "output_files.h"	/* for emit_output_files function */
+#include "label_resolver.h"	/* for resolve_label_operands function */
 #include "errors.h"
 #include "symbol_table.h"
 #include "handler.h"
@@ -8,6 +13,58 @@
 #include "memory_image.h"
 #include "main_functions.h"
 #define AS_EXTENSION ".as"
+#define EXTENDED_MODE_OPTION "-x"	/* unlimited line length, .data and .string payloads are streamed to the data image */
+#define AM_FILE_OPTION "-m"	/* write the source after macro expansion to a .am file */
+#define DEPENDENCY_FILE_OPTION "-d"	/* write a make rule of the files each source file depends on to a .d file */
+#define RELOCATION_FILE_OPTION "-r"	/* write the addresses of all relocatable and external words to a .rel file */
+#define PARALLEL_OB_OPTION "-p"	/* write the .ob file with write_object_file_mapped function (see 'ob_writer.h') */
+#define LINK_MODE_OPTION "-l"	/* followed by a name: assemble all source files in memory and link them into <name>.ob */
+#define TEST_MODE_OPTION "-T"	/* followed by a directory: assemble every source file of the directory in memory, execute it and compare its
+				 * output with the <name>.out file (see 'tester.h') */
+#define PIPELINE_OPTION "-P"	/* read and parse the lines of the source files on threads of their own while they're processed (see 'pipeline.h') */
+#define BENCHMARK_OPTION "-b"	/* assemble every source file in memory with the serial loop and with the pipeline, and print the fastest times */
+#define BENCHMARK_ROUNDS 5	/* the number of times a source file is assembled each way by benchmark_file function */
+
+
+/**
+ * assemble_file function assembles one source file and prints its errors. In link mode and in test mode the module of the file is added to the
+ * end of the list of modules (see add_program_module function).
+ *
+ * @param name - the name of the source file (without extension).
+ * @return - 1 if the file was assembled without errors, otherwise 0 is returned.
+ */
+int assemble_file(const char* name);
+
+
+/**
+ * benchmark_file function assembles a source file in memory (nothing is written) BENCHMARK_ROUNDS times with the serial loop of
+ * file_processor function and BENCHMARK_ROUNDS times with the pipeline (PIPELINE_OPTION), and prints the fastest time of each and the speedup.
+ *
+ * @param name - the name of the source file (without extension).
+ */
+void benchmark_file(const char* name);
+
+
+/**
+ * open_source_file function opens a source file for assembling: its name is stored in 'fn' and the file in 'fp'. The program is terminated if
+ * the file is not found.
+ *
+ * @param name - the name of the source file (without extension).
+ */
+void open_source_file(const char* name);
+
+
+/**
+ * close_source_file function closes the source file opened by open_source_file function and frees its symbol table and errors.
+ */
+void close_source_file();
+
+
+/**
+ * link_program function links the modules assembled in link mode into one image. Undefined and duplicate entry / external labels are reported
+ * per module, at the lines of the source files. Nothing is linked if errors were found in any source file.
+ */
+void link_program();
 
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef MAIN_FUNCTIONS_H
 #define MAIN_FUNCTIONS_H
 #include "line_details.h" /* for attribute and ERR_VALUE enums */
+#include "memory_image.h"	/* for code and data image structs */
 
 
 /**
@@ -55,12 +56,30 @@ void error_controller(int ln, ERR_VALUE err, const char* file_name);
 
 
 /**
- * create_ent_file function creates an output entry file.
+ * create_output_files function creates the '.ob', '.ent' and '.ext' files of the file currently processed (the ones it needs), each on a
+ * thread of its own (see emit_output_files function in 'output_files.h').
  * This function must be used ONLY if no errors were found during the execution of the 'assembler'.
  *
- * @param fn - the name of the file of which the output file is being created.
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param fn - the name of the file of which the output files are being created.
+ * @param IC - the total lines of code were processed.
+ * @param DC - the total lines of data were processed.
  */
-void create_ent_file(const char* fn);
+void create_output_files(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, const char* fn, int IC, int DC);
+
+
+/**
+ * resolve_operands function gives every direct and relative operand of the file currently processed the address of its label, on a pool of
+ * threads (see resolve_label_operands function in 'label_resolver.h'). Nothing is reported: the error of every operand is returned in the
+ * order of the code image.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param operands - a pointer to where to store the array of the operands (must be freed).
+ * @param errors - a pointer to where to store the array of the errors of the operands (must be freed).
+ * @return - the number of operands.
+ */
+long resolve_operands(mcl_ptr head_mcl_node, mcl_ptr** operands, ERR_VALUE** errors);
 
 
 /**
@@ -87,4 +106,95 @@ void check_entry_labels();
 char* get_file_name();
 
 
+/**
+ * is_extended_mode function checks whether the 'assembler' runs in extended mode.
+ * In extended mode lines have no length limit and '.data' / '.string' payloads of any length are streamed into the data image.
+ * In standard mode the 80 characters line length check applies.
+ *
+ * @return - 1 if extended mode is on, otherwise 0 is returned.
+ */
+int is_extended_mode();
+
+
+/**
+ * is_am_file_requested function checks whether the source after macro expansion should be written to a '.am' file.
+ *
+ * @return - 1 if the '.am' file was requested, otherwise 0 is returned.
+ */
+int is_am_file_requested();
+
+
+/**
+ * is_dependency_file_requested function checks whether a '.d' dependency file should be written for every source file.
+ * The '.d' file lists the source file and every file it includes or embeds (see 'dependency.h').
+ *
+ * @return - 1 if the '.d' file was requested, otherwise 0 is returned.
+ */
+int is_dependency_file_requested();
+
+
+/**
+ * is_relocation_file_requested function checks whether a '.rel' relocation file should be written for every source file (RELOCATION_FILE_OPTION).
+ *
+ * @return - 1 if the '.rel' file was requested, otherwise 0 is returned.
+ */
+int is_relocation_file_requested();
+
+
+/**
+ * is_parallel_ob_requested function checks whether the '.ob' file should be written on a pool of threads (PARALLEL_OB_OPTION), see
+ * write_object_file_mapped function in 'ob_writer.h'.
+ *
+ * @return - 1 if the parallel writer was requested, otherwise 0 is returned.
+ */
+int is_parallel_ob_requested();
+
+
+/**
+ * is_pipeline_requested function checks whether the lines of the source files should be read and parsed on threads of their own while they're
+ * processed (PIPELINE_OPTION), see start_pipeline function in 'pipeline.h'.
+ *
+ * @return - 1 if the pipeline was requested, otherwise 0 is returned.
+ */
+int is_pipeline_requested();
+
+
+/**
+ * is_benchmark_mode function checks whether the source files are assembled in memory to time the serial loop and the pipeline, without
+ * writing any file (BENCHMARK_OPTION).
+ *
+ * @return - 1 if benchmark mode is on, otherwise 0 is returned.
+ */
+int is_benchmark_mode();
+
+
+/**
+ * is_link_mode function checks whether the source files are assembled in memory and linked into one image (LINK_MODE_OPTION).
+ *
+ * @return - 1 if link mode is on, otherwise 0 is returned.
+ */
+int is_link_mode();
+
+
+/**
+ * is_test_mode function checks whether the source files of a directory are assembled in memory and executed as tests (TEST_MODE_OPTION).
+ *
+ * @return - 1 if test mode is on, otherwise 0 is returned.
+ */
+int is_test_mode();
+
+
+/**
+ * add_program_module function creates a module from the code and data image and the symbol table of the file currently processed, and adds it
+ * to the list of modules that are linked after all files were assembled (link mode) or executed as tests (test mode). No '.ob', '.ent' and '.ext' files are written.
+ * This function must be used ONLY if no errors were found during the execution of the 'assembler'.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param ic - the number of code words.
+ * @param dc - the number of data words.
+ */
+void add_program_module(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, int ic, int dc);
+
+
 #endif /* MAIN_FUNCTIONS_H */
@@ -5,6 +5,12 @@
  * Assembler Project
  */
 
+#define _POSIX_C_SOURCE 200112L	/* for mmap */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "memory_image.h"
 #include "emergency_free_mem.h"
 
@@ -22,42 +28,6 @@ void insert_memory_code_line(mcl_ptr * head, mcl_ptr * curr, int line_num, enum
 {
 	mcl_ptr p = NULL;
 
-	/* Array of all operations values and their funct values */
-	static struct opcodes {
-		ops op;
-		char* funct;
-		char* opcode;
-	} opcode_table[OP_TABLE_LINES] = {
-
-	{mov, "0000", "0000"},
-	{cmp, "0000", "0001"},
-	{add, "1010", "0010"},
-	{sub, "1011", "0010"},
-	{lea, "0000", "0100"},
-	{clr, "1010", "0101"},
-	{not, "1011", "0101"},
-	{inc, "1100", "0101"},
-	{dec, "1101", "0101"},
-	{jmp, "1010", "1001"},
-	{bne, "1011", "1001"},
-	{jsr, "1100", "1001"},
-	{red, "0000", "1100"},
-	{prn, "0000", "1101"},
-	{rts, "0000", "1110"},
-	{stop, "0000", "1111"}
-
-	};
-
-	static struct addressing_types_binary {
-		addressing_type at;
-		char* binary_representation;
-	} addressing_types_binary_table[NUMBER_OF_ADDRESSING_TYPES] = {
-		{immediate, "00"},
-		{direct, "01"},
-		{relative, "10"},
-		{regis_direct, "11"}
-	};
-
 	p = malloc(sizeof(memory_code_line));
 
 	/* verify if malloc worked as expected */
@@ -103,10 +73,10 @@ void insert_memory_code_line(mcl_ptr * head, mcl_ptr * curr, int line_num, enum
 
 	/* if line is an instruction line */
 	if(t == line_type_bits) {
-		strcpy(p -> ins -> opcode, opcode_table[get_op()].opcode);
-		strcpy(p -> ins -> funct, opcode_table[get_op()].funct);
-		strcpy(p -> ins -> src_addr, addressing_types_binary_table[get_src_type()].binary_representation);
-		strcpy(p -> ins -> dest_addr, addressing_types_binary_table[get_dest_type()].binary_representation);
+		isa_binary(isa_operation_of(get_op()) -> opcode, OPCODE_SIZE, p -> ins -> opcode);
+		isa_binary(isa_operation_of(get_op()) -> funct, FUNCT_SIZE, p -> ins -> funct);
+		isa_binary(get_src_type(), SRC_OPERAND_SIZE, p -> ins -> src_addr);	/* the code of an addressing type is its addressing_type value */
+		isa_binary(get_dest_type(), DEST_OPERAND_SIZE, p -> ins -> dest_addr);
 
 	}
 
@@ -146,10 +116,10 @@ void insert_memory_code_line(mcl_ptr * head, mcl_ptr * curr, int line_num, enum
 
 	/* if line is instruction line without operands */
 	else if(t == no_ops) {
-		strcpy(p -> ins -> opcode, opcode_table[get_op()].opcode);
-		strcpy(p -> ins -> funct, opcode_table[get_op()].funct);
-		strcpy(p -> ins -> src_addr, addressing_types_binary_table[immediate].binary_representation);
-		strcpy(p -> ins -> dest_addr, addressing_types_binary_table[immediate].binary_representation);
+		isa_binary(isa_operation_of(get_op()) -> opcode, OPCODE_SIZE, p -> ins -> opcode);
+		isa_binary(isa_operation_of(get_op()) -> funct, FUNCT_SIZE, p -> ins -> funct);
+		isa_binary(immediate, SRC_OPERAND_SIZE, p -> ins -> src_addr);
+		isa_binary(immediate, DEST_OPERAND_SIZE, p -> ins -> dest_addr);
 	}
 
 
@@ -209,6 +179,96 @@ void insert_memory_data_line(mdl_ptr * head, mdl_ptr * curr, int line_num, int v
 	}
 
 	sprintf(p -> mem_val, "%d", val);
+	p -> dlt = data_value;
+	p -> words = 1;
+	p -> run_val = 0;
+	p -> blob = NULL;
+	p -> memory_type = mt;
+	p -> DC = line_num;
+	p -> next = NULL;
+
+	/* if linked list is still empty */
+	if(*head == NULL)
+	{
+		(*head) = p;
+		(*curr) = p;
+	}
+	/* if linked list is not empty */
+	else
+	{
+		(*curr) -> next = p;
+		(*curr) = p;
+	}
+}
+
+
+/**
+ * insert_memory_data_blob function maps a binary file into memory and adds it to the data-image-list as one data_blob node.
+ *
+ * @param head - the pointer to the pointer that points to the data-image-head-linked-list.
+ * @param curr - the pointer to the pointer that points to the data-image-current-linked-list.
+ * @param line_num - the line number of the first word as it should appear in data (with code lines offset) memory image.
+ * @param path - the name of the binary file.
+ * @param bits - the size of the words in the file, 8 or 12.
+ * @param mt - the memory type of the words.
+ * @param max_words - the number of words left in the memory.
+ * @return - the number of words added to the data image, -1 if the file could not be opened or mapped, or -2 if it has more than max_words
+ *           words.
+ */
+int insert_memory_data_blob(mdl_ptr * head, mdl_ptr * curr, int line_num, const char* path, int bits, char mt, int max_words)
+{
+	mdl_ptr p = NULL;
+	struct stat st;
+	void* blob;
+	long max_len;	/* the size of a file of max_words words */
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if(fd == -1) {
+		return -1;
+	}
+
+	if(fstat(fd, &st) == -1) {
+		close(fd);
+		return -1;
+	}
+
+	if(st.st_size == 0) {	/* an empty file, nothing to map */
+		close(fd);
+		return 0;
+	}
+
+	max_len = (bits == 12) ? (long) max_words * 3 / 2 : (long) max_words;	/* every 3 bytes are 2 words */
+	if(max_words < 0 || st.st_size > (off_t) max_len) {	/* checked before the number of words is counted, so it can't overflow */
+		close(fd);
+		return -2;
+	}
+
+	blob = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);	/* the mapping stays valid after the file is closed */
+
+	if(blob == MAP_FAILED) {
+		return -1;
+	}
+
+	p = malloc(sizeof(memory_data_line));
+
+	/* verify if malloc worked as expected */
+	if(p == NULL)
+	{
+		munmap(blob, st.st_size);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	p -> dlt = data_blob;
+	p -> mem_val = NULL;
+	p -> blob = blob;
+	p -> blob_len = st.st_size;
+	p -> blob_bits = bits;
+	p -> run_val = 0;
+	p -> words = (bits == 12) ? (int) ((p -> blob_len * 8 + 11) / 12) : (int) p -> blob_len;
 	p -> memory_type = mt;
 	p -> DC = line_num;
 	p -> next = NULL;
@@ -225,96 +285,236 @@ void insert_memory_data_line(mdl_ptr * head, mdl_ptr * curr, int line_num, int v
 		(*curr) -> next = p;
 		(*curr) = p;
 	}
+
+	return p -> words;
 }
 
 
 /**
- * create_image_hexa_file function creates an output hexe file of both code and data image.
+ * insert_memory_data_run function adds a run of 'count' words of value 'val' to the data-image-list as one data_run node.
+ *
+ * @param head - the pointer to the pointer that points to the data-image-head-linked-list.
+ * @param curr - the pointer to the pointer that points to the data-image-current-linked-list.
+ * @param line_num - the line number of the first word as it should appear in data (with code lines offset) memory image.
+ * @param count - the number of words.
+ * @param val - the value of the words.
+ * @param mt - the memory type of the words.
+ */
+void insert_memory_data_run(mdl_ptr * head, mdl_ptr * curr, int line_num, int count, int val, char mt)
+{
+	mdl_ptr p = NULL;
+
+	if(count == 0) {	/* nothing to reserve */
+		return;
+	}
+
+	p = malloc(sizeof(memory_data_line));
+
+	/* verify if malloc worked as expected */
+	if(p == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	p -> dlt = data_run;
+	p -> mem_val = NULL;
+	p -> blob = NULL;
+	p -> words = count;
+	p -> run_val = val;
+	p -> memory_type = mt;
+	p -> DC = line_num;
+	p -> next = NULL;
+
+	/* if linked list is still empty */
+	if(*head == NULL)
+	{
+		(*head) = p;
+		(*curr) = p;
+	}
+	/* if linked list is not empty */
+	else
+	{
+		(*curr) -> next = p;
+		(*curr) = p;
+	}
+}
+
+
+/**
+ * blob_word function returns the word at index 'ind' of a data_blob line.
+ *
+ * @param node - the data_blob line.
+ * @param ind - the index of the word, from 0 to (node -> words - 1).
+ * @return - the value of the word.
+ */
+int blob_word(mdl_ptr node, int ind)
+{
+	size_t byte;
+	int next;
+
+	if(node -> blob_bits == 8) {
+		return node -> blob[ind];
+	}
+
+	byte = (size_t) ind * 12 / 8;
+	next = (byte + 1 < node -> blob_len) ? node -> blob[byte + 1] : 0;	/* last word of the file may be partial */
+
+	if(ind % 2 == 0) {	/* high 8 bits in the first byte, low 4 bits in the high half of the next byte */
+		return (node -> blob[byte] << 4) | (next >> 4);
+	}
+	else {	/* high 4 bits in the low half of the first byte, low 8 bits in the next byte */
+		return ((node -> blob[byte] & 0xF) << 8) | next;
+	}
+}
+
+
+/**
+ * write_image_hexa_file function writes the code and data image to an object file.
  *
  * @param head_mcl_node - the pointer to the code-image-head-linked-list.
  * @param head_mdl_node - the pointer to the data-image-head-linked-list.
- * @param fn - the name of the file of which the output file is being created.
- * @param IC - the total lines of code were processed. 
- * @param DC - the total lines of data were processed. 
+ * @param file_name - the name of the object file.
+ * @param IC - the total lines of code were processed.
+ * @param DC - the total lines of data were processed.
+ * @return - 1 if the file was written, 0 if it could not be created.
  */
-void create_image_hexa_file(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, const char* fn, int IC, int DC)
+int write_image_hexa_file(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, const char* file_name, int IC, int DC)
 {
-	char file_name[MAX_FILE_NAME_LENGTH + 4];	/* +1 for string terminator char, +3 for .ob extension */
-	char temp[WORD_IN_MACHINE + 1];	/* +1 for string terminator char */
 	FILE* fp = NULL;
-	int res;
-
-    if(head_mcl_node == NULL && head_mdl_node == NULL) {    /* an empty file */
-        return;
-    }
-    
-	strcpy(file_name, fn);	
-	file_name[strlen(file_name) - 3] = '\0'; /* remove .as extension */
-	strcat(file_name, OB_EXTENSION);	/* add .ob extension */
+	int i;
 
 	fp = fopen(file_name, "w+");
 
 	if(fp == NULL) {
-		printf("Could not create object file.\n");
-		emergency_free_mem();
-		exit(EXIT_FAILURE);
+		return 0;
 	}
 
 	fprintf(fp, "%d %d\n", IC, DC);	/* print IC and DC in top of the file */
 
 	while(head_mcl_node != NULL)
 	{
-		if(head_mcl_node -> mlt == line_type_bits || head_mcl_node -> mlt == no_ops) {
-		strcpy(temp, head_mcl_node -> ins -> opcode);
-		strcat(temp, head_mcl_node -> ins -> funct);
-		strcat(temp, head_mcl_node -> ins -> src_addr);
-		strcat(temp, head_mcl_node -> ins -> dest_addr);
-		res = (int) strtol(temp, NULL, 2);
-
-		fprintf(fp, "%04d %03X %c\n",head_mcl_node -> IC, res, head_mcl_node -> memory_type);
-		}
-		else if(head_mcl_node -> mlt == line_type_number || head_mcl_node -> mlt == direct_operand ||
-					head_mcl_node -> mlt == relative_operand) {
-			res = (int) strtol(head_mcl_node -> mem_val, NULL, 10);
-			fprintf(fp, "%04d %03X %c\n",head_mcl_node -> IC, (res & 0xFFF), head_mcl_node -> memory_type);
-		}
+		fprintf(fp, "%04d %03X %c\n",head_mcl_node -> IC, code_word_value(head_mcl_node), head_mcl_node -> memory_type);
 		head_mcl_node = head_mcl_node -> next;
 	}
 
 	while(head_mdl_node != NULL)
 	{
-		res = (int) strtol(head_mdl_node -> mem_val, NULL, 10);
-		fprintf(fp, "%04d %03X %c\n",head_mdl_node -> DC, (res & 0xFFF), head_mdl_node -> memory_type);
+		for(i = 0; i < head_mdl_node -> words; i++) {
+			fprintf(fp, "%04d %03X %c\n",head_mdl_node -> DC + i, data_word_value(head_mdl_node, i), head_mdl_node -> memory_type);
+		}
 		head_mdl_node = head_mdl_node -> next;
 	}
 
-	printf("\nFile '%s' has been created successfully!", file_name);
-
 	fclose(fp);	
+	return 1;
+}
+
+
+/**
+ * code_word_value function returns the value of the word of a code image node.
+ *
+ * @param node - the code image node.
+ * @return - the value of the word (12 bits).
+ */
+int code_word_value(mcl_ptr node)
+{
+	char temp[WORD_IN_MACHINE + 1];	/* +1 for string terminator char */
+
+	if(node -> mlt == line_type_bits || node -> mlt == no_ops) {
+		strcpy(temp, node -> ins -> opcode);
+		strcat(temp, node -> ins -> funct);
+		strcat(temp, node -> ins -> src_addr);
+		strcat(temp, node -> ins -> dest_addr);
+		return (int) strtol(temp, NULL, 2);
+	}
+
+	return (int) strtol(node -> mem_val, NULL, 10) & 0xFFF;
+}
+
+
+/**
+ * data_word_value function returns the value of a word of a data image node.
+ *
+ * @param node - the data image node.
+ * @param ind - the index of the word in the node, from 0 to (node -> words - 1).
+ * @return - the value of the word (12 bits).
+ */
+int data_word_value(mdl_ptr node, int ind)
+{
+	if(node -> dlt == data_blob) {
+		return blob_word(node, ind) & 0xFFF;
+	}
+	else if(node -> dlt == data_run) {
+		return node -> run_val & 0xFFF;
+	}
+
+	return (int) strtol(node -> mem_val, NULL, 10) & 0xFFF;
+}
+
+
+/**
+ * fill_image_words function copies the words of the code and data image to arrays, code words first.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param words - an array (IC + DC long) where to store the values of the words.
+ * @param tags - an array (IC + DC long) where to store the A/R/E tags of the words.
+ */
+void fill_image_words(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, int* words, char* tags)
+{
+	int i;
+
+	for(; head_mcl_node != NULL; head_mcl_node = head_mcl_node -> next) {
+		*words++ = code_word_value(head_mcl_node);
+		*tags++ = head_mcl_node -> memory_type;
+	}
+
+	for(; head_mdl_node != NULL; head_mdl_node = head_mdl_node -> next) {
+		for(i = 0; i < head_mdl_node -> words; i++) {
+			*words++ = data_word_value(head_mdl_node, i);
+			*tags++ = head_mdl_node -> memory_type;
+		}
+	}
 }
 
 
 /**
- * create_extern_file function creates an output extern file.
+ * add_extern_refs function adds the words that refer to external labels to a list of symbol references, like the lines of the '.ext' file.
  *
  * @param node_mcl_ptr - the pointer to the code-image-head-linked-list.
- * @param fn - the name of the file of which the output file is being created.
+ * @param head - the pointer to the head of the list.
  */
-void create_extern_file(mcl_ptr node_mcl_ptr, const char* fn)
+void add_extern_refs(mcl_ptr node_mcl_ptr, sr_ptr* head)
 {
-	FILE* fp = NULL;
-	char file_name[MAX_FILE_NAME_LENGTH + 5];	/* +1 for string terminator char, +4 for .ext extension */
+	sr_ptr curr;
+
+	for(curr = *head; curr != NULL && curr -> next != NULL; curr = curr -> next);
+
+	for(; node_mcl_ptr != NULL; node_mcl_ptr = node_mcl_ptr -> next) {
+		if(node_mcl_ptr -> memory_type == 'E') {
+			append_symbol_ref(head, &curr, node_mcl_ptr -> l -> lbl, node_mcl_ptr -> IC, node_mcl_ptr -> l -> lbl_line);
+		}
+	}
+}
 
-	strcpy(file_name, fn);	
-	file_name[strlen(file_name) - 3] = '\0'; /* remove .as extension */
-	strcat(file_name, EXT_EXTENSION);	/* add .ext extension */
+
+/**
+ * write_extern_file function writes the words that refer to external labels to an externals file.
+ *
+ * @param node_mcl_ptr - the pointer to the code-image-head-linked-list.
+ * @param file_name - the name of the externals file.
+ * @return - 1 if the file was written, 0 if it could not be created.
+ */
+int write_extern_file(mcl_ptr node_mcl_ptr, const char* file_name)
+{
+	FILE* fp = NULL;
 
 	fp = fopen(file_name, "w+");
 
 	if(fp == NULL) {
-		printf("Could not create externals file.\n");
-		emergency_free_mem();
-		exit(EXIT_FAILURE);
+		return 0;
 	}
 
 	while(node_mcl_ptr != NULL)
@@ -325,9 +525,8 @@ void create_extern_file(mcl_ptr node_mcl_ptr, const char* fn)
 		node_mcl_ptr = node_mcl_ptr -> next;
 	}
 
-	printf("\nFile '%s' has been created successfully!", file_name);
-
 	fclose(fp);
+	return 1;
 }
 
 
@@ -350,6 +549,124 @@ int was_extern_label_as_operand(mcl_ptr node_mcl_ptr)
 }
 
 
+/**
+ * insert_relocation function creates a relocation node and adds it to the end of the relocation table (list).
+ *
+ * @param head - the pointer to the pointer that points to the head of the relocation table.
+ * @param curr - the pointer to the pointer that points to the last node of the relocation table.
+ * @param addr - the address of the word.
+ * @param mt - the memory type of the word. possible inputs: RELOCATABLE, EXTERNAL.
+ */
+void insert_relocation(rel_ptr * head, rel_ptr * curr, int addr, char mt)
+{
+	rel_ptr p = NULL;
+
+	p = malloc(sizeof(relocation));
+
+	/* verify if malloc worked as expected */
+	if(p == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	p -> addr = addr;
+	p -> memory_type = mt;
+	p -> next = NULL;
+
+	/* if linked list is still empty */
+	if(*head == NULL)
+	{
+		(*head) = p;
+		(*curr) = p;
+	}
+	/* if linked list is not empty */
+	else
+	{
+		(*curr) -> next = p;
+		(*curr) = p;
+	}
+}
+
+
+/**
+ * remove_relocation_file function removes the relocation file of a source file, if there is one.
+ *
+ * @param fn - the name of the source file.
+ */
+void remove_relocation_file(const char* fn)
+{
+	char file_name[MAX_FILE_NAME_LENGTH + 5];	/* +1 for string terminator char, +4 for .rel extension */
+
+	strcpy(file_name, fn);
+	file_name[strlen(file_name) - 3] = '\0'; /* remove .as extension */
+	strcat(file_name, REL_EXTENSION);	/* add .rel extension */
+
+	remove(file_name);	/* there is no '.rel' file if it was never requested */
+}
+
+
+/**
+ * create_relocation_file function creates an output relocation file.
+ *
+ * @param node - the pointer to the head of the relocation table.
+ * @param fn - the name of the file of which the output file is being created.
+ */
+void create_relocation_file(rel_ptr node, const char* fn)
+{
+	FILE* fp = NULL;
+	char file_name[MAX_FILE_NAME_LENGTH + 5];	/* +1 for string terminator char, +4 for .rel extension */
+	rel_ptr p;
+	int count;
+
+	strcpy(file_name, fn);
+	file_name[strlen(file_name) - 3] = '\0'; /* remove .as extension */
+	strcat(file_name, REL_EXTENSION);	/* add .rel extension */
+
+	fp = fopen(file_name, "w+");
+
+	if(fp == NULL) {
+		printf("Could not create relocations file.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(count = 0, p = node; p != NULL; p = p -> next) {
+		count++;
+	}
+	fprintf(fp, "%d\n", count);
+
+	while(node != NULL)
+	{
+		fprintf(fp, "%04d %c\n", node -> addr, node -> memory_type);
+		node = node -> next;
+	}
+
+	printf("\nFile '%s' has been created successfully!", file_name);
+
+	fclose(fp);
+}
+
+
+/**
+ * free_relocation_nodes function frees all relocation nodes.
+ *
+ * @param head_node - the pointer to the pointer that points to the head of the relocation table.
+ */
+void free_relocation_nodes(rel_ptr * head_node)
+{
+	rel_ptr p;
+
+	while(*head_node != NULL)
+	{
+		p = *head_node;
+		*head_node = p -> next;
+		free(p);
+	}
+}
+
+
 /**
  * free_code_image_nodes function frees all code image nodes that were created during the execution.
  *
@@ -405,6 +722,10 @@ void free_data_image_nodes(mdl_ptr * head_node)
 			free(p -> mem_val);
 			p -> mem_val = NULL;
 		}
+		if(p -> blob != NULL) {
+			munmap(p -> blob, p -> blob_len);
+			p -> blob = NULL;
+		}
 		free(p);
 		p = NULL;
 	}
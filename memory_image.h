@@ -5,19 +5,26 @@
 #include <string.h>
 #include "line_details.h"
 #include "handler_functions_for_memory.h"
-#define OP_TABLE_LINES 16
+#include "object_module.h"	/* for symbol_ref struct */
+#include "isa.h"
 #define OPCODE_SIZE 4
 #define FUNCT_SIZE 4
 #define SRC_OPERAND_SIZE 2
 #define DEST_OPERAND_SIZE 2
 #define OB_EXTENSION ".ob"
 #define EXT_EXTENSION ".ext"
+#define REL_EXTENSION ".rel"
 
 
 /* union_type enum is used to determine which code image memory line needs to be created */
 enum memory_line_type {line_type_number, line_type_bits, direct_operand, relative_operand, no_ops};
 
 
+/* data_line_type enum is used to determine what a data image memory line holds, a single value, the mapped contents of an '.incbin' file
+ * or a run of equal words reserved by '.fill' / '.space' */
+enum data_line_type {data_value, data_blob, data_run};
+
+
 /* struct label is needed when an operand is a label (direct or relative) */
 typedef struct label {
 	char* lbl;
@@ -57,14 +64,33 @@ typedef struct memory_data_line* mdl_ptr;
 
 
 /* a struct of a typical data line, it holds a decimal number, ascii value or a register value (the value of the register and not whats in it)  */
+/* a data_blob line holds all the words of an '.incbin' file, starting at DC */
+/* a data_run line stands for 'words' words of value 'run_val', starting at DC. The words are written out only when the object file is created */
 typedef struct memory_data_line {
 	int DC;
-	char* mem_val;
+	enum data_line_type dlt;
+	char* mem_val;	/* data_value only */
+	int words;	/* the number of words the line holds, 1 for data_value */
+	unsigned char* blob;	/* data_blob only, the mapped contents of the file */
+	size_t blob_len;	/* data_blob only, the size of the file in bytes */
+	int blob_bits;	/* data_blob only, 8 - every byte is a word, 12 - every 3 bytes are 2 words */
+	int run_val;	/* data_run only, the value of all the words */
 	char memory_type;	/* Absolute, Relocatable, External */
 	mdl_ptr next;
 } memory_data_line;
 
 
+/* a pointer to struct relocation */
+typedef struct relocation* rel_ptr;
+
+/* a struct that represents a word of the code image that a loader / linker must patch: a relocatable ('R') or external ('E') word (list) */
+typedef struct relocation {
+	int addr;	/* the address of the word */
+	char memory_type;	/* Relocatable or External */
+	rel_ptr next;
+} relocation;
+
+
 /**
  * insert_memory_code_line function creates a memory-code-node and adds it to the list, if list is still empty, it's being created upon first node creation.
  * The node after creation has all needed information in it about how it should appear in memory code image.
@@ -92,26 +118,110 @@ void insert_memory_data_line(mdl_ptr * head, mdl_ptr * curr, int line_num, int v
 
 
 /**
- * create_image_hexa_file function creates an output hexe file of both code and data image.
- * This function must be called ONLY if no errors were found during the execution of the 'assembler'.
+ * insert_memory_data_blob function maps a binary file into memory and adds it to the data-image-list as one data_blob node.
+ * The contents of the file are not copied nor parsed, the words are extracted from the mapping only when the object file is written.
+ * With 'bits' 8, every byte of the file is a word. With 'bits' 12, every 3 bytes (big endian) are 2 words.
+ *
+ * @param head - the pointer to the pointer that points to the data-image-head-linked-list.
+ * @param curr - the pointer to the pointer that points to the data-image-current-linked-list.
+ * @param line_num - the line number of the first word as it should appear in data (with code lines offset) memory image.
+ * @param path - the name of the binary file.
+ * @param bits - the size of the words in the file, 8 or 12.
+ * @param mt - the memory type of the words.
+ * @param max_words - the number of words left in the memory, a larger file is not added.
+ * @return - the number of words added to the data image, -1 if the file could not be opened or mapped, or -2 if it has more than max_words
+ *           words.
+ */
+int insert_memory_data_blob(mdl_ptr * head, mdl_ptr * curr, int line_num, const char* path, int bits, char mt, int max_words);
+
+
+/**
+ * insert_memory_data_run function adds a run of 'count' words of value 'val' to the data-image-list as one data_run node.
+ * The words are not created, they're expanded only when the object file is written, so reserving any number of words costs one node.
+ *
+ * @param head - the pointer to the pointer that points to the data-image-head-linked-list.
+ * @param curr - the pointer to the pointer that points to the data-image-current-linked-list.
+ * @param line_num - the line number of the first word as it should appear in data (with code lines offset) memory image.
+ * @param count - the number of words.
+ * @param val - the value of the words.
+ * @param mt - the memory type of the words.
+ */
+void insert_memory_data_run(mdl_ptr * head, mdl_ptr * curr, int line_num, int count, int val, char mt);
+
+
+/**
+ * blob_word function returns the word at index 'ind' of a data_blob line.
+ *
+ * @param node - the data_blob line.
+ * @param ind - the index of the word, from 0 to (node -> words - 1).
+ * @return - the value of the word.
+ */
+int blob_word(mdl_ptr node, int ind);
+
+
+/**
+ * write_image_hexa_file function writes the code and data image to an object file, without printing anything (so it can run on a thread of
+ * its own, see 'output_files.h').
  *
  * @param head_mcl_node - the pointer to the code-image-head-linked-list.
  * @param head_mdl_node - the pointer to the data-image-head-linked-list.
- * @param fn - the name of the file of which the output file is being created.
- * @param IC - the total lines of code were processed. 
- * @param DC - the total lines of data were processed. 
+ * @param file_name - the name of the object file.
+ * @param IC - the total lines of code were processed.
+ * @param DC - the total lines of data were processed.
+ * @return - 1 if the file was written, 0 if it could not be created.
+ */
+int write_image_hexa_file(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, const char* file_name, int IC, int DC);
+
+
+/**
+ * code_word_value function returns the value of the word of a code image node.
+ *
+ * @param node - the code image node.
+ * @return - the value of the word (12 bits).
+ */
+int code_word_value(mcl_ptr node);
+
+
+/**
+ * data_word_value function returns the value of a word of a data image node (a data_blob / data_run node holds many words).
+ *
+ * @param node - the data image node.
+ * @param ind - the index of the word in the node, from 0 to (node -> words - 1).
+ * @return - the value of the word (12 bits).
  */
-void create_image_hexa_file(mcl_ptr head_mcl_node, mdl_ptr head_mdl_ptr, const char* fn, int IC, int DC);
+int data_word_value(mdl_ptr node, int ind);
 
 
 /**
- * create_extern_file function creates an output extern file.
+ * fill_image_words function copies the words of the code and data image to arrays, code words first (the order of the object file).
  * This function must be called ONLY if no errors were found during the execution of the 'assembler'.
  *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param words - an array (IC + DC long) where to store the values of the words.
+ * @param tags - an array (IC + DC long) where to store the A/R/E tags of the words.
+ */
+void fill_image_words(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, int* words, char* tags);
+
+
+/**
+ * add_extern_refs function adds the words that refer to external labels to a list of symbol references, like the lines of the '.ext' file.
+ * The line of every reference is the line in the source file where the external label was used.
+ *
  * @param node_mcl_ptr - the pointer to the code-image-head-linked-list.
- * @param fn - the name of the file of which the output file is being created.
+ * @param head - the pointer to the head of the list.
  */
-void create_extern_file(mcl_ptr node_mcl_ptr, const char* fn);
+void add_extern_refs(mcl_ptr node_mcl_ptr, sr_ptr* head);
+
+
+/**
+ * write_extern_file function writes the words that refer to external labels to an externals file, without printing anything.
+ *
+ * @param node_mcl_ptr - the pointer to the code-image-head-linked-list.
+ * @param file_name - the name of the externals file.
+ * @return - 1 if the file was written, 0 if it could not be created.
+ */
+int write_extern_file(mcl_ptr node_mcl_ptr, const char* file_name);
 
 
 /**
@@ -123,6 +233,46 @@ void create_extern_file(mcl_ptr node_mcl_ptr, const char* fn);
 int was_extern_label_as_operand(mcl_ptr node_mcl_ptr);
 
 
+/**
+ * insert_relocation function creates a relocation node and adds it to the end of the relocation table (list).
+ *
+ * @param head - the pointer to the pointer that points to the head of the relocation table.
+ * @param curr - the pointer to the pointer that points to the last node of the relocation table.
+ * @param addr - the address of the word.
+ * @param mt - the memory type of the word. possible inputs: RELOCATABLE, EXTERNAL.
+ */
+void insert_relocation(rel_ptr * head, rel_ptr * curr, int addr, char mt);
+
+
+/**
+ * remove_relocation_file function removes the '.rel' file of a source file, if there is one. It's called when RELOCATION_FILE_OPTION was not
+ * given, so a '.rel' file left from an earlier run doesn't describe the new '.ob' file.
+ *
+ * @param fn - the name of the source file.
+ */
+void remove_relocation_file(const char* fn);
+
+
+/**
+ * create_relocation_file function creates an output relocation file. The first line holds the number of relocations, followed by a
+ * "ADDRESS R/E" line for every relocatable / external word, in the order of the addresses. A loader allocates the table once and patches
+ * only these words, instead of checking every word of the '.ob' file.
+ * This function must be used ONLY if no errors were found during the execution of the 'assembler'.
+ *
+ * @param node - the pointer to the head of the relocation table.
+ * @param fn - the name of the file of which the output file is being created.
+ */
+void create_relocation_file(rel_ptr node, const char* fn);
+
+
+/**
+ * free_relocation_nodes function frees all relocation nodes.
+ *
+ * @param head_node - the pointer to the pointer that points to the head of the relocation table.
+ */
+void free_relocation_nodes(rel_ptr * head_node);
+
+
 /**
  * free_code_image_nodes function frees all code image nodes that were created during the execution.
  * The pointer to the pointer to the head-code-image-linked-list must be passed to the function in order to free the list correctly.
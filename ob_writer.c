@@ -0,0 +1,221 @@
+/**
+ * This file contains all functions related to the parallel writer of the '.ob' file of the 'assembler' (PARALLEL_OB_OPTION): the file is
+ * created at its final size, mapped to memory, and its lines are formatted on a pool of threads.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for threads and mmap */
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ob_writer.h"
+#include "emergency_free_mem.h"
+
+
+/**
+ * write_object_file_mapped function writes the code and data image to an object file on a pool of threads.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param file_name - the name of the object file.
+ * @param IC - the total lines of code were processed.
+ * @param DC - the total lines of data were processed.
+ * @return - 1 if the file was written, 0 if it could not be created.
+ */
+int write_object_file_mapped(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, const char* file_name, int IC, int DC)
+{
+	char header[OB_HEADER_LENGTH];
+	pthread_t threads[MAX_WRITER_THREADS];
+	ob_range ranges[MAX_WRITER_THREADS];
+	int* words;
+	char* tags;
+	char* map;
+	long words_num;
+	long size;
+	int header_len;
+	int threads_num;
+	int created;
+	int fd;
+	int i;
+
+	if(!image_addresses_consecutive(head_mcl_node, head_mdl_node, (long) IC + DC)) {
+		return write_image_hexa_file(head_mcl_node, head_mdl_node, file_name, IC, DC);
+	}
+
+	words_num = (long) IC + DC;
+	header_len = sprintf(header, "%d %d\n", IC, DC);
+	size = header_len + ob_records_length(words_num);
+
+	fd = open(file_name, O_RDWR | O_CREAT | O_TRUNC, 0666);
+	if(fd == -1) {
+		return 0;
+	}
+
+	map = MAP_FAILED;
+	if(ftruncate(fd, size) == 0) {	/* the file is created at its final size */
+		map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	close(fd);	/* the mapping stays valid after the file is closed */
+	if(map == MAP_FAILED) {
+		return write_image_hexa_file(head_mcl_node, head_mdl_node, file_name, IC, DC);
+	}
+
+	words = malloc((words_num + 1) * sizeof(int));	/* +1 so an empty image doesn't ask for 0 bytes */
+	tags = malloc(words_num + 1);
+
+	/* verify if malloc worked as expected */
+	if(words == NULL || tags == NULL)
+	{
+		free(words);
+		free(tags);
+		munmap(map, size);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	fill_image_words(head_mcl_node, head_mdl_node, words, tags);
+	memcpy(map, header, header_len);
+
+	threads_num = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if(threads_num > MAX_WRITER_THREADS) {
+		threads_num = MAX_WRITER_THREADS;
+	}
+	if(threads_num > words_num / MIN_WORDS_PER_WRITER) {
+		threads_num = (int) (words_num / MIN_WORDS_PER_WRITER);
+	}
+	if(threads_num < 1) {
+		threads_num = 1;
+	}
+
+	for(i = 0; i < threads_num; i++) {	/* disjoint ranges of words, and so of bytes of the file */
+		ranges[i].words = words;
+		ranges[i].tags = tags;
+		ranges[i].from = words_num * i / threads_num;
+		ranges[i].to = words_num * (i + 1) / threads_num;
+		ranges[i].out = map + header_len + ob_records_length(ranges[i].from);
+	}
+
+	/* the first range is formatted by this thread, a range whose thread could not be created too */
+	for(created = 0, i = 1; i < threads_num; i++) {
+		if(pthread_create(&threads[i], NULL, format_ob_range, &ranges[i]) != 0) {
+			break;
+		}
+		created++;
+	}
+	format_ob_range(&ranges[0]);
+	for(i = created + 1; i < threads_num; i++) {
+		format_ob_range(&ranges[i]);
+	}
+	for(i = 1; i <= created; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	munmap(map, size);
+	free(words);
+	free(tags);
+
+	return 1;
+}
+
+
+/**
+ * format_ob_range function writes the lines of a range of words into the mapped '.ob' file.
+ *
+ * @param arg - a pointer to the range.
+ * @return - NULL.
+ */
+void* format_ob_range(void* arg)
+{
+	static const char hex_digits[] = "0123456789ABCDEF";
+
+	ob_range* range;
+	char addr_text[ADDRESS_TEXT_SIZE];
+	int addr_len;
+	char* out;
+	long i;
+	int word;
+
+	range = (ob_range*) arg;
+	out = range -> out;
+	addr_len = sprintf(addr_text, "%04ld", FIRST_ADDRESS + range -> from);
+
+	for(i = range -> from; i < range -> to; i++, next_decimal(addr_text, &addr_len)) {
+		word = range -> words[i];
+		memcpy(out, addr_text, addr_len);
+		out += addr_len;
+		out[0] = ' ';
+		out[1] = hex_digits[(word >> 8) & 0xF];
+		out[2] = hex_digits[(word >> 4) & 0xF];
+		out[3] = hex_digits[word & 0xF];
+		out[4] = ' ';
+		out[5] = range -> tags[i];
+		out[6] = '\n';
+		out += OB_RECORD_TAIL_LENGTH;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * ob_records_length function returns the length of the lines of words in an '.ob' file, from the first word to a word.
+ *
+ * @param words_num - the number of words.
+ * @return - the length in bytes.
+ */
+long ob_records_length(long words_num)
+{
+	long addr, end, limit;
+	long len;
+	int width;
+
+	addr = FIRST_ADDRESS;
+	end = FIRST_ADDRESS + words_num;
+
+	/* addresses below 10000 are written with 4 digits ("%04d"), then every power of 10 adds a digit */
+	for(len = 0, width = 4, limit = 10000; addr < end; width++, limit *= 10) {
+		if(addr < limit) {
+			len += ((end < limit ? end : limit) - addr) * (width + OB_RECORD_TAIL_LENGTH);
+			addr = end < limit ? end : limit;
+		}
+	}
+
+	return len;
+}
+
+
+/**
+ * image_addresses_consecutive function checks whether the addresses of the code and data image are consecutive.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param words_num - the number of words of the image.
+ * @return - 1 if the addresses are consecutive, otherwise 0 is returned.
+ */
+int image_addresses_consecutive(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, long words_num)
+{
+	long addr;
+
+	addr = FIRST_ADDRESS;
+
+	for(; head_mcl_node != NULL; head_mcl_node = head_mcl_node -> next, addr++) {
+		if(head_mcl_node -> IC != addr) {
+			return 0;
+		}
+	}
+
+	for(; head_mdl_node != NULL; head_mdl_node = head_mdl_node -> next) {
+		if(head_mdl_node -> DC != addr) {
+			return 0;
+		}
+		addr += head_mdl_node -> words;
+	}
+
+	return addr == FIRST_ADDRESS + words_num;
+}
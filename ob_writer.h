@@ -0,0 +1,73 @@
+#ifndef OB_WRITER_H
+#define OB_WRITER_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "memory_image.h"
+#include "object_module.h"	/* for FIRST_ADDRESS, MAX_ADDRESS_DIGITS and next_decimal function */
+#define MAX_WRITER_THREADS 16	/* the maximum number of threads that format the words of one '.ob' file */
+#define MIN_WORDS_PER_WRITER 16384	/* fewer words than this are not worth a thread of their own */
+#define OB_RECORD_TAIL_LENGTH 7	/* the length of a line of a word after its address: " HHH T\n" */
+#define OB_HEADER_LENGTH 24	/* enough for "IC DC\n" */
+#define ADDRESS_TEXT_SIZE 24	/* the size of the text of an address, enough for any long (and more than MAX_ADDRESS_DIGITS + 1) */
+
+
+/* a struct that represents the words of an '.ob' file one thread formats: a range of the words, and where their lines start in the file */
+typedef struct ob_range {
+	const int* words;	/* the words of the whole image */
+	const char* tags;	/* the A/R/E tags of the whole image */
+	char* out;	/* the first byte of the line of the first word of the range */
+	long from;	/* the index of the first word of the range */
+	long to;	/* the index after the last word of the range */
+} ob_range;
+
+
+/**
+ * write_object_file_mapped function writes the code and data image to an object file, without printing anything. Every line of a word has a
+ * known length ("%04d %03X %c\n", its address decides the width), so the size of the file and the position of every line are known from IC
+ * and DC before anything is written: the file is created at its final size and mapped to memory, and the words are split into ranges that are
+ * formatted on separate threads (one per processor, up to MAX_WRITER_THREADS). An image whose addresses are not consecutive, or a file that
+ * can't be mapped, is written by write_image_hexa_file function.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param file_name - the name of the object file.
+ * @param IC - the total lines of code were processed.
+ * @param DC - the total lines of data were processed.
+ * @return - 1 if the file was written, 0 if it could not be created.
+ */
+int write_object_file_mapped(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, const char* file_name, int IC, int DC);
+
+
+/**
+ * format_ob_range function writes the lines of a range of words into the mapped '.ob' file. The address is kept as decimal text and the word
+ * is written with a table of hex digits, so no line is formatted with printf functions.
+ *
+ * @param arg - a pointer to the range (ob_range struct), the signature of a thread function.
+ * @return - NULL.
+ */
+void* format_ob_range(void* arg);
+
+
+/**
+ * ob_records_length function returns the length of the lines of words in an '.ob' file, from the first word to a word.
+ *
+ * @param words_num - the number of words (the lines of words 0 to words_num - 1 are counted).
+ * @return - the length in bytes.
+ */
+long ob_records_length(long words_num);
+
+
+/**
+ * image_addresses_consecutive function checks whether the addresses of the code and data image are FIRST_ADDRESS, FIRST_ADDRESS + 1, ...
+ * in the order of the lists, as they are in every image the 'assembler' creates, and the lists hold the number of words IC and DC say.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param words_num - the number of words of the image (IC + DC).
+ * @return - 1 if the addresses are consecutive, otherwise 0 is returned.
+ */
+int image_addresses_consecutive(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, long words_num);
+
+
+#endif
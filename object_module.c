@@ -0,0 +1,745 @@
+/**
+ * This file contains all functions related to reading assembled modules (the '.ob', '.ent' and '.ext' files the 'assembler' creates)
+ * for the 'linker'. The files are parsed from memory, so a module can be read from its own files or from any other place it's stored in.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for mmap */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "object_module.h"
+#include "emergency_free_mem.h"
+
+static int link_errors = 0;	/* the number of errors found while linking */
+
+
+/**
+ * load_object_module function reads the '.ob', '.ent' and '.ext' files of an assembled module.
+ *
+ * @param name - the name of the module (the file name without extension).
+ * @return - a pointer to the module, or NULL if a file could not be read or is not valid.
+ */
+om_ptr load_object_module(const char* name)
+{
+	char* file_name;
+	const char* ob;
+	char* ent;
+	char* ext;
+	char* rel;
+	size_t ob_len, ent_len, ext_len, rel_len;
+	om_ptr m;
+
+	file_name = module_file_name(name, OB_EXTENSION);
+	ob = map_whole_file(file_name, &ob_len);
+	if(ob == NULL) {
+		link_error(file_name, 0, "The object file could not be opened.", NULL);
+		free(file_name);
+		return NULL;
+	}
+	free(file_name);
+
+	ent_len = 0;
+	ext_len = 0;
+	file_name = module_file_name(name, ENT_EXTENSION);
+	ent = read_whole_file(file_name, &ent_len);
+	free(file_name);
+	file_name = module_file_name(name, EXT_EXTENSION);
+	ext = read_whole_file(file_name, &ext_len);
+	free(file_name);
+
+	m = parse_object_module(name, ob, ob_len, ent, ent_len, ext, ext_len);
+
+	unmap_whole_file(ob, ob_len);
+	if(ent != NULL) {
+		free(ent);
+	}
+	if(ext != NULL) {
+		free(ext);
+	}
+
+	/* the '.rel' file is optional, without it (or if it doesn't match the '.ob' file) every word is checked when the module is relocated */
+	file_name = module_file_name(name, REL_EXTENSION);
+	rel = read_whole_file(file_name, &rel_len);
+	free(file_name);
+	if(rel != NULL) {
+		if(m != NULL) {
+			parse_relocations(m, rel, rel_len);
+		}
+		free(rel);
+	}
+
+	return m;
+}
+
+
+/**
+ * create_object_module function creates an empty module (no words, no entry and external labels).
+ *
+ * @param name - the name of the module.
+ * @return - a pointer to the module.
+ */
+om_ptr create_object_module(const char* name)
+{
+	om_ptr m;
+
+	m = malloc(sizeof(object_module));
+
+	/* verify if malloc worked as expected */
+	if(m == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	m -> name = malloc(strlen(name) + 1);
+
+	/* verify if malloc worked as expected */
+	if(m -> name == NULL)
+	{
+		free(m);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	strcpy(m -> name, name);
+	m -> ic = 0;
+	m -> dc = 0;
+	m -> words = NULL;
+	m -> tags = NULL;
+	m -> entries = NULL;
+	m -> externs = NULL;
+	m -> relocs = NULL;
+	m -> relocs_num = 0;
+	m -> code_base = FIRST_ADDRESS;
+	m -> data_base = FIRST_ADDRESS;
+	m -> reloaded = 0;
+	m -> assembled = 0;
+	m -> next = NULL;
+
+	return m;
+}
+
+
+/**
+ * alloc_module_words function allocates the words and tags arrays of a module, after its ic and dc were set.
+ *
+ * @param m - a pointer to the module.
+ */
+void alloc_module_words(om_ptr m)
+{
+	m -> words = malloc((m -> ic + m -> dc + 1) * sizeof(int));	/* +1 so an empty module doesn't ask for 0 bytes */
+	m -> tags = malloc(m -> ic + m -> dc + 1);
+
+	/* verify if malloc worked as expected */
+	if(m -> words == NULL || m -> tags == NULL)
+	{
+		free_object_modules(&m);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+}
+
+
+/**
+ * parse_object_module function creates a module from the contents of its '.ob', '.ent' and '.ext' files.
+ *
+ * @param name - the name of the module.
+ * @param ob - the contents of the '.ob' file.
+ * @param ob_len - the length of 'ob'.
+ * @param ent - the contents of the '.ent' file (NULL if there is no '.ent' file).
+ * @param ent_len - the length of 'ent'.
+ * @param ext - the contents of the '.ext' file (NULL if there is no '.ext' file).
+ * @param ext_len - the length of 'ext'.
+ * @return - a pointer to the module, or NULL if the contents are not valid.
+ */
+om_ptr parse_object_module(const char* name, const char* ob, size_t ob_len, const char* ent, size_t ent_len, const char* ext, size_t ext_len)
+{
+	char line[MAX_OBJECT_LINE_LENGTH];
+	char* file_name;
+	const char* pos;
+	const char* end;
+	om_ptr m;
+	int valid;
+
+	m = create_object_module(name);
+
+	valid = 1;
+	pos = ob;
+	end = ob + ob_len;
+	file_name = module_file_name(name, OB_EXTENSION);
+
+	/* START - '.ob' file */
+	if(!next_text_line(&pos, end, line, sizeof(line)) || sscanf(line, "%d %d", &(m -> ic), &(m -> dc)) != 2 || m -> ic < 0 || m -> dc < 0) {
+		link_error(file_name, 1, "Invalid object file header. \"IC DC\" is expected.", NULL);
+		valid = 0;
+	}
+	else if((size_t) m -> ic + m -> dc > (size_t) (end - pos) / MIN_OBJECT_RECORD_LENGTH) {	/* checked before the words are allocated */
+		link_error(file_name, 1, "Invalid object file header. The object file is shorter than its header says.", NULL);
+		valid = 0;
+	}
+	else {
+		alloc_module_words(m);
+		valid = parse_object_words(m, pos, end, file_name);
+	}
+	free(file_name);
+	/* END - '.ob' file */
+
+	/* START - '.ent' and '.ext' files */
+	if(valid && ent != NULL) {
+		file_name = module_file_name(name, ENT_EXTENSION);
+		valid = parse_symbol_refs(ent, ent_len, file_name, &(m -> entries));
+		free(file_name);
+	}
+	if(valid && ext != NULL) {
+		file_name = module_file_name(name, EXT_EXTENSION);
+		valid = parse_symbol_refs(ext, ext_len, file_name, &(m -> externs));
+		free(file_name);
+	}
+	/* END - '.ent' and '.ext' files */
+
+	if(!valid) {
+		free_object_modules(&m);
+		return NULL;
+	}
+
+	return m;
+}
+
+
+/**
+ * parse_object_words function reads the lines of the words of an '.ob' file into the words and tags arrays of a module.
+ *
+ * @param m - a pointer to the module (its words were allocated already).
+ * @param pos - the start of the line of the first word.
+ * @param end - the end of the '.ob' file.
+ * @param file_name - the name of the '.ob' file, for error messages.
+ * @return - 1 if all lines are valid, otherwise 0 is returned.
+ */
+int parse_object_words(om_ptr m, const char* pos, const char* end, const char* file_name)
+{
+	char line[MAX_OBJECT_LINE_LENGTH];
+	char addr_text[MAX_ADDRESS_DIGITS + 1];
+	const unsigned char* rec;
+	int addr_len;
+	int i, addr, line_num;
+	unsigned int val;
+	unsigned int bad;
+	int c0, c1, c2;
+	char tag;
+
+	sprintf(addr_text, "%04d", FIRST_ADDRESS);
+	addr_len = strlen(addr_text);
+
+	for(i = 0; i < m -> ic + m -> dc; i++, next_decimal(addr_text, &addr_len))
+	{
+		/* the fast path: the line is exactly "ADDRESS HHH T\n" with the address of the word, written like the assembler writes it */
+		rec = (const unsigned char*) pos;
+		if(end - pos >= addr_len + FIXED_RECORD_LENGTH && memcmp(rec, addr_text, addr_len) == 0) {
+			rec += addr_len;
+			c0 = rec[1];
+			c1 = rec[2];
+			c2 = rec[3];
+			bad = (rec[0] ^ ' ') | (rec[4] ^ ' ') | (rec[6] ^ '\n') | !is_hex_digit(c0) | !is_hex_digit(c1) | !is_hex_digit(c2) |
+				(rec[5] != 'A' && rec[5] != 'R' && rec[5] != 'E');
+			if(!bad) {
+				m -> words[i] = (hex_digit_value(c0) << 8) | (hex_digit_value(c1) << 4) | hex_digit_value(c2);
+				m -> tags[i] = rec[5];
+				pos += addr_len + FIXED_RECORD_LENGTH;
+				continue;
+			}
+		}
+
+		/* the slow path: any other spacing, a '\r' before the newline, or an invalid line */
+		line_num = i + 2;	/* the header is line 1 */
+		if(!next_text_line(&pos, end, line, sizeof(line))) {
+			link_error(file_name, line_num, "Missing words. The object file is shorter than its header says.", NULL);
+			return 0;
+		}
+		if(sscanf(line, "%d %x %c", &addr, &val, &tag) != 3 || addr != FIRST_ADDRESS + i || val > MAX_WORD_VALUE ||
+				(tag != 'A' && tag != 'R' && tag != 'E')) {
+			link_error(file_name, line_num, "Invalid object file line. \"ADDRESS WORD A/R/E\" is expected.", NULL);
+			return 0;
+		}
+		m -> words[i] = val;
+		m -> tags[i] = tag;
+	}
+
+	return 1;
+}
+
+
+/**
+ * is_hex_digit function checks whether a char is a hexadecimal digit, without branches.
+ *
+ * @param c - the char.
+ * @return - 1 if 'c' is a hexadecimal digit, otherwise 0 is returned.
+ */
+int is_hex_digit(int c)
+{
+	return ((unsigned int) (c - '0') < 10) | ((unsigned int) ((c | 0x20) - 'a') < 6);
+}
+
+
+/**
+ * hex_digit_value function returns the value of a hexadecimal digit, without branches.
+ *
+ * @param c - the digit ('0'-'9', 'A'-'F' or 'a'-'f').
+ * @return - the value.
+ */
+int hex_digit_value(int c)
+{
+	return (c & 0xF) + 9 * ((c >> 6) & 1);	/* letters are 0x41-0x46 / 0x61-0x66, digits are 0x30-0x39 */
+}
+
+
+/**
+ * next_decimal function adds 1 to a decimal number written as text.
+ *
+ * @param text - the number (at least MAX_ADDRESS_DIGITS + 1 chars).
+ * @param len - an address of the length of the number, it grows when a digit is added.
+ */
+void next_decimal(char* text, int* len)
+{
+	int i;
+
+	for(i = *len - 1; i >= 0 && text[i] == '9'; i--) {
+		text[i] = '0';
+	}
+
+	if(i >= 0) {
+		text[i]++;
+	}
+	else if(*len < MAX_ADDRESS_DIGITS) {	/* all digits were 9 */
+		memmove(text + 1, text, *len + 1);
+		text[0] = '1';
+		(*len)++;
+	}
+}
+
+
+/**
+ * parse_relocations function reads the contents of the '.rel' file of a module into its relocs array, if it lists exactly the 'R' / 'E' words
+ * of the module.
+ *
+ * @param m - a pointer to the module (its words were parsed already).
+ * @param rel - the contents of the '.rel' file.
+ * @param rel_len - the length of 'rel'.
+ * @return - 1 if the '.rel' file matches the module, otherwise 0 is returned (relocs is left NULL).
+ */
+int parse_relocations(om_ptr m, const char* rel, size_t rel_len)
+{
+	char line[MAX_OBJECT_LINE_LENGTH];
+	const char* pos;
+	const char* end;
+	int count;
+	int words_num;	/* the number of 'R' / 'E' words of the module */
+	int addr;
+	int prev;
+	int i;
+	char tag;
+
+	pos = rel;
+	end = rel + rel_len;
+
+	for(words_num = 0, i = 0; i < m -> ic + m -> dc; i++) {
+		if(m -> tags[i] != 'A') {
+			words_num++;
+		}
+	}
+
+	if(!next_text_line(&pos, end, line, sizeof(line)) || sscanf(line, "%d", &count) != 1 || count != words_num) {
+		return 0;
+	}
+
+	m -> relocs = malloc((count + 1) * sizeof(int));	/* +1 so an empty table doesn't ask for 0 bytes */
+
+	/* verify if malloc worked as expected */
+	if(m -> relocs == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	/* the words are listed in the order of their addresses, so 'count' different 'R' / 'E' words are all of them */
+	for(prev = FIRST_ADDRESS - 1, i = 0; i < count; i++, prev = addr)
+	{
+		if(!next_text_line(&pos, end, line, sizeof(line)) || sscanf(line, "%d %c", &addr, &tag) != 2 ||
+				addr <= prev || addr >= FIRST_ADDRESS + m -> ic || m -> tags[addr - FIRST_ADDRESS] != tag || tag == 'A') {
+			free(m -> relocs);
+			m -> relocs = NULL;
+			return 0;
+		}
+		m -> relocs[i] = addr - FIRST_ADDRESS;
+	}
+	m -> relocs_num = count;
+
+	return 1;
+}
+
+
+/**
+ * parse_symbol_refs function creates the list of the lines of an '.ent' or '.ext' file ("LABEL ADDRESS" lines).
+ *
+ * @param text - the contents of the file.
+ * @param len - the length of 'text'.
+ * @param file_name - the name of the file, for error messages.
+ * @param head - the pointer to the head of the list to create.
+ * @return - 1 if all lines are valid, otherwise 0 is returned.
+ */
+int parse_symbol_refs(const char* text, size_t len, const char* file_name, sr_ptr* head)
+{
+	char line[MAX_OBJECT_LINE_LENGTH];
+	char label[MAX_SYMBOL_LENGTH + 2];	/* +1 to detect a too long label, +1 for string terminator char */
+	const char* pos;
+	const char* end;
+	sr_ptr curr;
+	int line_num;
+	int addr;
+
+	pos = text;
+	end = text + len;
+	curr = NULL;
+	line_num = 0;
+
+	while(next_text_line(&pos, end, line, sizeof(line)))
+	{
+		line_num++;
+		if(sscanf(line, "%32s %d", label, &addr) != 2 || strlen(label) > MAX_SYMBOL_LENGTH) {
+			link_error(file_name, line_num, "Invalid line. \"LABEL ADDRESS\" is expected.", NULL);
+			return 0;
+		}
+
+		append_symbol_ref(head, &curr, label, addr, line_num);
+	}
+
+	return 1;
+}
+
+
+/**
+ * append_symbol_ref function adds a symbol reference to the end of a list.
+ *
+ * @param head - the pointer to the head of the list.
+ * @param curr - the pointer to the last node of the list (NULL if the list is empty), it's moved to the new node.
+ * @param label - the label.
+ * @param addr - the address.
+ * @param line - the line of the reference, for error messages.
+ */
+void append_symbol_ref(sr_ptr* head, sr_ptr* curr, const char* label, int addr, int line)
+{
+	sr_ptr node;
+
+	node = malloc(sizeof(symbol_ref));
+
+	/* verify if malloc worked as expected */
+	if(node == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	node -> label = malloc(strlen(label) + 1);
+
+	/* verify if malloc worked as expected */
+	if(node -> label == NULL)
+	{
+		free(node);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	strcpy(node -> label, label);
+	node -> addr = addr;
+	node -> line = line;
+	node -> next = NULL;
+
+	if(*curr == NULL) {
+		*head = node;
+	}
+	else (*curr) -> next = node;
+	*curr = node;
+}
+
+
+/**
+ * next_text_line function copies the next line of a text in memory to 'line', without the newline char.
+ *
+ * @param pos - the pointer to the position in the text, it's moved to the start of the next line.
+ * @param end - the end of the text.
+ * @param line - a string where to store the line.
+ * @param size - the size of 'line'.
+ * @return - 1 if a line was copied, 0 if the end of the text was reached.
+ */
+int next_text_line(const char** pos, const char* end, char* line, int size)
+{
+	const char* p;
+	int len;
+
+	p = *pos;
+	if(p >= end) {
+		return 0;
+	}
+
+	len = 0;
+	while(p < end && *p != '\n')
+	{
+		if(len < size - 1) {
+			line[len++] = *p;
+		}
+		p++;
+	}
+	line[len] = '\0';
+
+	*pos = (p < end) ? p + 1 : p;	/* skip the newline char */
+	return 1;
+}
+
+
+/**
+ * read_whole_file function reads a whole file into memory.
+ *
+ * @param path - the name of the file.
+ * @param len - an address of a size_t where to store the length of the file.
+ * @return - the contents of the file (must be freed), or NULL if the file could not be opened.
+ */
+char* read_whole_file(const char* path, size_t* len)
+{
+	FILE* fp;
+	long size;
+	char* text;
+
+	fp = fopen(path, "rb");
+	if(fp == NULL) {
+		return NULL;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if(size < 0) {
+		fclose(fp);
+		return NULL;
+	}
+
+	text = malloc(size + 1);	/* +1 so an empty file doesn't ask for 0 bytes */
+
+	/* verify if malloc worked as expected */
+	if(text == NULL)
+	{
+		fclose(fp);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	*len = fread(text, 1, size, fp);
+	fclose(fp);
+
+	return text;
+}
+
+
+/**
+ * map_whole_file function maps a whole file to memory (read only).
+ *
+ * @param path - the name of the file.
+ * @param len - an address of a size_t where to store the length of the file.
+ * @return - the contents of the file (must be released with unmap_whole_file function), or NULL if the file could not be opened.
+ */
+const char* map_whole_file(const char* path, size_t* len)
+{
+	static const char empty[] = "";
+	struct stat st;
+	int fd;
+	char* map;
+
+	fd = open(path, O_RDONLY);
+	if(fd == -1) {
+		return NULL;
+	}
+
+	if(fstat(fd, &st) == -1) {
+		close(fd);
+		return NULL;
+	}
+
+	*len = st.st_size;
+	if(st.st_size == 0) {	/* an empty file can't be mapped */
+		close(fd);
+		return empty;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);	/* the mapping stays valid after the file is closed */
+	if(map == MAP_FAILED) {
+		return NULL;
+	}
+
+	return map;
+}
+
+
+/**
+ * unmap_whole_file function releases the contents of a file mapped with map_whole_file function.
+ *
+ * @param text - the contents of the file.
+ * @param len - the length of the file.
+ */
+void unmap_whole_file(const char* text, size_t len)
+{
+	if(len > 0) {
+		munmap((void*) text, len);
+	}
+}
+
+
+/**
+ * module_file_name function creates the name of a file of a module.
+ *
+ * @param name - the name of the module.
+ * @param extension - the extension of the file.
+ * @return - the name of the file (must be freed).
+ */
+char* module_file_name(const char* name, const char* extension)
+{
+	char* file_name;
+
+	file_name = malloc(strlen(name) + strlen(extension) + 1);	/* +1 for string terminator char */
+
+	/* verify if malloc worked as expected */
+	if(file_name == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	strcpy(file_name, name);
+	strcat(file_name, extension);
+
+	return file_name;
+}
+
+
+/**
+ * relocate_address function returns the address in the linked image of an address in the module.
+ *
+ * @param m - a pointer to the module.
+ * @param addr - the address in the module.
+ * @return - the address in the linked image.
+ */
+int relocate_address(om_ptr m, int addr)
+{
+	if(addr < FIRST_ADDRESS + m -> ic) {
+		return addr - FIRST_ADDRESS + m -> code_base;
+	}
+	else return addr - FIRST_ADDRESS - m -> ic + m -> data_base;
+}
+
+
+/**
+ * module_diagnostic_name function creates the name of the file errors of a module are reported in.
+ *
+ * @param m - a pointer to the module.
+ * @param extension - the extension of the file the error was found in (if the module was read from files).
+ * @return - the name of the file (allocated, must be freed by the caller).
+ */
+char* module_diagnostic_name(om_ptr m, const char* extension)
+{
+	return module_file_name(m -> name, m -> assembled ? SOURCE_EXTENSION : extension);
+}
+
+
+/**
+ * link_error function prints an error found while linking and counts it.
+ *
+ * @param file_name - the name of the file where the error was found.
+ * @param line - the line in the file (0 if the error isn't related to a line).
+ * @param msg - the description of the error.
+ * @param label - the label the error is related to (NULL if none).
+ */
+void link_error(const char* file_name, int line, const char* msg, const char* label)
+{
+	link_errors++;
+
+	if(line > 0) {
+		printf("\nError in file '%s', line %d: %s", file_name, line, msg);
+	}
+	else printf("\nError in file '%s': %s", file_name, msg);
+
+	if(label != NULL) {
+		printf(" Label: '%s'.", label);
+	}
+	putchar('\n');
+}
+
+
+/**
+ * were_link_errors function checks whether errors were found while linking.
+ *
+ * @return - the number of errors found.
+ */
+int were_link_errors()
+{
+	return link_errors;
+}
+
+
+/**
+ * free_symbol_refs function frees a list of symbol references.
+ *
+ * @param head - the pointer to the head of the list.
+ */
+void free_symbol_refs(sr_ptr* head)
+{
+	sr_ptr node;
+
+	while(*head != NULL)
+	{
+		node = *head;
+		*head = node -> next;
+		free(node -> label);
+		free(node);
+	}
+}
+
+
+/**
+ * free_object_modules function frees a list of modules.
+ *
+ * @param head - the pointer to the head of the list.
+ */
+void free_object_modules(om_ptr* head)
+{
+	om_ptr m;
+
+	while(*head != NULL)
+	{
+		m = *head;
+		*head = m -> next;
+		free_symbol_refs(&(m -> entries));
+		free_symbol_refs(&(m -> externs));
+		if(m -> words != NULL) {
+			free(m -> words);
+		}
+		if(m -> tags != NULL) {
+			free(m -> tags);
+		}
+		if(m -> relocs != NULL) {
+			free(m -> relocs);
+		}
+		free(m -> name);
+		free(m);
+	}
+}
@@ -0,0 +1,291 @@
+#ifndef OBJECT_MODULE_H
+#define OBJECT_MODULE_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "isa.h"	/* for FIRST_ADDRESS */
+#define OB_EXTENSION ".ob"
+#define ENT_EXTENSION ".ent"
+#define EXT_EXTENSION ".ext"
+#define SOURCE_EXTENSION ".as"
+#define REL_EXTENSION ".rel"
+#define MAX_WORD_VALUE 0xFFF	/* a word is 12 bits */
+#define MAX_OBJECT_LINE_LENGTH 128
+#define FIXED_RECORD_LENGTH 7	/* the length of a line of a word in an '.ob' file after its address: " HHH T\n" */
+#define MIN_OBJECT_RECORD_LENGTH 6	/* the shortest line of a word ("ADDR W T" with a 3 digits address and no newline at the end) */
+#define MAX_ADDRESS_DIGITS 10	/* the digits of the largest address of a word, see next_decimal function */
+#define MAX_SYMBOL_LENGTH 31
+
+
+/* a pointer to struct symbol_ref */
+typedef struct symbol_ref* sr_ptr;
+
+/* a struct that represents a line of an '.ent' file (an entry label and its address) or of an '.ext' file (an external label and the address
+ * of a word that refers to it) (list) */
+typedef struct symbol_ref {
+	char* label;
+	int addr;	/* the address in the module, as written in the file */
+	int line;	/* the line in the '.ent' / '.ext' file, for error messages */
+	sr_ptr next;
+} symbol_ref;
+
+
+/* a pointer to struct object_module */
+typedef struct object_module* om_ptr;
+
+/* a struct that represents an assembled module: the contents of its '.ob', '.ent' and '.ext' files (list) */
+typedef struct object_module {
+	char* name;	/* the name of the module (the file name without extension) */
+	int ic;	/* the number of code words */
+	int dc;	/* the number of data words */
+	int* words;	/* the ic + dc words of the module, code words first */
+	char* tags;	/* the A/R/E tag of every word */
+	sr_ptr entries;	/* the lines of the '.ent' file */
+	sr_ptr externs;	/* the lines of the '.ext' file */
+	int* relocs;	/* the indexes (in words) of the 'R' / 'E' words listed in the '.rel' file, NULL if the module has no '.rel' file */
+	int relocs_num;	/* the number of indexes in relocs */
+	int code_base;	/* the address of the first code word in the linked image (set by the linker) */
+	int data_base;	/* the address of the first data word in the linked image (set by the linker) */
+	int reloaded;	/* 1 if the module was read again by an incremental relink (see 'relink.h') */
+	int assembled;	/* 1 if the module was assembled in memory by the 'assembler' (whole-program mode), its lines refer to the source file */
+	om_ptr next;
+} object_module;
+
+
+/**
+ * load_object_module function reads the '.ob', '.ent' and '.ext' files of an assembled module. The '.ob' file is mapped to memory (see
+ * map_whole_file function) and its words are decoded in place (see parse_object_words function). The '.ob' file must exist, the '.ent' and
+ * '.ext' files are optional (the assembler doesn't create them when there are no entries / externals).
+ * Errors are reported with link_error function.
+ *
+ * @param name - the name of the module (the file name without extension).
+ * @return - a pointer to the module, or NULL if a file could not be read or is not valid.
+ */
+om_ptr load_object_module(const char* name);
+
+
+/**
+ * create_object_module function creates an empty module (no words, no entry and external labels).
+ *
+ * @param name - the name of the module.
+ * @return - a pointer to the module.
+ */
+om_ptr create_object_module(const char* name);
+
+
+/**
+ * alloc_module_words function allocates the words and tags arrays of a module, after its ic and dc were set.
+ *
+ * @param m - a pointer to the module.
+ */
+void alloc_module_words(om_ptr m);
+
+
+/**
+ * parse_object_module function creates a module from the contents of its '.ob', '.ent' and '.ext' files, which may be anywhere in memory
+ * (read from the files or mapped from an archive). The contents are not changed and are not needed after the function returns.
+ * Errors are reported with link_error function.
+ *
+ * @param name - the name of the module.
+ * @param ob - the contents of the '.ob' file.
+ * @param ob_len - the length of 'ob'.
+ * @param ent - the contents of the '.ent' file (NULL if there is no '.ent' file).
+ * @param ent_len - the length of 'ent'.
+ * @param ext - the contents of the '.ext' file (NULL if there is no '.ext' file).
+ * @param ext_len - the length of 'ext'.
+ * @return - a pointer to the module, or NULL if the contents are not valid.
+ */
+om_ptr parse_object_module(const char* name, const char* ob, size_t ob_len, const char* ent, size_t ent_len, const char* ext, size_t ext_len);
+
+
+/**
+ * parse_object_words function reads the lines of the words of an '.ob' file ("ADDRESS WORD A/R/E" lines, after the header) into the words and
+ * tags arrays of a module. A line written like the assembler writes it ("%04d %03X %c") is decoded in place: its address is compared with the
+ * expected address kept as text, and its hex digits are decoded without branches. Any other line is read with sscanf function, so a file
+ * written by hand is read like before.
+ * Errors are reported with link_error function.
+ *
+ * @param m - a pointer to the module (its words were allocated already).
+ * @param pos - the start of the line of the first word.
+ * @param end - the end of the '.ob' file.
+ * @param file_name - the name of the '.ob' file, for error messages.
+ * @return - 1 if all lines are valid, otherwise 0 is returned.
+ */
+int parse_object_words(om_ptr m, const char* pos, const char* end, const char* file_name);
+
+
+/**
+ * is_hex_digit function checks whether a char is a hexadecimal digit, without branches.
+ *
+ * @param c - the char.
+ * @return - 1 if 'c' is a hexadecimal digit, otherwise 0 is returned.
+ */
+int is_hex_digit(int c);
+
+
+/**
+ * hex_digit_value function returns the value of a hexadecimal digit, without branches.
+ *
+ * @param c - the digit ('0'-'9', 'A'-'F' or 'a'-'f').
+ * @return - the value.
+ */
+int hex_digit_value(int c);
+
+
+/**
+ * next_decimal function adds 1 to a decimal number written as text (its length grows when all its digits are 9).
+ *
+ * @param text - the number (at least MAX_ADDRESS_DIGITS + 1 chars).
+ * @param len - an address of the length of the number, it grows when a digit is added.
+ */
+void next_decimal(char* text, int* len);
+
+
+/**
+ * parse_relocations function reads the contents of the '.rel' file of a module (see create_relocation_file function in 'memory_image.h') into
+ * its relocs array. The file must list exactly the 'R' / 'E' words of the '.ob' file, in the order of their addresses, with the same tags.
+ * A file that doesn't (left over from an older version of the module, for example) is ignored, and every word is checked when the module
+ * is relocated, so a stale '.rel' file can't leave words unrelocated.
+ *
+ * @param m - a pointer to the module (its words were parsed already).
+ * @param rel - the contents of the '.rel' file.
+ * @param rel_len - the length of 'rel'.
+ * @return - 1 if the '.rel' file matches the module, otherwise 0 is returned (relocs is left NULL).
+ */
+int parse_relocations(om_ptr m, const char* rel, size_t rel_len);
+
+
+/**
+ * parse_symbol_refs function creates the list of the lines of an '.ent' or '.ext' file ("LABEL ADDRESS" lines).
+ *
+ * @param text - the contents of the file.
+ * @param len - the length of 'text'.
+ * @param file_name - the name of the file, for error messages.
+ * @param head - the pointer to the head of the list to create.
+ * @return - 1 if all lines are valid, otherwise 0 is returned.
+ */
+int parse_symbol_refs(const char* text, size_t len, const char* file_name, sr_ptr* head);
+
+
+/**
+ * append_symbol_ref function adds a symbol reference to the end of a list.
+ *
+ * @param head - the pointer to the head of the list.
+ * @param curr - the pointer to the last node of the list (NULL if the list is empty), it's moved to the new node.
+ * @param label - the label.
+ * @param addr - the address.
+ * @param line - the line of the reference, for error messages.
+ */
+void append_symbol_ref(sr_ptr* head, sr_ptr* curr, const char* label, int addr, int line);
+
+
+/**
+ * next_text_line function copies the next line of a text in memory to 'line', without the newline char. Lines longer than 'size' - 1 are
+ * truncated.
+ *
+ * @param pos - the pointer to the position in the text, it's moved to the start of the next line.
+ * @param end - the end of the text.
+ * @param line - a string where to store the line.
+ * @param size - the size of 'line'.
+ * @return - 1 if a line was copied, 0 if the end of the text was reached.
+ */
+int next_text_line(const char** pos, const char* end, char* line, int size);
+
+
+/**
+ * read_whole_file function reads a whole file into memory.
+ *
+ * @param path - the name of the file.
+ * @param len - an address of a size_t where to store the length of the file.
+ * @return - the contents of the file (must be freed), or NULL if the file could not be opened.
+ */
+char* read_whole_file(const char* path, size_t* len);
+
+
+/**
+ * map_whole_file function maps a whole file to memory (read only), so a big file is read without copying it.
+ *
+ * @param path - the name of the file.
+ * @param len - an address of a size_t where to store the length of the file.
+ * @return - the contents of the file (must be released with unmap_whole_file function), or NULL if the file could not be opened.
+ */
+const char* map_whole_file(const char* path, size_t* len);
+
+
+/**
+ * unmap_whole_file function releases the contents of a file mapped with map_whole_file function.
+ *
+ * @param text - the contents of the file.
+ * @param len - the length of the file.
+ */
+void unmap_whole_file(const char* text, size_t len);
+
+
+/**
+ * module_file_name function creates the name of a file of a module.
+ *
+ * @param name - the name of the module.
+ * @param extension - the extension of the file.
+ * @return - the name of the file (must be freed).
+ */
+char* module_file_name(const char* name, const char* extension);
+
+
+/**
+ * relocate_address function returns the address in the linked image of an address in the module (code and data are placed separately, so an
+ * address in the code of the module moves by code_base and an address in its data moves by data_base).
+ *
+ * @param m - a pointer to the module.
+ * @param addr - the address in the module.
+ * @return - the address in the linked image.
+ */
+int relocate_address(om_ptr m, int addr);
+
+
+/**
+ * module_diagnostic_name function creates the name of the file errors of a module are reported in: the '.as' source file for modules
+ * assembled in memory, otherwise the file of the module with the given extension.
+ *
+ * @param m - a pointer to the module.
+ * @param extension - the extension of the file the error was found in (if the module was read from files).
+ * @return - the name of the file (allocated, must be freed by the caller).
+ */
+char* module_diagnostic_name(om_ptr m, const char* extension);
+
+
+/**
+ * link_error function prints an error found while linking and counts it.
+ *
+ * @param file_name - the name of the file where the error was found.
+ * @param line - the line in the file (0 if the error isn't related to a line).
+ * @param msg - the description of the error.
+ * @param label - the label the error is related to (NULL if none).
+ */
+void link_error(const char* file_name, int line, const char* msg, const char* label);
+
+
+/**
+ * were_link_errors function checks whether errors were found while linking.
+ *
+ * @return - the number of errors found.
+ */
+int were_link_errors();
+
+
+/**
+ * free_symbol_refs function frees a list of symbol references.
+ *
+ * @param head - the pointer to the head of the list.
+ */
+void free_symbol_refs(sr_ptr* head);
+
+
+/**
+ * free_object_modules function frees a list of modules.
+ *
+ * @param head - the pointer to the head of the list.
+ */
+void free_object_modules(om_ptr* head);
+
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * This file contains all functions related to writing the output files of a source file in the 'assembler' ('.ob', '.ent' and '.ext'), each on
+ * a thread of its own.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for threads */
+#include <pthread.h>
+#include "output_files.h"
+#include "emergency_free_mem.h"
+
+/* the images and the symbol table of the source file whose output files are written, they are only read by the threads */
+static mcl_ptr output_mcl = NULL;
+static mdl_ptr output_mdl = NULL;
+static symb_ptr output_symb = NULL;
+static int output_ic = 0;
+static int output_dc = 0;
+
+
+/**
+ * emit_output_files function creates the '.ob', '.ent' and '.ext' files of a source file, each on a thread of its own.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param head_symb_node - the pointer to the head-symbol-table-linked-list.
+ * @param fn - the name of the source file of which the output files are being created.
+ * @param IC - the total lines of code were processed.
+ * @param DC - the total lines of data were processed.
+ */
+void emit_output_files(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, symb_ptr head_symb_node, const char* fn, int IC, int DC)
+{
+	static const char* failures[OUTPUT_FILES_NUM] = {"Could not create object file.", "Could not create entries file.",
+		"Could not create externals file."};
+
+	pthread_t threads[OUTPUT_FILES_NUM];
+	int started[OUTPUT_FILES_NUM];
+	output_job jobs[OUTPUT_FILES_NUM];
+	int jobs_num;
+	int i;
+
+	output_mcl = head_mcl_node;
+	output_mdl = head_mdl_node;
+	output_symb = head_symb_node;
+	output_ic = IC;
+	output_dc = DC;
+
+	/* only the files the source file needs are created */
+	jobs_num = 0;
+	if(head_mcl_node != NULL || head_mdl_node != NULL) {
+		jobs[jobs_num].kind = OUTPUT_OB;
+		output_file_name(fn, OB_EXTENSION, jobs[jobs_num++].file_name);
+	}
+	if(was_entry_label_as_operand(head_symb_node)) {
+		jobs[jobs_num].kind = OUTPUT_ENT;
+		output_file_name(fn, ENT_EXTENSION, jobs[jobs_num++].file_name);
+	}
+	if(was_extern_label_as_operand(head_mcl_node)) {
+		jobs[jobs_num].kind = OUTPUT_EXT;
+		output_file_name(fn, EXT_EXTENSION, jobs[jobs_num++].file_name);
+	}
+
+	/* the first file is written by this thread, a file whose thread could not be created too */
+	for(i = 1; i < jobs_num; i++) {
+		started[i] = pthread_create(&threads[i], NULL, write_output_file, &jobs[i]) == 0;
+	}
+	for(i = 0; i < jobs_num; i++) {
+		if(i == 0 || !started[i]) {
+			write_output_file(&jobs[i]);
+		}
+	}
+	for(i = 1; i < jobs_num; i++) {
+		if(started[i]) {
+			pthread_join(threads[i], NULL);
+		}
+	}
+
+	for(i = 0; i < jobs_num; i++) {
+		if(!jobs[i].written) {
+			printf("%s\n", failures[jobs[i].kind]);
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+		printf("\nFile '%s' has been created successfully!", jobs[i].file_name);
+	}
+}
+
+
+/**
+ * write_output_file function writes one output file of the source file emit_output_files function is emitting.
+ *
+ * @param arg - a pointer to the output file.
+ * @return - NULL.
+ */
+void* write_output_file(void* arg)
+{
+	output_job* job;
+
+	job = (output_job*) arg;
+
+	switch(job -> kind)
+	{
+		case OUTPUT_OB:
+			if(is_parallel_ob_requested()) {
+				job -> written = write_object_file_mapped(output_mcl, output_mdl, job -> file_name, output_ic, output_dc);
+			}
+			else job -> written = write_image_hexa_file(output_mcl, output_mdl, job -> file_name, output_ic, output_dc);
+			break;
+
+		case OUTPUT_ENT:
+			job -> written = write_entry_file(output_symb, job -> file_name);
+			break;
+
+		default:
+			job -> written = write_extern_file(output_mcl, job -> file_name);
+			break;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * output_file_name function creates the name of an output file from the name of a source file.
+ *
+ * @param fn - the name of the source file.
+ * @param extension - the extension of the output file.
+ * @param file_name - a string where to store the name.
+ */
+void output_file_name(const char* fn, const char* extension, char* file_name)
+{
+	strcpy(file_name, fn);
+	file_name[strlen(file_name) - 3] = '\0'; /* remove .as extension */
+	strcat(file_name, extension);	/* add the extension */
+}
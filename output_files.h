@@ -0,0 +1,62 @@
+#ifndef OUTPUT_FILES_H
+#define OUTPUT_FILES_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "memory_image.h"
+#include "symbol_table.h"
+#include "ob_writer.h"
+#define OUTPUT_FILES_NUM 3	/* '.ob', '.ent' and '.ext' */
+#define MAX_OUTPUT_NAME_LENGTH (MAX_FILE_NAME_LENGTH + 5)	/* +1 for string terminator char, +4 for the longest extension */
+
+
+/* the output files of a source file that are written together */
+typedef enum {OUTPUT_OB, OUTPUT_ENT, OUTPUT_EXT} output_kind;
+
+
+/* a struct that represents an output file written by emit_output_files function on a thread of its own. The thread only writes the file, the
+ * result is printed (or the error is reported) by the main thread after all threads are done, in the order of output_kind enum */
+typedef struct output_job {
+	output_kind kind;
+	char file_name[MAX_OUTPUT_NAME_LENGTH];
+	int written;	/* 1 if the file was written, 0 if it could not be created */
+} output_job;
+
+
+/**
+ * emit_output_files function creates the '.ob', '.ent' and '.ext' files of a source file: the '.ob' file if the code or data image is not
+ * empty, the '.ent' file if an entry label was defined, and the '.ext' file if an external label was used. The files read only the code and
+ * data image and the symbol table, which don't change after the second pass, so they are written at the same time on separate threads: the
+ * time is the time of the largest file instead of the sum of all. The '.ob' file is written by write_object_file_mapped function with PARALLEL_OB_OPTION.
+ * This function must be called ONLY if no errors were found during the execution of the 'assembler'.
+ *
+ * @param head_mcl_node - the pointer to the code-image-head-linked-list.
+ * @param head_mdl_node - the pointer to the data-image-head-linked-list.
+ * @param head_symb_node - the pointer to the head-symbol-table-linked-list.
+ * @param fn - the name of the source file of which the output files are being created.
+ * @param IC - the total lines of code were processed.
+ * @param DC - the total lines of data were processed.
+ */
+void emit_output_files(mcl_ptr head_mcl_node, mdl_ptr head_mdl_node, symb_ptr head_symb_node, const char* fn, int IC, int DC);
+
+
+/**
+ * write_output_file function writes one output file of the source file emit_output_files function is emitting.
+ *
+ * @param arg - a pointer to the output file (output_job struct), the signature of a thread function.
+ * @return - NULL.
+ */
+void* write_output_file(void* arg);
+
+
+/**
+ * output_file_name function creates the name of an output file from the name of a source file.
+ *
+ * @param fn - the name of the source file ('.as').
+ * @param extension - the extension of the output file.
+ * @param file_name - a string where to store the name (at least MAX_OUTPUT_NAME_LENGTH chars).
+ */
+void output_file_name(const char* fn, const char* extension, char* file_name);
+
+
+#endif
@@ -6,6 +6,10 @@
  */
 
 #include "parser.h"
+#include "emergency_free_mem.h"
+
+static char** ext_tokens = NULL;	/* tokens array of extended mode, see get_tokens_buffer function */
+static int ext_tokens_size = 0;	/* the number of tokens ext_tokens can hold */
 
 /**
  * line_parser function parses the line and it returns it's type. see line-types in enum LINE_TYPE.
@@ -17,20 +21,20 @@
 LINE_TYPE line_parser(char* line, line_details* ld_ptr)
 {
 	/* variables definitions */
-	char* tokens[MAX_TOKENS];	/* all tokens of 'line' will be stored here for processing */
-	char concat_str[MAX_STRING_SIZE];	/* used to concatenate data/string tokens for processing */
+	char* std_tokens[MAX_TOKENS];	/* all tokens of 'line' will be stored here for processing (standard mode) */
+	char** tokens;	/* points to std_tokens, or to the growable tokens array in extended mode */
+	char* concat_str;	/* data/string tokens are concatenated in place into the first of them, this points to it */
 	int tkn_ctr;	/* tokens counter */
 	int tkn_ind;   /* token index */
 	int ops_num;	/* operands quantity found in line */
 	int LINE_HAS_LABEL;	/* a flag that indicated if line has a label */
-	char* data_tokens[MAX_DATA_TOKENS];	/* used to store here valid data tokens and pass them from here to 'handler.c' */
-	int data_tkn_num;	/* the quantity of valid data tokens found */
 
 	/* variables initializations */
 	ops curr_op = no_op;
 	tkn_ind = 0;
 	tkn_ctr = 0;
 	LINE_HAS_LABEL = 0;
+	tokens = is_extended_mode() ? get_tokens_buffer(strlen(line)) : std_tokens;
 
 
 	tkn_ctr = string_tokener(line, tokens);
@@ -166,10 +170,11 @@ LINE_TYPE line_parser(char* line, line_details* ld_ptr)
 	/* START - IF LINE IS GUIDANCE STRING LINE */
 	else if(is_string_line(tokens[tkn_ind])) {
 		tkn_ind++;
-		if(concat_string_tokens(tkn_ind, tkn_ctr-1, tokens, concat_str, &(ld_ptr -> err))) {
+		if(concat_string_tokens(tkn_ind, tkn_ctr-1, tokens, &(ld_ptr -> err))) {
+			concat_str = tokens[tkn_ind];
 			if(is_string(concat_str, &(ld_ptr -> err))) {
-				remove_string_marks(strlen(concat_str), concat_str);
-				strcpy(ld_ptr -> string, concat_str);
+				concat_str[strlen(concat_str) - 1] = '\0';	/* remove the closing quatation mark */
+				ld_ptr -> payload = concat_str + 1;	/* skip the opening quatation mark */
 				if(LINE_HAS_LABEL) {
 					return GUIDANCE_STRING_WITH_LABEL;
 				}
@@ -184,22 +189,85 @@ LINE_TYPE line_parser(char* line, line_details* ld_ptr)
 
 	/* START - IF LINE IS GUIDANCE DATA LINE */
 	else if(is_data_line(tokens[tkn_ind])) {
-		if(!concat_data_tokens(tkn_ind+1, tkn_ctr-1, tokens, concat_str, &(ld_ptr -> err))) {
+		if(!concat_data_tokens(tkn_ind+1, tkn_ctr-1, tokens, &(ld_ptr -> err))) {
 			return INVALID_LINE;
 		}
+		concat_str = tokens[tkn_ind+1];
 		if(is_data(concat_str, &(ld_ptr -> err))) {
-			split_data(concat_str, data_tokens, &data_tkn_num);
+			ld_ptr -> payload = concat_str;	/* 'handler.c' converts the numbers one by one straight into the data image */
+			if(LINE_HAS_LABEL) {
+				return GUIDANCE_DATA_WITH_LABEL;
+			}
+			else return GUIDANCE_DATA_WITHOUT_LABEL;
+		}
+		else return INVALID_LINE;
+	}
+	/* END - IF LINE IS GUIDANCE DATA LINE */
+
+
+	/* START - IF LINE IS GUIDANCE INCBIN LINE */
+	else if(is_incbin_line(tokens[tkn_ind])) {
+		tkn_ind++;
+		if(tkn_ind > tkn_ctr-1) {
+			ld_ptr -> err = MISSING_INFORMATION_AFTER_INCBIN;
+			return INVALID_LINE;
+		}
+		concat_string_tokens(tkn_ind, tkn_ctr-1, tokens, &(ld_ptr -> err));
+		concat_str = tokens[tkn_ind];
+		if(is_incbin(concat_str, &(ld_ptr -> incbin_bits), &(ld_ptr -> err))) {
+			ld_ptr -> payload = concat_str + 1;	/* the file name, without the opening quatation mark */
+			if(LINE_HAS_LABEL) {
+				return GUIDANCE_INCBIN_WITH_LABEL;
+			}
+			else return GUIDANCE_INCBIN_WITHOUT_LABEL;
+		}
+		else return INVALID_LINE;
+	}
+	/* END - IF LINE IS GUIDANCE INCBIN LINE */
+
 
-		copy_data(data_tkn_num, ld_ptr -> data, data_tokens);
-		ld_ptr -> num_in_data_array = data_tkn_num;
+	/* START - IF LINE IS INCLUDE LINE */
+	else if(is_include_line(tokens[tkn_ind])) {
 		if(LINE_HAS_LABEL) {
-			return GUIDANCE_DATA_WITH_LABEL;
+			ld_ptr -> err = LABEL_BEFORE_INCLUDE;
+			return INVALID_LINE;
 		}
-		else return GUIDANCE_DATA_WITHOUT_LABEL;
+		tkn_ind++;
+		if(tkn_ind > tkn_ctr-1) {
+			ld_ptr -> err = MISSING_INFORMATION_AFTER_INCLUDE;
+			return INVALID_LINE;
+		}
+		concat_string_tokens(tkn_ind, tkn_ctr-1, tokens, &(ld_ptr -> err));
+		concat_str = tokens[tkn_ind];
+		if(is_include(concat_str, &(ld_ptr -> err))) {
+			ld_ptr -> payload = concat_str + 1;	/* the file name, without the opening quatation mark */
+			return INCLUDE;
 		}
 		else return INVALID_LINE;
 	}
-	/* END - IF LINE IS GUIDANCE DATA LINE */
+	/* END - IF LINE IS INCLUDE LINE */
+
+
+	/* START - IF LINE IS GUIDANCE FILL / SPACE LINE */
+	else if(is_fill_line(tokens[tkn_ind])) {
+		if(tkn_ind+1 > tkn_ctr-1) {
+			ld_ptr -> err = MISSING_INFORMATION_AFTER_FILL;
+			return INVALID_LINE;
+		}
+		if(!concat_data_tokens(tkn_ind+1, tkn_ctr-1, tokens, &(ld_ptr -> err))) {
+			return INVALID_LINE;
+		}
+		concat_str = tokens[tkn_ind+1];
+		if(is_data(concat_str, &(ld_ptr -> err)) &&
+				is_fill(concat_str, strcmp(tokens[tkn_ind], SPACE_STR) == 0, &(ld_ptr -> fill_count), &(ld_ptr -> fill_value), &(ld_ptr -> err))) {
+			if(LINE_HAS_LABEL) {
+				return GUIDANCE_FILL_WITH_LABEL;
+			}
+			else return GUIDANCE_FILL_WITHOUT_LABEL;
+		}
+		else return INVALID_LINE;
+	}
+	/* END - IF LINE IS GUIDANCE FILL / SPACE LINE */
 
 	ld_ptr -> err = UNKNOWN_LINE;	/* if reached here, something went wrong */
 	return INVALID_LINE;
@@ -459,7 +527,7 @@ int is_string(char* str, ERR_VALUE* err)
 		return 0;
 	}
 
-	if(len > MAX_STRING_SIZE + 2) { /* 2 for the quatation marks */
+	if(!is_extended_mode() && len > MAX_STRING_SIZE + 2) { /* 2 for the quatation marks, no limit in extended mode */
 		*err = TOO_LONG_STRING;
 		return 0;
 	}
@@ -477,16 +545,7 @@ int is_string(char* str, ERR_VALUE* err)
  */
 ops is_operation(char* str)  /* ops is an enum defined in line_details.h */
 {
-	
-	static const char* operations[NUM_OF_OPERATIONS] = {"mov", "cmp", "add", "sub", "lea", "clr", "not", "inc", "dec", "jmp", "bne", "jsr", "red", "prn", "rts", "stop"};
-
-	int i;
-
-	for(i = 0; i < NUM_OF_OPERATIONS; i++)
-		if(strcmp(str, operations[i]) == 0)
-			return i;
-
-	return no_op;
+	return isa_find_mnemonic(str);
 }
 
 
@@ -518,7 +577,7 @@ int is_register(char* str)
  */
 int is_keyword(char* str)
 {
-	static const char* keywords[NUM_OF_KEYWORDS] = {"PSW", "data", "string", "entry", "extern"};
+	static const char* keywords[NUM_OF_KEYWORDS] = {"PSW", "data", "string", "incbin", "fill", "space", "include", "entry", "extern", "mcr", "endmcr"};
 
 	int i;
 
@@ -542,16 +601,18 @@ int is_keyword(char* str)
 int string_tokener(char* line, char** tokens)
 {
 	static const char line_delimit[] = " \t";
-	char* token;
 	int tkn_ctr;
 
-	token = strtok(line, line_delimit);
 	tkn_ctr = 0;
 
-	while(token != NULL) {
-		tokens[tkn_ctr] = token;
+	/* like strtok function, without its hidden state, so lines can be parsed on more than one thread (see 'pipeline.h') */
+	while(*(line += strspn(line, line_delimit)) != '\0') {
+		tokens[tkn_ctr] = line;
 		tkn_ctr++;
-		token = strtok(NULL, line_delimit);
+		line += strcspn(line, line_delimit);
+		if(*line != '\0') {
+			*line++ = '\0';
+		}
 	}
 
 	tokens[tkn_ctr-1][strlen(tokens[tkn_ctr-1])-1] = '\0';  /* last char in line is always /n (newline char), we replace it with string null terminator */
@@ -956,20 +1017,169 @@ int is_string_line(char* str)
 }
 
 
+/**
+ * is_incbin_line function checks whether 'str' is ".incbin".
+ *
+ * @param str - the string to check if it's ".incbin".
+ * @return - 1 is returned if 'str' is ".incbin", otherwise 0 is returned.
+ */
+int is_incbin_line(char* str)
+{
+	return strcmp(str, INCBIN_STR) == 0 ? 1 : 0;
+}
+
+
+/**
+ * is_incbin function checks if 'str' is a valid '.incbin' operand (a file name between quatation marks, optionally followed by ", 8" or ", 12").
+ *
+ * @param str - the potential '.incbin' operand.
+ * @param bits - an address of an integer where to store the size of the words in the file.
+ * @param err - a pointer to err (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
+ * @return - 1 if the operand is valid, otherwise 0 is returned.
+ */
+int is_incbin(char* str, int* bits, ERR_VALUE* err)
+{
+	char* end;
+
+	if(str[0] != '"' || (end = strchr(str + 1, '"')) == NULL || end == str + 1) {	/* file name must be between quatation marks */
+		*err = INCBIN_BAD_SYNTAX;
+		return 0;
+	}
+
+	*end = '\0';	/* file name starts at str + 1 */
+	end++;
+	while(*end == ' ') end++;
+
+	if(*end == '\0') {
+		*bits = 8;	/* the default word size */
+		return 1;
+	}
+
+	if(*end != ',') {
+		*err = INCBIN_BAD_SYNTAX;
+		return 0;
+	}
+	end++;
+	while(*end == ' ') end++;
+
+	if(strcmp(end, "8") == 0) {
+		*bits = 8;
+	}
+	else if(strcmp(end, "12") == 0) {
+		*bits = 12;
+	}
+	else {
+		*err = INCBIN_BAD_SYNTAX;
+		return 0;
+	}
+
+	return 1;
+}
+
+
+/**
+ * is_include_line function checks whether 'str' is ".include".
+ *
+ * @param str - the string to check if it's ".include".
+ * @return - 1 is returned if 'str' is ".include", otherwise 0 is returned.
+ */
+int is_include_line(char* str)
+{
+	return strcmp(str, INCLUDE_STR) == 0 ? 1 : 0;
+}
+
+
+/**
+ * is_include function checks if 'str' is a valid '.include' operand (a file name between quatation marks).
+ *
+ * @param str - the potential '.include' operand.
+ * @param err - a pointer to err (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
+ * @return - 1 if the operand is valid, otherwise 0 is returned.
+ */
+int is_include(char* str, ERR_VALUE* err)
+{
+	char* end;
+
+	if(str[0] != '"' || (end = strchr(str + 1, '"')) == NULL || end == str + 1 || *(end + 1) != '\0') {
+		*err = INCLUDE_BAD_SYNTAX;
+		return 0;
+	}
+
+	*end = '\0';	/* file name starts at str + 1 */
+	return 1;
+}
+
+
+/**
+ * is_fill_line function checks whether 'str' is ".fill" or ".space".
+ *
+ * @param str - the string to check if it's ".fill" or ".space".
+ * @return - 1 is returned if 'str' is ".fill" or ".space", otherwise 0 is returned.
+ */
+int is_fill_line(char* str)
+{
+	return (strcmp(str, FILL_STR) == 0 || strcmp(str, SPACE_STR) == 0) ? 1 : 0;
+}
+
+
+/**
+ * is_fill function checks if 'str' (a valid data, see is_data function) is a valid '.fill' / '.space' operand.
+ *
+ * @param str - the potential '.fill' / '.space' operand.
+ * @param is_space - 1 if the directive is '.space' (a value is not allowed), otherwise 0.
+ * @param count - an address of an integer where to store the number of words.
+ * @param val - an address of an integer where to store the value of the words.
+ * @param err - a pointer to err (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
+ * @return - 1 if the operand is valid, otherwise 0 is returned.
+ */
+int is_fill(char* str, int is_space, int* count, int* val, ERR_VALUE* err)
+{
+	char* end;
+	long words;
+
+	errno = 0;
+	words = strtol(str, &end, 10);
+	*count = 0;
+	*val = 0;	/* the default value */
+
+	if(errno == ERANGE || words < 0 || words > MAX_FILL_WORDS) {	/* a negative number of words, or more than the memory holds */
+		*err = INVALID_FILL;
+		return 0;
+	}
+	*count = (int) words;
+
+	if(*end == ',' && !is_space) {
+		*val = (int) strtol(end + 1, &end, 10);
+	}
+
+	if(*end != '\0') {	/* too many numbers */
+		*err = INVALID_FILL;
+		return 0;
+	}
+
+	return 1;
+}
+
+
 /**
  * concat_data_tokens function concatenating data tokens into one token.
+ * The tokens are concatenated in place, into the first data token (tkn_ptr[from]).
  *
  * @param from - the index of the first data token in the array of tokens.
  * @param to - the index of the last data token in the array of tokens.
  * @param tkn_ptr - the array of tokens (with the data tokens in it).
- * @param str - the string where to concatenate all the data tokens to.
  * @param err - a pointer to err (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
- * @return - 1 is returned if 'str' is ".string", otherwise 0 is returned.
+ * @return - 1 if all data tokens were valid, otherwise 0 is returned.
  */
-int concat_data_tokens(int from, int to, char** tkn_ptr, char* concat_str, ERR_VALUE* err)
+int concat_data_tokens(int from, int to, char** tkn_ptr, ERR_VALUE* err)
 {
+	char* concat_str;
+	int len;
+	int tkn_len;
+
 	if(from <= to) {
-		strcpy(concat_str, tkn_ptr[from]);
+		concat_str = tkn_ptr[from];
+		len = strlen(concat_str);
 		from++;
 	}
 	else {
@@ -978,16 +1188,18 @@ int concat_data_tokens(int from, int to, char** tkn_ptr, char* concat_str, ERR_V
 	}
 		
 	while(from <= to) {
-		if(concat_str[strlen(concat_str)-1] != ',' && tkn_ptr[from][0] != ',') {
+		if(concat_str[len-1] != ',' && tkn_ptr[from][0] != ',') {
 			*err = MISSING_COMMA_IN_DATA;
 			return 0;
 		}
-		else if (concat_str[strlen(concat_str)-1] == ',' && tkn_ptr[from][0] == ',') {
+		else if (concat_str[len-1] == ',' && tkn_ptr[from][0] == ',') {
 			*err = TOO_MANY_COMMAS_IN_DATA;
 			return 0;
 		}
-		/* if reached here, only one of the tokens has a comma */
-		strcat(concat_str, tkn_ptr[from]);
+		/* if reached here, only one of the tokens has a comma. tokens are in line order so moving them backwards is safe */
+		tkn_len = strlen(tkn_ptr[from]);
+		memmove(concat_str + len, tkn_ptr[from], tkn_len + 1);	/* +1 for the string terminator char */
+		len += tkn_len;
 		from++;
 	}
 	return 1;
@@ -996,21 +1208,23 @@ int concat_data_tokens(int from, int to, char** tkn_ptr, char* concat_str, ERR_V
 
 /**
  * concat_string_tokens function concatenating string tokens into one token.
+ * The tokens are concatenated in place, into the first string token (tkn_ptr[from]).
  *
  * @param from - the index of the first string token in the array of tokens.
  * @param num - the quantity of string tokens in they array of tokens.
  * @param tkn_ptr - the array of tokens (with the string tokens in it).
- * @param str - the string where to concatenate all the string tokens to.
  * @param err - a pointer to err (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
  * @return - 1 if all data tokens were valid, otherwise 0 is returned.
  */
-int concat_string_tokens(int from, int num, char** tkn_ptr, char* concat_str, ERR_VALUE* err)
+int concat_string_tokens(int from, int num, char** tkn_ptr, ERR_VALUE* err)
 {
-	static const char space[] = " ";
+	char* concat_str;
+	int len;
+	int tkn_len;
 
 	if(from <= num) {
-		strcpy(concat_str, tkn_ptr[from]);
-		strcat(concat_str, space);
+		concat_str = tkn_ptr[from];
+		len = strlen(concat_str);
 		from++;
 	}
 	else {
@@ -1019,72 +1233,58 @@ int concat_string_tokens(int from, int num, char** tkn_ptr, char* concat_str, ER
 	}
 
 	while(from <= num) {
-		strcat(concat_str, tkn_ptr[from]);
-		strcat(concat_str, space);
+		concat_str[len] = ' ';	/* only one space between 2 words */
+		len++;
+		tkn_len = strlen(tkn_ptr[from]);
+		memmove(concat_str + len, tkn_ptr[from], tkn_len + 1);	/* +1 for the string terminator char */
+		len += tkn_len;
 		from++;
 	}
-	concat_str[strlen(concat_str)-1] = '\0';
 	return 1;
 }
 
 
 /**
- * split_data function splits the 'data_token' into many data tokens.
+ * get_tokens_buffer function returns an array of strings big enough to hold all tokens of a line of 'line_len' characters.
+ * The array is used in extended mode, where lines have no length limit. It grows when needed and is reused between lines.
  *
- * @param str - the token to break to many data tokens.
- * @param data_tokens - an array of strings where to store the data tokens. (later on atoi function will convert it to integers).
- * @param num - an address of an integer where to store the number of data tokens stored.
+ * @param line_len - the length of the line to break into tokens.
+ * @return - the array of strings to store the tokens.
  */
-void split_data(char* concat_str, char** data_tokens, int* num)
+char** get_tokens_buffer(int line_len)
 {
-	static const char comma_delimit[] = ",";
-	char* data_token;
-	int data_tkn_ind;
-
-	data_token = strtok(concat_str, comma_delimit);
-	data_tkn_ind = 0;
+	int needed;
+	char** p;
 
-	while(data_token != NULL) {
-		data_tokens[data_tkn_ind] = data_token;
-		data_tkn_ind++;
-		data_token = strtok(NULL, comma_delimit);
-	}
-
-	*num = data_tkn_ind;
-}
+	needed = line_len / 2 + 2;	/* tokens are separated by at least one whitespace */
 
+	if(needed > ext_tokens_size) {
+		p = realloc(ext_tokens, sizeof(char*) * needed);
 
-/**
- * copy_data function converts data tokens to integers and copies them to 'arr' array.
- *
- * @param num - the number of data tokens to be converted to integers and copied to 'arr' array.
- * @param arr - copy the data tokens to this array.
- * @param data_tokens - an array of strings where the data tokens are stored.
- */
-void copy_data(int num, int* arr, char** data_tokens)
-{
-	int i;
-		for(i = 0; i < num; i++) {
-		arr[i] = atoi(data_tokens[i]);
+		/* verify if realloc worked as expected */
+		if(p == NULL)
+		{
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+		ext_tokens = p;
+		ext_tokens_size = needed;
 	}
+	return ext_tokens;
 }
 
 
 /**
- * remove_string_marks function removes the quatation marks from the begining and the end of the 'concat_str' string.
- *
- * @param len - the length of 'concat_str' string.
- * @param concat_str - quatation marks will be removed from this string.
+ * free_tokens_buffer function frees the extended mode tokens array (see get_tokens_buffer function).
  */
-void remove_string_marks(int len, char* concat_str)
+void free_tokens_buffer()
 {
-	int i;
-
-	for(i = 0; i < len; i++) {
-		concat_str[i] = concat_str[i+1];
+	if(ext_tokens != NULL) {
+		free(ext_tokens);
 	}
-
-	concat_str[len-2] = '\0';
+	ext_tokens = NULL;
+	ext_tokens_size = 0;
 }
 
 
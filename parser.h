@@ -6,11 +6,13 @@
 #include <string.h>
 #include <ctype.h>  /* for isdigit function */
 #include "line_details.h"
+#include "main_functions.h"	/* for is_extended_mode function */
+#include <errno.h>	/* for the range check of is_fill function */
+#include "isa.h"	/* for isa_find_mnemonic function, MEMORY_SIZE and FIRST_ADDRESS */
 #define NUM_OF_OPERATIONS 16
 #define NUM_OF_REGISTERS 8
 #define MAX_TOKENS 50
-#define MAX_DATA_TOKENS 40
-#define NUM_OF_KEYWORDS 5
+#define NUM_OF_KEYWORDS 11
 #define zero 48
 #define nine 57
 #define A 56
@@ -21,6 +23,11 @@
 #define EXTERN_STR ".extern"
 #define STRING_STR ".string"
 #define DATA_STR ".data"
+#define INCBIN_STR ".incbin"
+#define INCLUDE_STR ".include"
+#define FILL_STR ".fill"
+#define SPACE_STR ".space"
+#define MAX_FILL_WORDS (MEMORY_SIZE - FIRST_ADDRESS)	/* the most words '.fill' / '.space' can reserve, the free memory of an empty program */
 
 
 /**
@@ -110,7 +117,7 @@ int is_register(char* str);
 
 /**
  * is_keyword function checks whether 'str' is a one of the keywords.
- * All keywords are: PSW, data, string, entry, extern.
+ * All keywords are: PSW, data, string, incbin, fill, space, include, entry, extern, mcr, endmcr.
  *
  * @param str - the string to check if it's a keyword.
  * @return - 1 if 'str' is one of the registers, otherwise 0 is returned.
@@ -205,18 +212,86 @@ int is_data_line(char* str);
 int is_string_line(char* str);
 
 
+/**
+ * is_incbin_line function checks whether 'str' is ".incbin".
+ *
+ * @param str - the string to check if it's ".incbin".
+ * @return - 1 is returned if 'str' is ".incbin", otherwise 0 is returned.
+ */
+int is_incbin_line(char* str);
+
+
+/**
+ * is_incbin function checks if 'str' is a valid '.incbin' operand. 'str' is what comes after .incbin: a file name between quatation marks,
+ * optionally followed by a comma and the size of the words in the file (8 or 12, 8 is the default).
+ * If valid, the closing quatation mark is replaced with the string null terminator char so the file name starts at str + 1.
+ * In case the function detected a non valid operand, the corresponding err enum value is set to err param.
+ *
+ * @param str - the potential '.incbin' operand.
+ * @param bits - an address of an integer where to store the size of the words in the file.
+ * @param err - a pointer to err (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
+ * @return - 1 if the operand is valid, otherwise 0 is returned.
+ */
+int is_incbin(char* str, int* bits, ERR_VALUE* err);
+
+
+/**
+ * is_include_line function checks whether 'str' is ".include".
+ *
+ * @param str - the string to check if it's ".include".
+ * @return - 1 is returned if 'str' is ".include", otherwise 0 is returned.
+ */
+int is_include_line(char* str);
+
+
+/**
+ * is_include function checks if 'str' is a valid '.include' operand. 'str' is what comes after .include: a file name between quatation marks.
+ * If the operand is valid, the closing quatation mark is replaced with a string terminator char, so the file name starts at str + 1.
+ *
+ * @param str - the potential '.include' operand.
+ * @param err - a pointer to err (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
+ * @return - 1 if the operand is valid, otherwise 0 is returned.
+ */
+int is_include(char* str, ERR_VALUE* err);
+
+
+/**
+ * is_fill_line function checks whether 'str' is ".fill" or ".space".
+ *
+ * @param str - the string to check if it's ".fill" or ".space".
+ * @return - 1 is returned if 'str' is ".fill" or ".space", otherwise 0 is returned.
+ */
+int is_fill_line(char* str);
+
+
+/**
+ * is_fill function checks if 'str' is a valid '.fill' / '.space' operand. 'str' is the concatenated data after the directive:
+ * the number of words to reserve, and for '.fill' optionally a comma and the value of the words (0 is the default).
+ * The number of words must be between 0 and MAX_FILL_WORDS (how many of them fit after the code and data is checked by file_processor).
+ * In case the function detected a non valid operand, the corresponding err enum value is set to err param.
+ *
+ * @param str - the potential '.fill' / '.space' operand.
+ * @param is_space - 1 if the directive is '.space' (a value is not allowed), otherwise 0.
+ * @param count - an address of an integer where to store the number of words.
+ * @param val - an address of an integer where to store the value of the words.
+ * @param err - a pointer to err (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
+ * @return - 1 if the operand is valid, otherwise 0 is returned.
+ */
+int is_fill(char* str, int is_space, int* count, int* val, ERR_VALUE* err);
+
+
 /**
  * concat_data_tokens function concatenating data tokens into one token.
  * In case the function detected a non valid char/symbol while concatenating the tokens, the corresponding err enum value is set to err param.
+ * The tokens are concatenated in place, into the first data token (tkn_ptr[from]), so no extra buffer is needed whatever the length of the data.
  *
  * @param from - the index of the first data token in the array of tokens.
  * @param to - the index of the last data token in the array of tokens.
  * @param tkn_ptr - the array of tokens (with the data tokens in it).
- * @param str - the string where to concatenate all the data tokens to.
  * @param err - a pointer to err (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
  * @return - 1 if all data tokens were valid, otherwise 0 is returned.
  */
-int concat_data_tokens(int from, int to, char** tkn_ptr, char* concat_str, ERR_VALUE* err);
+int concat_data_tokens(int from, int to, char** tkn_ptr, ERR_VALUE* err);
 
 
 /**
@@ -224,45 +299,31 @@ int concat_data_tokens(int from, int to, char** tkn_ptr, char* concat_str, ERR_V
  * In case the function detected a non valid char/symbol while concatenating the tokens, the corresponding err enum value is set to err param.
  * The function removes all unnecessary spaces and tabs and leaves only one space/tab between 2 words (if there were many spaces/tabs). This is done
  * for better memory management.
+ * The tokens are concatenated in place, into the first string token (tkn_ptr[from]).
  *
  * @param from - the index of the first string token in the array of tokens.
  * @param num - the quantity of string tokens in they array of tokens.
  * @param tkn_ptr - the array of tokens (with the string tokens in it).
- * @param str - the string where to concatenate all the string tokens to.
  * @param err - a pointer to err (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
  * @return - 1 if all data tokens were valid, otherwise 0 is returned.
  */
-int concat_string_tokens(int from, int num, char** tkn_ptr, char* concat_str, ERR_VALUE* err);
+int concat_string_tokens(int from, int num, char** tkn_ptr, ERR_VALUE* err);
 
 
 /**
- * split_data function splits the 'data_token' into many data tokens. This function is called after the concatenating data token is valid and now
- * only inserting the data tokens to an array is needed.
+ * get_tokens_buffer function returns an array of strings big enough to hold all tokens of a line of 'line_len' characters.
+ * This function is used ONLY in extended mode, where lines have no length limit. The array grows when needed and it's reused between lines.
  *
- * @param str - the token to break to many data tokens.
- * @param data_tokens - an array of strings where to store the data tokens. (later on atoi function will convert it to integers).
- * @param num - an address of an integer where to store the number of data tokens stored.
+ * @param line_len - the length of the line to break into tokens.
+ * @return - the array of strings to store the tokens.
  */
-void split_data(char* concat_str, char** data_tokens, int* num);
+char** get_tokens_buffer(int line_len);
 
 
 /**
- * copy_data function converts data tokens to integers and copies them to 'arr' array.
- *
- * @param num - the number of data tokens to be converted to integers and copied to 'arr' array.
- * @param arr - copy the data tokens to this array.
- * @param data_tokens - an array of strings where the data tokens are stored.
- */
-void copy_data(int num, int* arr, char** data_tokens);
-
-
-/**
- * remove_string_marks function removes the quatation marks from the begining and the end of the 'concat_str' string.
- *
- * @param len - the length of 'concat_str' string.
- * @param concat_str - quatation marks will be removed from this string.
+ * free_tokens_buffer function frees the array of strings allocated by get_tokens_buffer function.
  */
-void remove_string_marks(int len, char* concat_str);
+void free_tokens_buffer();
 
 
 /**
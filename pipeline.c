@@ -0,0 +1,318 @@
+/**
+ * This file contains all functions related to the pipeline of the 'assembler' (PIPELINE_OPTION): the lines of the source file are read and
+ * parsed on two threads of their own while file_processor function processes the lines parsed before them. The stages pass batches of lines
+ * to each other in bounded queues.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for threads */
+#include "pipeline.h"
+#include "emergency_free_mem.h"
+
+static pipeline_batch* batches = NULL;	/* all batches of lines of the pipeline */
+static batch_ring free_batches;	/* the batches the reader stage can fill, given back by the encoder stage */
+static batch_ring read_batches;	/* the batches the reader stage filled, for the parser stage */
+static batch_ring parsed_batches;	/* the batches the parser stage parsed, for the encoder stage */
+static pthread_t reader_thread;
+static pthread_t parser_thread;
+
+
+/**
+ * start_pipeline function starts reading and parsing the source file on two threads of their own.
+ *
+ * @return - 1 if the pipeline was started, 0 if it could not be started.
+ */
+int start_pipeline()
+{
+	pipeline_batch* b;
+	int i;
+
+	if(is_extended_mode()) {
+		return 0;
+	}
+
+	batches = malloc(PIPELINE_BATCHES * sizeof(pipeline_batch));
+
+	/* verify if malloc worked as expected */
+	if(batches == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	init_ring(&free_batches);
+	init_ring(&read_batches);
+	init_ring(&parsed_batches);
+	for(i = 0; i < PIPELINE_BATCHES; i++) {
+		batches[i].errors = NULL;
+		batches[i].errors_size = 0;
+		put_batch(&free_batches, &batches[i]);
+	}
+
+	defer_preprocessor_errors(1);	/* the reader stage passes them with the lines */
+
+	if(pthread_create(&parser_thread, NULL, parse_stage, NULL) != 0) {
+		end_pipeline_stages(0);
+		return 0;
+	}
+
+	if(pthread_create(&reader_thread, NULL, read_stage, NULL) != 0) {	/* the parser stage gets an empty last batch, so it finishes */
+		b = take_batch(&free_batches);
+		b -> lines_num = 0;
+		b -> errors_num = 0;
+		b -> last = 1;
+		put_batch(&read_batches, b);
+		pthread_join(parser_thread, NULL);
+		end_pipeline_stages(0);
+		return 0;
+	}
+
+	return 1;
+}
+
+
+/**
+ * next_parsed_batch function returns the next batch of parsed lines of the source file, in order.
+ *
+ * @return - the batch.
+ */
+pipeline_batch* next_parsed_batch()
+{
+	return take_batch(&parsed_batches);
+}
+
+
+/**
+ * release_batch function gives a batch of lines back to the reader stage.
+ *
+ * @param b - the batch.
+ */
+void release_batch(pipeline_batch* b)
+{
+	put_batch(&free_batches, b);
+}
+
+
+/**
+ * end_pipeline function waits for the stages of the pipeline to finish and frees the batches.
+ */
+void end_pipeline()
+{
+	end_pipeline_stages(1);
+}
+
+
+/**
+ * end_pipeline_stages function frees the batches and the queues of the pipeline.
+ *
+ * @param started - 1 if the threads of the stages were started (they are waited for), otherwise 0.
+ */
+void end_pipeline_stages(int started)
+{
+	int i;
+
+	if(started) {
+		pthread_join(reader_thread, NULL);
+		pthread_join(parser_thread, NULL);
+	}
+
+	defer_preprocessor_errors(0);
+	destroy_ring(&free_batches);
+	destroy_ring(&read_batches);
+	destroy_ring(&parsed_batches);
+
+	for(i = 0; i < PIPELINE_BATCHES; i++) {
+		free(batches[i].errors);
+	}
+	free(batches);
+	batches = NULL;
+}
+
+
+/**
+ * read_stage function is the reader stage of the pipeline.
+ *
+ * @param arg - not used.
+ * @return - NULL.
+ */
+void* read_stage(void* arg)
+{
+	pipeline_batch* b;
+	char* line;
+	int last;
+
+	do {
+		b = take_batch(&free_batches);
+		b -> lines_num = 0;
+		b -> errors_num = 0;
+		b -> last = 0;
+
+		while(b -> lines_num < PIPELINE_BATCH_LINES)
+		{
+			line = next_line(&(b -> line_nums[b -> lines_num]));
+			add_batch_errors(b);	/* the errors found while the line was read come before it */
+			if(line == NULL) {
+				b -> last = 1;
+				break;
+			}
+			strcpy(b -> lines[b -> lines_num], line);	/* the line buffer of the preprocessor is used again by the next line */
+			b -> lines_num++;
+		}
+
+		last = b -> last;	/* the batch belongs to the next stage once it's put */
+		put_batch(&read_batches, b);
+	} while(!last);
+
+	return NULL;
+}
+
+
+/**
+ * parse_stage function is the parser stage of the pipeline.
+ *
+ * @param arg - not used.
+ * @return - NULL.
+ */
+void* parse_stage(void* arg)
+{
+	pipeline_batch* b;
+	line_details ld;	/* kept from line to line, like the line_details struct of file_processor function */
+	int last;
+	int i;
+
+	memset(&ld, 0, sizeof(line_details));
+	ld.src_adr = no_type;
+	ld.dest_adr = no_type;
+
+	do {
+		b = take_batch(&read_batches);
+
+		for(i = 0; i < b -> lines_num; i++)
+		{
+			ld.err = NO_ERRORS;  /* make sure its initialized as NO_ERRORS */
+			b -> types[i] = line_parser(b -> lines[i], &ld);
+			b -> details[i] = ld;
+		}
+
+		last = b -> last;
+		put_batch(&parsed_batches, b);
+	} while(!last);
+
+	return NULL;
+}
+
+
+/**
+ * add_batch_errors function adds the errors the preprocessor found since the last line to a batch.
+ *
+ * @param b - the batch.
+ */
+void add_batch_errors(pipeline_batch* b)
+{
+	preprocessor_error* errors;
+	batch_error* p;
+	int errors_num;
+	int i;
+
+	errors = take_preprocessor_errors(&errors_num);
+
+	for(i = 0; i < errors_num; i++)
+	{
+		if(b -> errors_num == b -> errors_size)
+		{
+			p = realloc(b -> errors, (b -> errors_size == 0 ? DEFERRED_ERRORS_INITIAL_SIZE : b -> errors_size * 2) * sizeof(batch_error));
+
+			/* verify if realloc worked as expected */
+			if(p == NULL)
+			{
+				fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+				emergency_free_mem();
+				exit(EXIT_FAILURE);
+			}
+
+			b -> errors = p;
+			b -> errors_size = b -> errors_size == 0 ? DEFERRED_ERRORS_INITIAL_SIZE : b -> errors_size * 2;
+		}
+
+		b -> errors[b -> errors_num].before = b -> lines_num;
+		b -> errors[b -> errors_num].line = errors[i].line;
+		b -> errors[b -> errors_num].err = errors[i].err;
+		b -> errors_num++;
+	}
+}
+
+
+/**
+ * init_ring function creates an empty queue of batches.
+ *
+ * @param ring - a pointer to the queue.
+ */
+void init_ring(batch_ring* ring)
+{
+	ring -> first = 0;
+	ring -> count = 0;
+	pthread_mutex_init(&(ring -> lock), NULL);
+	pthread_cond_init(&(ring -> changed), NULL);
+}
+
+
+/**
+ * destroy_ring function frees the lock of a queue of batches.
+ *
+ * @param ring - a pointer to the queue.
+ */
+void destroy_ring(batch_ring* ring)
+{
+	pthread_mutex_destroy(&(ring -> lock));
+	pthread_cond_destroy(&(ring -> changed));
+}
+
+
+/**
+ * put_batch function puts a batch in a queue, it waits while the queue is full.
+ *
+ * @param ring - a pointer to the queue.
+ * @param b - the batch.
+ */
+void put_batch(batch_ring* ring, pipeline_batch* b)
+{
+	pthread_mutex_lock(&(ring -> lock));
+	while(ring -> count == PIPELINE_BATCHES) {
+		pthread_cond_wait(&(ring -> changed), &(ring -> lock));
+	}
+
+	ring -> slots[(ring -> first + ring -> count) % PIPELINE_BATCHES] = b;
+	ring -> count++;
+
+	pthread_cond_signal(&(ring -> changed));	/* only one thread takes from the queue, and it's the only one that can wait now */
+	pthread_mutex_unlock(&(ring -> lock));
+}
+
+
+/**
+ * take_batch function takes the oldest batch out of a queue, it waits while the queue is empty.
+ *
+ * @param ring - a pointer to the queue.
+ * @return - the batch.
+ */
+pipeline_batch* take_batch(batch_ring* ring)
+{
+	pipeline_batch* b;
+
+	pthread_mutex_lock(&(ring -> lock));
+	while(ring -> count == 0) {
+		pthread_cond_wait(&(ring -> changed), &(ring -> lock));
+	}
+
+	b = ring -> slots[ring -> first];
+	ring -> first = (ring -> first + 1) % PIPELINE_BATCHES;
+	ring -> count--;
+
+	pthread_cond_signal(&(ring -> changed));	/* only one thread puts in the queue, and it's the only one that can wait now */
+	pthread_mutex_unlock(&(ring -> lock));
+
+	return b;
+}
@@ -0,0 +1,150 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include <pthread.h>
+#include "line_details.h"
+#include "preprocessor.h"	/* for next_line function and MAX_BUFFER_LENGTH, includes 'parser.h' for line_parser function */
+#define PIPELINE_BATCH_LINES 256	/* the number of lines that are passed from one stage of the pipeline to the next at once */
+#define PIPELINE_BATCHES 8	/* the number of batches of lines, so no stage gets more than PIPELINE_BATCHES batches ahead of the next one */
+
+
+/* a struct that represents an error of the preprocessor in a batch of lines */
+typedef struct batch_error {
+	int before;	/* the index of the line the error comes before (lines_num for the errors found after the last line) */
+	int line;	/* the line in the source file where the error has occurred */
+	ERR_VALUE err;
+} batch_error;
+
+
+/* a struct that represents a batch of lines of the source file in the pipeline: the reader stage fills the lines and the errors of the
+ * preprocessor, the parser stage fills the line_details of the lines, and the encoder stage (file_processor function) processes them */
+typedef struct pipeline_batch {
+	char lines[PIPELINE_BATCH_LINES][MAX_BUFFER_LENGTH];	/* copies of the lines next_line function returned */
+	int line_nums[PIPELINE_BATCH_LINES];	/* the line number of every line, like next_line function stored it */
+	line_details details[PIPELINE_BATCH_LINES];	/* the line_details struct of every line, like line_parser function filled it */
+	LINE_TYPE types[PIPELINE_BATCH_LINES];	/* the result of line_parser function for every line */
+	int lines_num;
+	batch_error* errors;	/* the errors of the preprocessor found while the lines were read, in order */
+	int errors_num;
+	int errors_size;	/* the number of errors there is room for */
+	int last;	/* 1 if the end of the source file was reached in this batch */
+} pipeline_batch;
+
+
+/* a struct that represents a bounded queue of batches between two stages: one thread puts batches in and one thread takes them out, in order */
+typedef struct batch_ring {
+	pipeline_batch* slots[PIPELINE_BATCHES];
+	int first;	/* the index of the oldest batch in the queue */
+	int count;	/* the number of batches in the queue */
+	pthread_mutex_t lock;
+	pthread_cond_t changed;	/* signaled when a batch is put in or taken out */
+} batch_ring;
+
+
+/**
+ * start_pipeline function starts reading and parsing the source file the preprocessor was started with (see start_preprocessor function) on
+ * two threads of their own: the reader stage gets the lines with next_line function, and the parser stage parses them with line_parser
+ * function. The batches of lines are passed between the stages in bounded queues, and the parsed batches are taken in order with
+ * next_parsed_batch function. The lines and their line_details are the same as the serial loop of file_processor function gets, and the errors
+ * of the preprocessor are passed with the lines (see defer_preprocessor_errors function), so they can be added in the same order.
+ * Extended mode has no length limit for lines, so it is not supported: the serial loop is used.
+ *
+ * @return - 1 if the pipeline was started, 0 if it could not be started (nothing was read yet, the serial loop should be used).
+ */
+int start_pipeline();
+
+
+/**
+ * next_parsed_batch function returns the next batch of parsed lines of the source file, in order. It waits until the batch is parsed.
+ *
+ * @return - the batch, it must be given back with release_batch function after its lines are processed.
+ */
+pipeline_batch* next_parsed_batch();
+
+
+/**
+ * release_batch function gives a batch of lines back to the reader stage, so it can be filled again.
+ *
+ * @param b - the batch.
+ */
+void release_batch(pipeline_batch* b);
+
+
+/**
+ * end_pipeline function waits for the stages of the pipeline to finish and frees the batches. It must be called after the last batch (the one
+ * whose 'last' is 1) was released.
+ */
+void end_pipeline();
+
+
+/**
+ * end_pipeline_stages function frees the batches and the queues of the pipeline, and stops deferring the errors of the preprocessor.
+ *
+ * @param started - 1 if the threads of the stages were started (they are waited for), otherwise 0.
+ */
+void end_pipeline_stages(int started);
+
+
+/**
+ * read_stage function is the reader stage of the pipeline: it fills the batches with the lines of the source file.
+ *
+ * @param arg - not used, the signature of a thread function.
+ * @return - NULL.
+ */
+void* read_stage(void* arg);
+
+
+/**
+ * parse_stage function is the parser stage of the pipeline: it parses the lines of the batches the reader stage filled.
+ *
+ * @param arg - not used, the signature of a thread function.
+ * @return - NULL.
+ */
+void* parse_stage(void* arg);
+
+
+/**
+ * add_batch_errors function adds the errors the preprocessor found since the last line to a batch.
+ *
+ * @param b - the batch.
+ */
+void add_batch_errors(pipeline_batch* b);
+
+
+/**
+ * init_ring function creates an empty queue of batches.
+ *
+ * @param ring - a pointer to the queue.
+ */
+void init_ring(batch_ring* ring);
+
+
+/**
+ * destroy_ring function frees the lock of a queue of batches.
+ *
+ * @param ring - a pointer to the queue.
+ */
+void destroy_ring(batch_ring* ring);
+
+
+/**
+ * put_batch function puts a batch in a queue, it waits while the queue is full.
+ *
+ * @param ring - a pointer to the queue.
+ * @param b - the batch.
+ */
+void put_batch(batch_ring* ring, pipeline_batch* b);
+
+
+/**
+ * take_batch function takes the oldest batch out of a queue, it waits while the queue is empty.
+ *
+ * @param ring - a pointer to the queue.
+ * @return - the batch.
+ */
+pipeline_batch* take_batch(batch_ring* ring);
+
+
+#endif
@@ -0,0 +1,629 @@
+/**
+ * This file contains all functions and information related to reading the source file and expanding its macros in the 'assembler'.
+ * 'handler.c' gets every line of the source file from next_line function. Macro definitions are stored in a hash table (the macro table) and
+ * macro calls are expanded line by line while they're read, so the expanded file is never stored in memory. If requested, every expanded line
+ * is also written to the '.am' file.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "preprocessor.h"
+#include "emergency_free_mem.h"
+
+static FILE* src_fp = NULL;	/* the source file currently read */
+static const char* src_fn = NULL;	/* the name of the source file currently read */
+static FILE* am_fp = NULL;	/* the expanded ('.am') file, NULL if it wasn't requested */
+static char* am_fn = NULL;	/* the name of the expanded file */
+static int src_line;	/* the number of the last line read from the source file */
+static char line_buffer[MAX_BUFFER_LENGTH];	/* standard mode line buffer */
+static char* long_buffer = NULL;	/* extended mode line buffer, it grows to the length of the longest line (see read_long_line function) */
+static int long_buffer_size = 0;	/* the size of long_buffer */
+static macro_ptr macro_table[MACRO_TABLE_SIZE];	/* the macro table, each bucket is a list of macros */
+static int macros_num = 0;	/* the number of macros in the macro table */
+static ml_ptr expanding = NULL;	/* the next line of the macro currently expanded, NULL if no macro is expanded */
+static int expanding_line;	/* the line of the macro call currently expanded */
+static int errors_deferred = 0;	/* 1 if the errors are kept for the pipeline instead of added (see defer_preprocessor_errors function) */
+static preprocessor_error* deferred_errors = NULL;	/* the errors kept since the last call to take_preprocessor_errors function */
+static int deferred_num = 0;	/* the number of errors in deferred_errors */
+static int deferred_size = 0;	/* the number of errors deferred_errors can hold */
+
+
+/**
+ * start_preprocessor function prepares the preprocessor to read the lines of a new source file.
+ *
+ * @param fp - the pointer to the source file.
+ * @param fn - the name of the source file.
+ */
+void start_preprocessor(FILE* fp, const char* fn)
+{
+	src_fp = fp;
+	src_fn = fn;
+	src_line = 0;
+	expanding = NULL;
+
+	if(is_am_file_requested()) {
+		am_fn = malloc(strlen(fn) + 1);	/* .am extension is as long as .as extension, +1 for string terminator char */
+
+		/* verify if malloc worked as expected */
+		if(am_fn == NULL)
+		{
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+
+		strcpy(am_fn, fn);
+		am_fn[strlen(am_fn) - 3] = '\0'; /* remove .as extension */
+		strcat(am_fn, AM_EXTENSION);	/* add .am extension */
+
+		am_fp = fopen(am_fn, "w+");
+
+		if(am_fp == NULL) {
+			printf("Could not create expanded source file.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+
+/**
+ * next_line function returns the next line of the source file, after macro expansion.
+ *
+ * @param line_num - an address of an integer where to store the line number (in the source file) of the line.
+ * @return - the next line, or NULL if end of file was reached.
+ */
+char* next_line(int* line_num)
+{
+	char first[MAX_OPERAND_AND_LABEL_LENGTH + 2];	/* +1 to detect a too long macro name, +1 for string terminator char */
+	char second[MAX_OPERAND_AND_LABEL_LENGTH + 2];
+	char* line;
+	int tkn_num;
+	macro_ptr m;
+
+	while(1)
+	{
+		if(expanding != NULL) {	/* next line of the macro currently expanded, copied since the parser changes the line */
+			if(is_extended_mode()) {
+				grow_line_buffer(&long_buffer, &long_buffer_size, strlen(expanding -> line) + 1);
+				line = long_buffer;
+			}
+			else line = line_buffer;
+			strcpy(line, expanding -> line);
+			expanding = expanding -> next;
+			*line_num = expanding_line;
+			break;
+		}
+
+		line = read_source_line();
+		if(line == NULL) {
+			return NULL;
+		}
+		*line_num = src_line;
+
+		tkn_num = peek_tokens(line, first, second, sizeof(first));
+
+		if(tkn_num >= 1 && strcmp(first, MACRO_START) == 0) {	/* a macro definition */
+			define_macro(tkn_num, second);
+			continue;
+		}
+
+		if(tkn_num == 1 && macros_num > 0 && (m = find_macro(first)) != NULL) {	/* a macro call */
+			expanding = m -> body_head;
+			expanding_line = src_line;
+			continue;
+		}
+		break;
+	}
+
+	if(am_fp != NULL) {
+		fputs(line, am_fp);
+	}
+
+	return line;
+}
+
+
+/**
+ * end_preprocessor function frees the macro table and the line buffers and closes the '.am' file (if created).
+ */
+void end_preprocessor()
+{
+	free_macros();
+	free_long_buffer();
+	expanding = NULL;
+	free(deferred_errors);
+	deferred_errors = NULL;
+	deferred_num = 0;
+	deferred_size = 0;
+	errors_deferred = 0;
+	src_fp = NULL;
+	src_fn = NULL;
+
+	if(am_fp != NULL) {
+		fclose(am_fp);
+		printf("\nFile '%s' has been created successfully!", am_fn);
+	}
+	am_fp = NULL;
+
+	if(am_fn != NULL) {
+		free(am_fn);
+	}
+	am_fn = NULL;
+}
+
+
+/**
+ * defer_preprocessor_errors function chooses whether the errors of the preprocessor are added to the errors list when they're found, or kept
+ * until they're taken with take_preprocessor_errors function.
+ *
+ * @param deferred - 1 to keep the errors, 0 to add them.
+ */
+void defer_preprocessor_errors(int deferred)
+{
+	errors_deferred = deferred;
+}
+
+
+/**
+ * take_preprocessor_errors function returns the errors kept since its last call, and forgets them.
+ *
+ * @param errors_num - a pointer to where to store the number of errors.
+ * @return - the errors, valid until the next call to next_line function.
+ */
+preprocessor_error* take_preprocessor_errors(int* errors_num)
+{
+	*errors_num = deferred_num;
+	deferred_num = 0;
+
+	return deferred_errors;
+}
+
+
+/**
+ * report_preprocessor_error function adds an error of the preprocessor to the errors list, or keeps it (see defer_preprocessor_errors function).
+ *
+ * @param ln - the line in the source file where the error has occurred.
+ * @param err - the enum value of the error.
+ */
+void report_preprocessor_error(int ln, ERR_VALUE err)
+{
+	preprocessor_error* errors;
+
+	if(!errors_deferred) {
+		error_controller(ln, err, src_fn);
+		return;
+	}
+
+	if(deferred_num == deferred_size)
+	{
+		errors = realloc(deferred_errors, (deferred_size == 0 ? DEFERRED_ERRORS_INITIAL_SIZE : deferred_size * 2) * sizeof(preprocessor_error));
+
+		/* verify if realloc worked as expected */
+		if(errors == NULL)
+		{
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+
+		deferred_errors = errors;
+		deferred_size = deferred_size == 0 ? DEFERRED_ERRORS_INITIAL_SIZE : deferred_size * 2;
+	}
+
+	deferred_errors[deferred_num].line = ln;
+	deferred_errors[deferred_num].err = err;
+	deferred_num++;
+}
+
+
+/**
+ * read_source_line function reads the next line of the source file, without macro expansion.
+ *
+ * @return - the line read, or NULL if end of file was reached.
+ */
+char* read_source_line()
+{
+	char* line;
+	int line_len;
+
+	while((line = is_extended_mode() ? read_long_line(src_fp, &long_buffer, &long_buffer_size) : fgets(line_buffer, MAX_BUFFER_LENGTH, src_fp)) != NULL)
+	{
+		src_line++;
+
+		/* START - line length handling */
+		if(!feof(src_fp) && !is_extended_mode()) {	/* no line length limit in extended mode */
+			line_len = strlen(line);
+			if(is_long_line(line_len, count_whitespaces(line))) {
+				report_preprocessor_error(src_line, LONG_LINE);  /* add error */
+				if(!is_line_ending_with_newline_char(line, line_len)) {
+					find_next_line(&src_fp);  /* line is too long, find where next line starts */
+				}
+				continue;
+			}
+		}
+		/* END - line length handling */
+
+		return line;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * define_macro function stores a macro definition in the macro table.
+ *
+ * @param tkn_num - the number of tokens in the "mcr" line.
+ * @param name - the name of the macro (the second token of the "mcr" line).
+ */
+void define_macro(int tkn_num, char* name)
+{
+	char first[sizeof(MACRO_END) + 1];	/* long enough to tell "endmcr" from longer tokens */
+	char second[sizeof(MACRO_END) + 1];
+	ERR_VALUE err;
+	int def_line;
+	char* line;
+	macro_ptr m;
+
+	err = NO_ERRORS;
+	def_line = src_line;
+	m = NULL;
+
+	if(tkn_num != 2 || !is_label(name, &err)) {
+		report_preprocessor_error(def_line, INVALID_MACRO_NAME);  /* add error */
+	}
+	else if(find_macro(name) != NULL) {
+		report_preprocessor_error(def_line, DUPLICATE_MACRO_NAME);  /* add error */
+	}
+	else {
+		m = insert_macro(name);
+	}
+
+	while((line = read_source_line()) != NULL)
+	{
+		if(peek_tokens(line, first, second, sizeof(first)) >= 1 && strcmp(first, MACRO_END) == 0) {
+			return;
+		}
+
+		if(m != NULL) {
+			add_macro_line(m, line);
+		}
+	}
+
+	report_preprocessor_error(def_line, MISSING_ENDMCR);  /* end of file was reached inside the definition */
+}
+
+
+/**
+ * peek_tokens function copies the first 2 tokens of the line to 'first' and 'second' without changing the line.
+ *
+ * @param line - the line.
+ * @param first - a string where to store the first token.
+ * @param second - a string where to store the second token.
+ * @param size - the size of 'first' and 'second'.
+ * @return - the number of tokens in the line, 3 is returned if there are 3 tokens or more.
+ */
+int peek_tokens(const char* line, char* first, char* second, int size)
+{
+	int tkn_num;
+	int len;
+	char* dest;
+
+	tkn_num = 0;
+	first[0] = '\0';
+	second[0] = '\0';
+
+	while(tkn_num < 3)
+	{
+		while(*line == ' ' || *line == '\t' || *line == '\n') line++;  /* skip whitespaces */
+		if(*line == '\0') {
+			break;
+		}
+
+		dest = (tkn_num == 0) ? first : (tkn_num == 1) ? second : NULL;
+		len = 0;
+		while(*line != '\0' && *line != ' ' && *line != '\t' && *line != '\n') {
+			if(dest != NULL && len < size - 1) {
+				dest[len] = *line;
+				len++;
+			}
+			line++;
+		}
+
+		if(dest != NULL) {
+			dest[len] = '\0';
+		}
+		tkn_num++;
+	}
+
+	return tkn_num;
+}
+
+
+/**
+ * macro_hash function returns the bucket of the macro table for 'name'.
+ *
+ * @param name - the name of the macro.
+ * @return - the index of the bucket.
+ */
+unsigned int macro_hash(const char* name)
+{
+	unsigned int h;
+
+	h = 5381;
+	while(*name != '\0') {
+		h = h * 33 + (unsigned char) *name;
+		name++;
+	}
+
+	return h % MACRO_TABLE_SIZE;
+}
+
+
+/**
+ * find_macro function searches for a macro in the macro table.
+ *
+ * @param name - the name of the macro.
+ * @return - a pointer to the macro if found, otherwise NULL is returned.
+ */
+macro_ptr find_macro(const char* name)
+{
+	macro_ptr m;
+
+	m = macro_table[macro_hash(name)];
+
+	while(m != NULL)
+	{
+		if(strcmp(m -> name, name) == 0) {
+			return m;
+		}
+		m = m -> next;
+	}
+	return NULL;
+}
+
+
+/**
+ * insert_macro function creates a macro with an empty body and adds it to the macro table.
+ *
+ * @param name - the name of the macro.
+ * @return - a pointer to the macro created.
+ */
+macro_ptr insert_macro(const char* name)
+{
+	macro_ptr m;
+	unsigned int h;
+
+	m = malloc(sizeof(macro));
+
+	/* verify if malloc worked as expected */
+	if(m == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	m -> name = malloc(strlen(name) + 1);	/* +1 for the null terminator char */
+
+	/* verify if malloc worked as expected */
+	if(m -> name == NULL)
+	{
+		free(m);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	strcpy(m -> name, name);
+	m -> body_head = NULL;
+	m -> body_curr = NULL;
+
+	/* add to the head of the bucket */
+	h = macro_hash(name);
+	m -> next = macro_table[h];
+	macro_table[h] = m;
+	macros_num++;
+
+	return m;
+}
+
+
+/**
+ * add_macro_line function adds a copy of 'line' to the end of the body of the macro.
+ *
+ * @param m - a pointer to the macro.
+ * @param line - the line to add.
+ */
+void add_macro_line(macro_ptr m, const char* line)
+{
+	ml_ptr p;
+
+	p = malloc(sizeof(macro_line));
+
+	/* verify if malloc worked as expected */
+	if(p == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	p -> line = malloc(strlen(line) + 1);	/* +1 for the null terminator char */
+
+	/* verify if malloc worked as expected */
+	if(p -> line == NULL)
+	{
+		free(p);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	strcpy(p -> line, line);
+	p -> next = NULL;
+
+	/* if body is still empty */
+	if(m -> body_head == NULL)
+	{
+		m -> body_head = p;
+		m -> body_curr = p;
+	}
+
+	/* if body is not empty */
+	else
+	{
+		m -> body_curr -> next = p;
+		m -> body_curr = p;
+	}
+}
+
+
+/**
+ * free_macros function frees all macros in the macro table.
+ */
+void free_macros()
+{
+	macro_ptr m;
+	ml_ptr p;
+	int i;
+
+	for(i = 0; i < MACRO_TABLE_SIZE && macros_num > 0; i++)
+	{
+		while(macro_table[i] != NULL)
+		{
+			m = macro_table[i];
+			macro_table[i] = m -> next;
+
+			while(m -> body_head != NULL)
+			{
+				p = m -> body_head;
+				m -> body_head = p -> next;
+				free(p -> line);
+				free(p);
+			}
+
+			free(m -> name);
+			free(m);
+			macros_num--;
+		}
+	}
+}
+
+
+/**
+ * find_next_line function finds where the new line starts at.
+ *
+ * @param fp - the pointer to the pointer which points to the file.
+ */
+void find_next_line(FILE** fp)
+{
+	char ch;
+
+	while(1) {  /* Find the new line (or EOF) */
+		ch = fgetc(*fp);
+		if(ch == EOF || ch == '\n')
+			break;
+	}
+}
+
+
+/**
+ * read_long_line function reads a whole line of any length from the file into 'buffer', the buffer grows as needed.
+ *
+ * @param fp - the pointer to the file.
+ * @param buffer - the pointer to the buffer (NULL if not allocated yet).
+ * @param buffer_size - the pointer to the size of the buffer.
+ * @return - the line read (including the newline char if it exists), or NULL if end of file was reached.
+ */
+char* read_long_line(FILE* fp, char** buffer, int* buffer_size)
+{
+	int len;
+
+	len = 0;
+	grow_line_buffer(buffer, buffer_size, MAX_BUFFER_LENGTH);
+
+	while(fgets(*buffer + len, *buffer_size - len, fp) != NULL)
+	{
+		len += strlen(*buffer + len);
+		if((*buffer)[len-1] == '\n') {
+			return *buffer;
+		}
+
+		if(len == *buffer_size - 1) {	/* buffer is full and line hasn't ended yet */
+			grow_line_buffer(buffer, buffer_size, *buffer_size * 2);
+		}
+	}
+
+	return len ? *buffer : NULL;	/* last line of the file may not end with a newline char */
+}
+
+
+/**
+ * grow_line_buffer function makes sure a line buffer can hold at least 'size' characters.
+ *
+ * @param buffer - the pointer to the buffer (NULL if not allocated yet).
+ * @param buffer_size - the pointer to the size of the buffer.
+ * @param size - the needed size of the buffer.
+ */
+void grow_line_buffer(char** buffer, int* buffer_size, int size)
+{
+	char* p;
+
+	if(size <= *buffer_size) {
+		return;
+	}
+
+	p = realloc(*buffer, size);
+
+	/* verify if realloc worked as expected */
+	if(p == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+	*buffer = p;
+	*buffer_size = size;
+}
+
+
+/**
+ * free_long_buffer function frees the extended mode line buffer (see read_long_line function).
+ */
+void free_long_buffer()
+{
+	if(long_buffer != NULL) {
+		free(long_buffer);
+	}
+	long_buffer = NULL;
+	long_buffer_size = 0;
+}
+
+
+/**
+ * is_long_line function checks whether the line is too long. (MAX_LINE_LENGTH defined at 'line.details.h' and is equal to 81)
+ *
+ * @param line_len - the length of the line.
+ * @param white_spaces_quantt - the quantity of whitespaces in the line.
+ * @return - 1 if line is too long, otherwise 0 is returned.
+ */
+int is_long_line(int line_len, int white_spaces_quantt)
+{
+	return (line_len - white_spaces_quantt > MAX_LINE_LENGTH) ? 1 : 0;
+}
+
+
+/**
+ * is_line_ending_with_newline_char function checks whether the line is ending with a newline char.
+ *
+ * @param line - a pointer to the start of the line.
+ * @param line_len - the length of the line.
+ * @return - 1 if line is ending with newline char, otherwise 0 is returned.
+ */
+int is_line_ending_with_newline_char(char* line, int line_len)
+{
+	return line[line_len-1] == '\n' ? 1 : 0;
+}
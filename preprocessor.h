@@ -0,0 +1,240 @@
+#ifndef PREPROCESSOR_H
+#define PREPROCESSOR_H
+#define MAX_BUFFER_LENGTH 128
+#define MACRO_TABLE_SIZE 211
+#define MACRO_START "mcr"
+#define MACRO_END "endmcr"
+#define AM_EXTENSION ".am"
+#define DEFERRED_ERRORS_INITIAL_SIZE 8	/* the number of errors the preprocessor keeps room for, it doubles when it's full */
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "line_details.h"
+#include "parser.h"	/* for is_label and count_whitespaces functions */
+#include "main_functions.h"
+
+
+/* a struct that represents an error the preprocessor found while errors are deferred (see defer_preprocessor_errors function) */
+typedef struct preprocessor_error {
+	int line;	/* the line in the source file where the error has occurred */
+	ERR_VALUE err;
+} preprocessor_error;
+
+
+/* a pointer to struct macro_line */
+typedef struct macro_line* ml_ptr;
+
+/* a struct that represents a line in the body of a macro (list) */
+typedef struct macro_line {
+	char* line;	/* the line as it appeared in the source file */
+	ml_ptr next;
+} macro_line;
+
+
+/* a pointer to struct macro */
+typedef struct macro* macro_ptr;
+
+/* a struct that represents a macro in the macro table. Macros with the same hash value are chained in a list */
+typedef struct macro {
+	char* name;
+	ml_ptr body_head;	/* the first line of the body of the macro */
+	ml_ptr body_curr;	/* the last line of the body of the macro */
+	macro_ptr next;	/* the next macro in the same bucket of the macro table */
+} macro;
+
+
+/**
+ * start_preprocessor function prepares the preprocessor to read the lines of a new source file.
+ * If the expanded file was requested (see is_am_file_requested function), the '.am' file is created here.
+ * This function must be called before the first call to next_line function.
+ *
+ * @param fp - the pointer to the source file.
+ * @param fn - the name of the source file.
+ */
+void start_preprocessor(FILE* fp, const char* fn);
+
+
+/**
+ * next_line function returns the next line of the source file, after macro expansion. This is the only function 'handler.c' uses to get lines.
+ * Macro definitions (from "mcr NAME" up to "endmcr") are stored in the macro table and are not returned. A line that holds only a macro name
+ * is replaced with the lines of the body of the macro, one line per call, so the expanded file is never stored in memory.
+ * Lines that are too long (standard mode) are reported here and are not returned.
+ * The returned line may be changed by the caller, it's valid until the next call.
+ *
+ * @param line_num - an address of an integer where to store the line number (in the source file) of the line. For expanded lines, it's the
+ *                   line of the macro call.
+ * @return - the next line, or NULL if end of file was reached.
+ */
+char* next_line(int* line_num);
+
+
+/**
+ * end_preprocessor function frees the macro table and the line buffers and closes the '.am' file (if created).
+ * This function must be called after the last line of the source file was processed.
+ */
+void end_preprocessor();
+
+
+/**
+ * defer_preprocessor_errors function chooses whether the errors of the preprocessor (too long lines and bad macro definitions) are added to
+ * the errors list when they're found, or kept until they're taken with take_preprocessor_errors function. The pipeline (see 'pipeline.h')
+ * reads the lines on a thread of its own, so it takes the errors with the lines and adds them in the same order the serial loop would.
+ * end_preprocessor function stops keeping the errors.
+ *
+ * @param deferred - 1 to keep the errors, 0 to add them.
+ */
+void defer_preprocessor_errors(int deferred);
+
+
+/**
+ * take_preprocessor_errors function returns the errors kept since its last call, and forgets them. The errors found by a call to next_line
+ * function come before its line.
+ *
+ * @param errors_num - a pointer to where to store the number of errors.
+ * @return - the errors (they belong to the preprocessor), valid until the next call to next_line function.
+ */
+preprocessor_error* take_preprocessor_errors(int* errors_num);
+
+
+/**
+ * report_preprocessor_error function adds an error of the preprocessor to the errors list, or keeps it if the errors are deferred.
+ *
+ * @param ln - the line in the source file where the error has occurred.
+ * @param err - the enum value of the error.
+ */
+void report_preprocessor_error(int ln, ERR_VALUE err);
+
+
+/**
+ * read_source_line function reads the next line of the source file, without macro expansion.
+ * In standard mode, lines longer than allowed are reported (LONG_LINE error) and skipped.
+ *
+ * @return - the line read, or NULL if end of file was reached.
+ */
+char* read_source_line();
+
+
+/**
+ * define_macro function stores a macro definition in the macro table. The function is called after "mcr" line was read, and it reads all lines
+ * up to "endmcr" line. If the macro name is not valid, the lines are read and ignored.
+ *
+ * @param tkn_num - the number of tokens in the "mcr" line.
+ * @param name - the name of the macro (the second token of the "mcr" line).
+ */
+void define_macro(int tkn_num, char* name);
+
+
+/**
+ * peek_tokens function copies the first 2 tokens of the line to 'first' and 'second' without changing the line, and returns the number of
+ * tokens in the line (up to 3, which means 3 or more). Tokens longer than 'size' - 1 are truncated.
+ *
+ * @param line - the line.
+ * @param first - a string where to store the first token.
+ * @param second - a string where to store the second token.
+ * @param size - the size of 'first' and 'second'.
+ * @return - the number of tokens in the line, 3 is returned if there are 3 tokens or more.
+ */
+int peek_tokens(const char* line, char* first, char* second, int size);
+
+
+/**
+ * macro_hash function returns the bucket of the macro table for 'name'.
+ *
+ * @param name - the name of the macro.
+ * @return - the index of the bucket, from 0 to MACRO_TABLE_SIZE - 1.
+ */
+unsigned int macro_hash(const char* name);
+
+
+/**
+ * find_macro function searches for a macro in the macro table.
+ *
+ * @param name - the name of the macro.
+ * @return - a pointer to the macro if found, otherwise NULL is returned.
+ */
+macro_ptr find_macro(const char* name);
+
+
+/**
+ * insert_macro function creates a macro with an empty body and adds it to the macro table.
+ * The macro must not exist in the macro table already.
+ *
+ * @param name - the name of the macro.
+ * @return - a pointer to the macro created.
+ */
+macro_ptr insert_macro(const char* name);
+
+
+/**
+ * add_macro_line function adds a copy of 'line' to the end of the body of the macro.
+ *
+ * @param m - a pointer to the macro.
+ * @param line - the line to add.
+ */
+void add_macro_line(macro_ptr m, const char* line);
+
+
+/**
+ * free_macros function frees all macros in the macro table.
+ */
+void free_macros();
+
+
+/**
+ * find_next_line function finds where the new line starts at.
+ *
+ * @param fp - the pointer to the pointer which points to the file.
+ */
+void find_next_line(FILE** fp);
+
+
+/**
+ * read_long_line function reads a whole line of any length from the file. The line is stored in 'buffer' that grows when needed
+ * and is reused for the next lines (so the returned line is valid until the next call with the same buffer).
+ * This function is used in extended mode, in standard mode lines are read into a MAX_BUFFER_LENGTH buffer.
+ *
+ * @param fp - the pointer to the file.
+ * @param buffer - the pointer to the buffer (NULL if not allocated yet).
+ * @param buffer_size - the pointer to the size of the buffer.
+ * @return - the line read (including the newline char if it exists), or NULL if end of file was reached.
+ */
+char* read_long_line(FILE* fp, char** buffer, int* buffer_size);
+
+
+/**
+ * grow_line_buffer function makes sure a line buffer (see read_long_line function) can hold at least 'size' characters.
+ *
+ * @param buffer - the pointer to the buffer (NULL if not allocated yet).
+ * @param buffer_size - the pointer to the size of the buffer.
+ * @param size - the needed size of the buffer.
+ */
+void grow_line_buffer(char** buffer, int* buffer_size, int size);
+
+
+/**
+ * free_long_buffer function frees the buffer used by read_long_line function.
+ */
+void free_long_buffer();
+
+
+/**
+ * is_long_line function checks whether the line is too long. (MAX_LINE_LENGTH defined at 'line.details.h' and is equal to 81)
+ *
+ * @param line_len - the length of the line.
+ * @param white_spaces_quantt - the quantity of whitespaces in the line.
+ * @return - 1 if line is too long, otherwise 0 is returned.
+ */
+int is_long_line(int line_len, int white_spaces_quantt);
+
+
+/**
+ * is_line_ending_with_newline_char function checks whether the line is ending with a newline char.
+ *
+ * @param line - a pointer to the start of the line.
+ * @param line_len - the length of the line.
+ * @return - 1 if line is ending with newline char, otherwise 0 is returned.
+ */
+int is_line_ending_with_newline_char(char* line, int line_len);
+
+
+#endif
@@ -0,0 +1,439 @@
+/**
+ * This file contains all functions related to profiling executions in the 'simulator': the number of times every instruction was executed, and
+ * the calling contexts of the routines ('jsr' / 'rts' shadow call stack). The profile is reported per entry label, as a flat profile and as
+ * folded call stacks for flame graphs.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "profiler.h"
+#include "link.h"	/* for link_error function */
+#include "emergency_free_mem.h"
+
+
+/**
+ * create_profile function creates an empty profile for an image.
+ *
+ * @param m - a pointer to the module of the image.
+ * @return - a pointer to the profile.
+ */
+profile_ptr create_profile(om_ptr m)
+{
+	profile_ptr p;
+	sr_ptr entry;
+	int n;
+
+	p = calloc(1, sizeof(profile));
+
+	/* verify if calloc worked as expected */
+	if(p == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(n = 0, entry = m -> entries; entry != NULL; entry = entry -> next) {
+		n++;
+	}
+
+	p -> name = module_file_name(m -> name, "");
+	p -> labels = malloc((n + 1) * sizeof(profile_label));	/* +1 so an image without entry labels allocates too */
+	p -> root = create_context(NULL, FIRST_ADDRESS);
+
+	/* verify if malloc worked as expected */
+	if(p -> labels == NULL)
+	{
+		free_profile(&p);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(entry = m -> entries; entry != NULL; entry = entry -> next) {
+		p -> labels[p -> labels_num].addr = entry -> addr;
+		p -> labels[p -> labels_num].label = malloc(strlen(entry -> label) + 1);
+
+		/* verify if malloc worked as expected */
+		if(p -> labels[p -> labels_num].label == NULL)
+		{
+			free_profile(&p);
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+
+		strcpy(p -> labels[p -> labels_num].label, entry -> label);
+		p -> labels_num++;
+	}
+	qsort(p -> labels, p -> labels_num, sizeof(profile_label), compare_labels);
+
+	p -> curr = p -> root;
+
+	return p;
+}
+
+
+/**
+ * compare_labels function compares the addresses of two labels for qsort function.
+ *
+ * @param x - a pointer to the first label.
+ * @param y - a pointer to the second label.
+ * @return - a negative number, 0 or a positive number if the address of the first label is lower, equal or higher.
+ */
+int compare_labels(const void* x, const void* y)
+{
+	return ((const profile_label*) x) -> addr - ((const profile_label*) y) -> addr;
+}
+
+
+/**
+ * create_context function creates a calling context.
+ *
+ * @param parent - a pointer to the context of the caller, NULL for the root.
+ * @param func - the address of the routine.
+ * @return - a pointer to the context.
+ */
+cn_ptr create_context(cn_ptr parent, int func)
+{
+	cn_ptr node;
+
+	node = calloc(1, sizeof(call_node));
+
+	/* verify if calloc worked as expected */
+	if(node == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	node -> func = func;
+	node -> parent = parent;
+	if(parent != NULL) {
+		node -> sibling = parent -> child;
+		parent -> child = node;
+	}
+
+	return node;
+}
+
+
+/**
+ * profile_call function moves the profile to the context of a called routine.
+ *
+ * @param p - a pointer to the profile.
+ * @param target - the address of the routine.
+ * @param executed - the number of instructions executed so far (including the 'jsr').
+ */
+void profile_call(profile_ptr p, int target, long executed)
+{
+	cn_ptr node;
+
+	p -> curr -> self += executed - p -> last;
+	p -> last = executed;
+
+	for(node = p -> curr -> child; node != NULL && node -> func != target; node = node -> sibling)
+		;
+	if(node == NULL) {
+		node = create_context(p -> curr, target);
+	}
+	p -> curr = node;
+}
+
+
+/**
+ * profile_return function moves the profile back to the context of the caller.
+ *
+ * @param p - a pointer to the profile.
+ * @param executed - the number of instructions executed so far (including the 'rts').
+ */
+void profile_return(profile_ptr p, long executed)
+{
+	p -> curr -> self += executed - p -> last;
+	p -> last = executed;
+
+	if(p -> curr -> parent != NULL) {
+		p -> curr = p -> curr -> parent;
+	}
+}
+
+
+/**
+ * profile_end function adds the instructions executed since the last call / return to the current context.
+ *
+ * @param p - a pointer to the profile.
+ * @param executed - the number of instructions executed.
+ */
+void profile_end(profile_ptr p, long executed)
+{
+	p -> curr -> self += executed - p -> last;
+	p -> last = executed;
+}
+
+
+/**
+ * find_label function finds the closest entry label at or before an address.
+ *
+ * @param p - a pointer to the profile.
+ * @param addr - the address.
+ * @return - the index of the label in p -> labels, or -1 if there is no such label.
+ */
+int find_label(profile_ptr p, int addr)
+{
+	int low, high, mid;
+
+	low = 0;
+	high = p -> labels_num - 1;
+	while(low <= high) {	/* the last label whose address is not above addr */
+		mid = (low + high) / 2;
+		if(p -> labels[mid].addr <= addr) {
+			low = mid + 1;
+		}
+		else high = mid - 1;
+	}
+
+	return high;
+}
+
+
+/**
+ * address_name function names an address after the closest entry label before it.
+ *
+ * @param p - a pointer to the profile.
+ * @param addr - the address.
+ * @param name - a string where to store the name.
+ * @return - the index of the label in p -> labels, or -1 if there is no such label.
+ */
+int address_name(profile_ptr p, int addr, char* name)
+{
+	int i;
+
+	i = find_label(p, addr);
+
+	if(i == -1) {
+		sprintf(name, "%04d", addr);
+	}
+	else if(p -> labels[i].addr == addr) {
+		sprintf(name, "%.*s", PROFILE_NAME_LENGTH - 1, p -> labels[i].label);
+	}
+	else sprintf(name, "%.*s+%d", PROFILE_NAME_LENGTH - 7, p -> labels[i].label, addr - p -> labels[i].addr);	/* 7 for '+' and 4 digits */
+
+	return i;
+}
+
+
+/**
+ * write_profile function writes the flat profile to '<name>.prof' and the folded call stacks to '<name>.folded'.
+ *
+ * @param p - a pointer to the profile.
+ */
+void write_profile(profile_ptr p)
+{
+	char name[PROFILE_NAME_LENGTH];
+	char* file_name;
+	char* stack;
+	FILE* fp;
+	long* self;
+	long* inclusive;
+	int* order;
+	int hot[PROFILE_HOT_ADDRESSES];
+	int hot_num;
+	long total;
+	int i, j, k, addr;
+
+	self = calloc(p -> labels_num + 1, sizeof(long));	/* index labels_num is the addresses before the first label */
+	inclusive = calloc(p -> labels_num + 1, sizeof(long));
+	order = malloc((p -> labels_num + 1) * sizeof(int));
+	stack = malloc((MAX_STACK_DEPTH + 1) * (PROFILE_NAME_LENGTH + 1));	/* +1 for ';' */
+
+	/* verify if malloc / calloc worked as expected */
+	if(self == NULL || inclusive == NULL || order == NULL || stack == NULL)
+	{
+		free(self);
+		free(inclusive);
+		free(order);
+		free(stack);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	total = sum_contexts(p, p -> root, inclusive);
+
+	for(addr = 0; addr < MEMORY_SIZE; addr++) {
+		if(p -> counts[addr] > 0) {
+			i = find_label(p, addr);
+			self[i == -1 ? p -> labels_num : i] += p -> counts[addr];
+		}
+	}
+
+	/* the labels by self count, highest first (insertion sort, there are few labels) */
+	for(i = 0; i <= p -> labels_num; i++) {
+		for(j = i; j > 0 && self[order[j - 1]] < self[i]; j--) {
+			order[j] = order[j - 1];
+		}
+		order[j] = i;
+	}
+
+	/* the hottest addresses, highest first */
+	for(hot_num = 0, addr = 0; addr < MEMORY_SIZE; addr++) {
+		if(p -> counts[addr] == 0 || (hot_num == PROFILE_HOT_ADDRESSES && p -> counts[hot[hot_num - 1]] >= p -> counts[addr])) {
+			continue;
+		}
+		if(hot_num < PROFILE_HOT_ADDRESSES) {
+			hot_num++;
+		}
+		for(k = hot_num - 1; k > 0 && p -> counts[hot[k - 1]] < p -> counts[addr]; k--) {
+			hot[k] = hot[k - 1];
+		}
+		hot[k] = addr;
+	}
+
+	file_name = module_file_name(p -> name, PROFILE_EXTENSION);
+	fp = fopen(file_name, "w");
+	if(fp == NULL) {
+		link_error(file_name, 0, "The profile file could not be created.", NULL);
+	}
+	else {
+		fprintf(fp, "Flat profile of image '%s%s': %ld instructions\n\n", p -> name, OB_EXTENSION, total);
+		fprintf(fp, "%12s %8s %12s %8s  %s\n", "self", "%", "inclusive", "%", "label");
+		for(i = 0; i <= p -> labels_num; i++) {
+			k = order[i];
+			if(self[k] == 0 && inclusive[k] == 0) {
+				continue;
+			}
+			fprintf(fp, "%12ld %7.2f%% %12ld %7.2f%%  %s\n", self[k], total > 0 ? 100.0 * self[k] / total : 0.0, inclusive[k],
+				total > 0 ? 100.0 * inclusive[k] / total : 0.0, k == p -> labels_num ? "(before the first entry label)" : p -> labels[k].label);
+		}
+
+		fprintf(fp, "\nHot addresses:\n\n");
+		fprintf(fp, "%7s %12s %8s  %s\n", "address", "instructions", "%", "name");
+		for(i = 0; i < hot_num; i++) {
+			address_name(p, hot[i], name);
+			fprintf(fp, "%7.4d %12ld %7.2f%%  %s\n", hot[i], p -> counts[hot[i]], total > 0 ? 100.0 * p -> counts[hot[i]] / total : 0.0, name);
+		}
+
+		printf("\nFile '%s' has been created successfully!", file_name);
+		fclose(fp);
+	}
+	free(file_name);
+
+	file_name = module_file_name(p -> name, FOLDED_EXTENSION);
+	fp = fopen(file_name, "w");
+	if(fp == NULL) {
+		link_error(file_name, 0, "The folded call stacks file could not be created.", NULL);
+	}
+	else {
+		write_folded(fp, p, p -> root, stack, 0);
+		printf("\nFile '%s' has been created successfully!", file_name);
+		fclose(fp);
+	}
+	free(file_name);
+	putchar('\n');
+
+	free(self);
+	free(inclusive);
+	free(order);
+	free(stack);
+}
+
+
+/**
+ * sum_contexts function computes the 'total' of a context and of all contexts called from it, and adds it to the inclusive count of its label.
+ *
+ * @param p - a pointer to the profile.
+ * @param node - a pointer to the context.
+ * @param inclusive - the inclusive count of every label.
+ * @return - the total of the context.
+ */
+long sum_contexts(profile_ptr p, cn_ptr node, long* inclusive)
+{
+	cn_ptr child;
+	cn_ptr caller;
+	int i;
+
+	node -> total = node -> self;
+	for(child = node -> child; child != NULL; child = child -> sibling) {
+		node -> total += sum_contexts(p, child, inclusive);
+	}
+
+	for(caller = node -> parent; caller != NULL && caller -> func != node -> func; caller = caller -> parent)
+		;
+	if(caller == NULL) {	/* not a recursive call, its callers don't count it already */
+		i = find_label(p, node -> func);
+		inclusive[i == -1 ? p -> labels_num : i] += node -> total;
+	}
+
+	return node -> total;
+}
+
+
+/**
+ * write_folded function writes the folded call stacks of a context and of all contexts called from it.
+ *
+ * @param fp - the file.
+ * @param p - a pointer to the profile.
+ * @param node - a pointer to the context.
+ * @param stack - the names of the callers, separated by ';'.
+ * @param len - the length of the names in 'stack'.
+ */
+void write_folded(FILE* fp, profile_ptr p, cn_ptr node, char* stack, int len)
+{
+	cn_ptr child;
+
+	if(len > 0) {
+		stack[len++] = ';';
+	}
+	address_name(p, node -> func, stack + len);
+	len += strlen(stack + len);
+
+	if(node -> self > 0) {
+		fprintf(fp, "%s %ld\n", stack, node -> self);
+	}
+
+	for(child = node -> child; child != NULL; child = child -> sibling) {
+		write_folded(fp, p, child, stack, len);
+	}
+}
+
+
+/**
+ * free_profile function frees a profile.
+ *
+ * @param p - the pointer to the pointer to the profile.
+ */
+void free_profile(profile_ptr* p)
+{
+	cn_ptr node;
+	cn_ptr next;
+	int i;
+
+	if(*p == NULL) {
+		return;
+	}
+
+	/* free the contexts without recursion: a context is freed after its children, which are moved up to its parent */
+	node = (*p) -> root;
+	while(node != NULL) {
+		if(node -> child != NULL) {
+			node = node -> child;
+			continue;
+		}
+		next = node -> sibling != NULL ? node -> sibling : node -> parent;
+		if(node -> parent != NULL && node -> parent -> child == node) {
+			node -> parent -> child = node -> sibling;
+		}
+		free(node);
+		node = next;
+	}
+
+	for(i = 0; i < (*p) -> labels_num; i++) {
+		free((*p) -> labels[i].label);
+	}
+	free((*p) -> labels);
+	free((*p) -> name);
+	free(*p);
+	*p = NULL;
+}
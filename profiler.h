@@ -0,0 +1,171 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "machine.h"
+#define PROFILE_EXTENSION ".prof"	/* the flat profile */
+#define FOLDED_EXTENSION ".folded"	/* the folded call stacks, the input of flame graph tools */
+#define PROFILE_HOT_ADDRESSES 20	/* the number of addresses listed in the flat profile */
+#define PROFILE_NAME_LENGTH MAX_LINE_LENGTH	/* the size of the name of an address, "LABEL+offset" */
+
+
+/* a pointer to struct call_node */
+typedef struct call_node* cn_ptr;
+
+/* a struct that represents a calling context: a routine ('jsr' target) called from a chain of routines. The contexts form a tree whose root is
+ * the start of the image, so the path from the root to the current context is the shadow call stack of the profiled machine */
+typedef struct call_node {
+	int func;	/* the address of the routine */
+	long self;	/* the number of instructions executed in the routine in this context (not in the routines it called) */
+	long total;	/* self and the instructions of all routines called from this context, computed by write_profile function */
+	cn_ptr parent;
+	cn_ptr child;	/* the first context called from this one */
+	cn_ptr sibling;	/* the next context called from the parent */
+} call_node;
+
+
+/* a struct that represents an entry label of the image, the labels name the addresses in the reports */
+typedef struct profile_label {
+	int addr;
+	char* label;
+} profile_label;
+
+
+/* a struct that represents the profile of one execution. The machine counts every instruction at its address (see run_machine function in
+ * 'machine.h'), and updates the calling contexts only on 'jsr' and 'rts': the instructions executed since the last call / return are added to
+ * the context that was current, so profiling costs one counter per instruction */
+typedef struct profile {
+	long counts[MEMORY_SIZE];	/* the number of times the instruction at every address was executed */
+	cn_ptr root;
+	cn_ptr curr;	/* the context of the routine running now */
+	long last;	/* the number of instructions executed at the last call / return */
+	profile_label* labels;	/* sorted by address */
+	int labels_num;
+	char* name;	/* the name of the image (without extension) */
+} profile;
+
+
+/**
+ * create_profile function creates an empty profile for an image, with the entry labels of the image ('.ent' file). Addresses are named after
+ * the closest entry label before them ("LABEL+offset"), so routines must be entry labels to be named in the reports.
+ *
+ * @param m - a pointer to the module of the image.
+ * @return - a pointer to the profile.
+ */
+profile_ptr create_profile(om_ptr m);
+
+
+/**
+ * compare_labels function compares the addresses of two labels for qsort function.
+ *
+ * @param x - a pointer to the first label (profile_label struct).
+ * @param y - a pointer to the second label.
+ * @return - a negative number, 0 or a positive number if the address of the first label is lower, equal or higher.
+ */
+int compare_labels(const void* x, const void* y);
+
+
+/**
+ * create_context function creates a calling context and adds it to the contexts called from its parent.
+ *
+ * @param parent - a pointer to the context of the caller, NULL for the root.
+ * @param func - the address of the routine.
+ * @return - a pointer to the context.
+ */
+cn_ptr create_context(cn_ptr parent, int func);
+
+
+/**
+ * profile_call function moves the profile to the context of a called routine ('jsr'), creating the context the first time it's called.
+ *
+ * @param p - a pointer to the profile.
+ * @param target - the address of the routine.
+ * @param executed - the number of instructions executed so far (including the 'jsr').
+ */
+void profile_call(profile_ptr p, int target, long executed);
+
+
+/**
+ * profile_return function moves the profile back to the context of the caller ('rts').
+ *
+ * @param p - a pointer to the profile.
+ * @param executed - the number of instructions executed so far (including the 'rts').
+ */
+void profile_return(profile_ptr p, long executed);
+
+
+/**
+ * profile_end function adds the instructions executed since the last call / return to the current context. It must be called when the machine
+ * returns, before the reports are written.
+ *
+ * @param p - a pointer to the profile.
+ * @param executed - the number of instructions executed.
+ */
+void profile_end(profile_ptr p, long executed);
+
+
+/**
+ * find_label function finds the closest entry label at or before an address (binary search).
+ *
+ * @param p - a pointer to the profile.
+ * @param addr - the address.
+ * @return - the index of the label in p -> labels, or -1 if there is no such label.
+ */
+int find_label(profile_ptr p, int addr);
+
+
+/**
+ * address_name function names an address after the closest entry label before it: "LABEL" or "LABEL+offset", or the address itself if there
+ * is no such label.
+ *
+ * @param p - a pointer to the profile.
+ * @param addr - the address.
+ * @param name - a string where to store the name (at least PROFILE_NAME_LENGTH chars).
+ * @return - the index of the label in p -> labels, or -1 if there is no such label.
+ */
+int address_name(profile_ptr p, int addr, char* name);
+
+
+/**
+ * write_profile function writes the flat profile of the labels and the hottest addresses to '<name>.prof', and the folded call stacks (one line
+ * for every context, "ROUTINE;ROUTINE;... INSTRUCTIONS") to '<name>.folded'.
+ *
+ * @param p - a pointer to the profile.
+ */
+void write_profile(profile_ptr p);
+
+
+/**
+ * sum_contexts function computes the 'total' of a context and of all contexts called from it, and adds it to the inclusive count of its
+ * label, unless a context of the same label is one of its callers (so a recursive routine is counted once).
+ *
+ * @param p - a pointer to the profile.
+ * @param node - a pointer to the context.
+ * @param inclusive - the inclusive count of every label (and of the unnamed addresses at index labels_num).
+ * @return - the total of the context.
+ */
+long sum_contexts(profile_ptr p, cn_ptr node, long* inclusive);
+
+
+/**
+ * write_folded function writes the folded call stacks of a context and of all contexts called from it.
+ *
+ * @param fp - the file.
+ * @param p - a pointer to the profile.
+ * @param node - a pointer to the context.
+ * @param stack - the names of the callers, separated by ';' (room for MAX_STACK_DEPTH + 1 names).
+ * @param len - the length of the names in 'stack'.
+ */
+void write_folded(FILE* fp, profile_ptr p, cn_ptr node, char* stack, int len);
+
+
+/**
+ * free_profile function frees a profile.
+ *
+ * @param p - the pointer to the pointer to the profile.
+ */
+void free_profile(profile_ptr* p);
+
+
+#endif
@@ -0,0 +1,519 @@
+/**
+ * This file contains all functions related to incremental relinking in the 'linker'. The layout of a linked image and the entry and external
+ * labels of its modules are kept in the link database, so after a module is assembled again only that module is read, relocated and written
+ * in place, and only the words that refer to it are patched again.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "relink.h"
+#include "emergency_free_mem.h"
+
+
+/**
+ * incremental_link function updates a linked image after some of its modules were assembled again.
+ *
+ * @param names - the names of the modules, in link order.
+ * @param names_num - the number of modules.
+ * @param out - the name of the linked image (without extension).
+ * @return - RELINK_DONE if the linked image was updated (or is up to date), RELINK_FAILED if errors were found, otherwise RELINK_FULL is
+ *           returned.
+ */
+int incremental_link(char** names, int names_num, const char* out)
+{
+	char header[MAX_OBJECT_LINE_LENGTH];
+	om_ptr head;	/* the modules of the database, changed modules are replaced with their new version */
+	om_ptr old;	/* the old versions of the changed modules */
+	om_ptr m;
+	om_ptr* link;
+	om_ptr new_m;
+	sr_ptr ext;
+	gs_ptr symbol;
+	unsigned long* stamps;
+	unsigned long new_stamps[6];
+	int total_ic, total_dc;
+	int changed;
+	int result;
+	int i;
+	char* file_name;
+	char* image;	/* the linked image, the words are written in it before it replaces the file */
+	size_t image_len;
+	long header_len;
+
+	head = read_link_db(out, &total_ic, &total_dc, &stamps);
+	if(head == NULL) {
+		return RELINK_FULL;
+	}
+
+	old = NULL;
+	changed = 0;
+	result = RELINK_FULL;
+
+	/* START - find the changed modules */
+	for(i = 0, link = &head; *link != NULL && i < names_num; i++, link = &((*link) -> next))
+	{
+		if(strcmp((*link) -> name, names[i]) != 0) {	/* not the same modules */
+			break;
+		}
+
+		get_module_stamps(names[i], new_stamps);
+		if(memcmp(new_stamps, stamps + i * 6, sizeof(new_stamps)) == 0) {
+			continue;
+		}
+
+		new_m = load_object_module(names[i]);
+		if(new_m == NULL) {
+			result = RELINK_FAILED;
+			break;
+		}
+		if(new_m -> ic != (*link) -> ic || new_m -> dc != (*link) -> dc || !same_entries(new_m, *link)) {	/* the layout changed */
+			free_object_modules(&new_m);
+			break;
+		}
+
+		new_m -> code_base = (*link) -> code_base;
+		new_m -> data_base = (*link) -> data_base;
+		new_m -> reloaded = 1;
+
+		/* replace the module with its new version */
+		new_m -> next = (*link) -> next;
+		(*link) -> next = old;
+		old = *link;
+		*link = new_m;
+		changed++;
+	}
+	free(stamps);
+
+	if(i != names_num || *link != NULL) {	/* a full link is needed, or a module could not be read */
+		free_object_modules(&head);
+		free_object_modules(&old);
+		return result;
+	}
+	free_object_modules(&old);
+	/* END - find the changed modules */
+
+	if(changed == 0) {
+		free_object_modules(&head);
+		printf("\nFile '%s%s' is up to date.", out, OB_EXTENSION);
+		return RELINK_DONE;
+	}
+
+	for(m = head; m != NULL; m = m -> next) {
+		add_global_symbols(m);
+	}
+
+	/* every external label of the changed modules must be defined, otherwise the full link reports it */
+	for(m = head; m != NULL; m = m -> next) {
+		for(ext = m -> externs; m -> reloaded && ext != NULL; ext = ext -> next) {
+			if(find_global(ext -> label) == NULL) {
+				free_global_table();
+				free_object_modules(&head);
+				return RELINK_FULL;
+			}
+		}
+	}
+
+	file_name = module_file_name(out, OB_EXTENSION);
+	image = read_whole_file(file_name, &image_len);
+	sprintf(header, "%d %d\n", total_ic, total_dc);
+	header_len = strlen(header);
+
+	/* the image must have the layout the database describes */
+	if(image == NULL || image_len != header_len + (size_t)(total_ic + total_dc) * LINKED_LINE_LENGTH ||
+			strncmp(image, header, header_len) != 0) {
+		if(image != NULL) {
+			free(image);
+		}
+		free(file_name);
+		free_global_table();
+		free_object_modules(&head);
+		return RELINK_FULL;
+	}
+
+	/* START - write the changed modules, and patch the words that refer to them */
+	for(m = head; m != NULL; m = m -> next)
+	{
+		if(m -> reloaded) {
+			relocate_module(m);
+			for(i = 0; i < m -> ic + m -> dc; i++) {
+				write_linked_word(image, header_len, relocate_address(m, FIRST_ADDRESS + i), m -> words[i], m -> tags[i]);
+			}
+			continue;
+		}
+
+		for(ext = m -> externs; ext != NULL; ext = ext -> next)
+		{
+			symbol = find_global(ext -> label);
+			if(symbol != NULL && symbol -> module -> reloaded) {
+				write_linked_word(image, header_len, relocate_address(m, ext -> addr),
+						relocate_address(symbol -> module, symbol -> entry -> addr), 'R');
+			}
+		}
+	}
+	/* END - write the changed modules, and patch the words that refer to them */
+
+	/* the file is replaced only if there are no errors, so the image and the database on disk always describe the same link */
+	if(were_link_errors()) {
+		result = RELINK_FAILED;
+	}
+	else if(!replace_file(out, image, image_len)) {
+		result = RELINK_FULL;
+	}
+	else {
+		printf("\nFile '%s' has been relinked incrementally (%d changed modules)!", file_name, changed);
+		create_link_db(head, out);
+		result = RELINK_DONE;
+	}
+
+	free(image);
+	free(file_name);
+	free_global_table();
+	free_object_modules(&head);
+
+	return result;
+}
+
+
+/**
+ * create_link_db function writes the link database of a linked image.
+ *
+ * @param head - the head of the list of the linked modules.
+ * @param out - the name of the linked image (without extension).
+ */
+void create_link_db(om_ptr head, const char* out)
+{
+	char* file_name;
+	FILE* fp;
+	om_ptr m;
+	sr_ptr ref;
+	unsigned long stamps[6];
+	unsigned long image_hash, image_size;
+	int modules_num, total_ic, total_dc;
+	int entries_num, externs_num;
+
+	modules_num = 0;
+	total_ic = 0;
+	total_dc = 0;
+	for(m = head; m != NULL; m = m -> next) {
+		modules_num++;
+		total_ic += m -> ic;
+		total_dc += m -> dc;
+	}
+
+	file_name = module_file_name(out, OB_EXTENSION);
+	get_file_stamp(file_name, &image_hash, &image_size);
+	free(file_name);
+
+	file_name = module_file_name(out, LINK_DB_EXTENSION);
+	fp = fopen(file_name, "w+");
+
+	if(fp == NULL) {
+		free(file_name);
+		printf("Could not create link database file.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	fprintf(fp, "%s %d %d %d %lu %lu\n", LINK_DB_MAGIC, modules_num, total_ic, total_dc, image_hash, image_size);
+
+	for(m = head; m != NULL; m = m -> next)
+	{
+		entries_num = 0;
+		for(ref = m -> entries; ref != NULL; ref = ref -> next) {
+			entries_num++;
+		}
+		externs_num = 0;
+		for(ref = m -> externs; ref != NULL; ref = ref -> next) {
+			externs_num++;
+		}
+
+		get_module_stamps(m -> name, stamps);
+		fprintf(fp, "%s %d %d %d %d %lu %lu %lu %lu %lu %lu %d %d\n", m -> name, m -> ic, m -> dc, m -> code_base, m -> data_base,
+				stamps[0], stamps[1], stamps[2], stamps[3], stamps[4], stamps[5], entries_num, externs_num);
+
+		for(ref = m -> entries; ref != NULL; ref = ref -> next) {
+			fprintf(fp, "%s %04d\n", ref -> label, ref -> addr);
+		}
+		for(ref = m -> externs; ref != NULL; ref = ref -> next) {
+			fprintf(fp, "%s %04d\n", ref -> label, ref -> addr);
+		}
+	}
+
+	printf("\nFile '%s' has been created successfully!", file_name);
+
+	fclose(fp);
+	free(file_name);
+}
+
+
+/**
+ * read_link_db function reads the link database of a linked image.
+ *
+ * @param out - the name of the linked image (without extension).
+ * @param total_ic - an address of an integer where to store the number of code words of the linked image.
+ * @param total_dc - an address of an integer where to store the number of data words of the linked image.
+ * @param stamps - an address of a pointer where to store the stamps of the files of the modules, must be freed.
+ * @return - the head of the list of modules, or NULL if the database doesn't exist, is not valid or doesn't match the linked image.
+ */
+om_ptr read_link_db(const char* out, int* total_ic, int* total_dc, unsigned long** stamps)
+{
+	char line[MAX_LINK_DB_LINE_LENGTH];
+	char name[MAX_LINK_DB_LINE_LENGTH];
+	char magic[MAX_LINK_DB_LINE_LENGTH];
+	char* file_name;
+	char* db_name;
+	char* text;
+	size_t len;
+	const char* pos;
+	const char* end;
+	const char* refs;
+	om_ptr head;
+	om_ptr curr;
+	om_ptr m;
+	unsigned long image_hash, image_size;
+	unsigned long hash, size;
+	int modules_num;
+	int entries_num, externs_num;
+	int valid;
+	int i, j;
+
+	db_name = module_file_name(out, LINK_DB_EXTENSION);
+	text = read_whole_file(db_name, &len);
+	if(text == NULL) {
+		free(db_name);
+		return NULL;
+	}
+
+	pos = text;
+	end = text + len;
+	head = NULL;
+	curr = NULL;
+	*stamps = NULL;
+
+	valid = next_text_line(&pos, end, line, sizeof(line)) &&
+			sscanf(line, "%511s %d %d %d %lu %lu", magic, &modules_num, total_ic, total_dc, &image_hash, &image_size) == 6 &&
+			strcmp(magic, LINK_DB_MAGIC) == 0 && modules_num > 0;
+
+	/* the linked image must be the one the database was written for */
+	file_name = module_file_name(out, OB_EXTENSION);
+	get_file_stamp(file_name, &hash, &size);
+	free(file_name);
+	valid = valid && hash == image_hash && size == image_size && *total_ic + *total_dc + FIRST_ADDRESS <= 10000;
+
+	if(valid) {
+		*stamps = malloc(modules_num * 6 * sizeof(unsigned long));
+
+		/* verify if malloc worked as expected */
+		if(*stamps == NULL)
+		{
+			free(text);
+			free(db_name);
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	for(i = 0; valid && i < modules_num; i++)
+	{
+		m = calloc(1, sizeof(object_module));
+
+		/* verify if calloc worked as expected */
+		if(m == NULL)
+		{
+			free(text);
+			free(db_name);
+			free_object_modules(&head);
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+
+		if(curr == NULL) {
+			head = m;
+		}
+		else curr -> next = m;
+		curr = m;
+
+		if(!next_text_line(&pos, end, line, sizeof(line)) ||
+				sscanf(line, "%511s %d %d %d %d %lu %lu %lu %lu %lu %lu %d %d", name, &(m -> ic), &(m -> dc), &(m -> code_base), &(m -> data_base),
+				*stamps + i*6, *stamps + i*6 + 1, *stamps + i*6 + 2, *stamps + i*6 + 3, *stamps + i*6 + 4, *stamps + i*6 + 5,
+				&entries_num, &externs_num) != 13) {
+			valid = 0;
+			break;
+		}
+		m -> name = module_file_name(name, "");	/* a copy of the name */
+
+		/* the entries and the externals are parsed like the lines of '.ent' and '.ext' files */
+		refs = pos;
+		for(j = 0; j < entries_num && next_text_line(&pos, end, line, sizeof(line)); j++);
+		valid = (j == entries_num) && parse_symbol_refs(refs, pos - refs, db_name, &(m -> entries));
+
+		refs = pos;
+		for(j = 0; j < externs_num && next_text_line(&pos, end, line, sizeof(line)); j++);
+		valid = valid && (j == externs_num) && parse_symbol_refs(refs, pos - refs, db_name, &(m -> externs));
+	}
+
+	free(text);
+	free(db_name);
+
+	if(!valid) {
+		free_object_modules(&head);
+		if(*stamps != NULL) {
+			free(*stamps);
+		}
+		*stamps = NULL;
+		return NULL;
+	}
+
+	return head;
+}
+
+
+/**
+ * get_module_stamps function gets the stamps (content hash and size) of the '.ob', '.ent' and '.ext' files of a module.
+ *
+ * @param name - the name of the module.
+ * @param stamps - an array of 6 where to store the stamps.
+ */
+void get_module_stamps(const char* name, unsigned long* stamps)
+{
+	char* file_name;
+
+	file_name = module_file_name(name, OB_EXTENSION);
+	get_file_stamp(file_name, stamps, stamps + 1);
+	free(file_name);
+
+	file_name = module_file_name(name, ENT_EXTENSION);
+	get_file_stamp(file_name, stamps + 2, stamps + 3);
+	free(file_name);
+
+	file_name = module_file_name(name, EXT_EXTENSION);
+	get_file_stamp(file_name, stamps + 4, stamps + 5);
+	free(file_name);
+}
+
+
+/**
+ * get_file_stamp function gets the content hash and the size of a file.
+ *
+ * @param path - the name of the file.
+ * @param hash - an address of an unsigned long where to store the content hash (0 if the file doesn't exist).
+ * @param size - an address of an unsigned long where to store the size (0 if the file doesn't exist).
+ */
+void get_file_stamp(const char* path, unsigned long* hash, unsigned long* size)
+{
+	char* text;
+	size_t len;
+
+	text = read_whole_file(path, &len);
+	if(text == NULL) {
+		*hash = 0;
+		*size = 0;
+		return;
+	}
+
+	*hash = content_hash(text, len);
+	*size = (unsigned long)len;
+	free(text);
+}
+
+
+/**
+ * content_hash function returns the hash of the contents of a file (32 bit FNV-1a).
+ *
+ * @param text - the contents of the file.
+ * @param len - the length of the contents.
+ * @return - the hash value.
+ */
+unsigned long content_hash(const char* text, size_t len)
+{
+	unsigned long hash;
+	size_t i;
+
+	hash = 2166136261UL;
+	for(i = 0; i < len; i++) {
+		hash = ((hash ^ (unsigned char)text[i]) * 16777619UL) & 0xFFFFFFFFUL;
+	}
+
+	return hash;
+}
+
+
+/**
+ * same_entries function checks whether 2 versions of a module have the same entry labels (in the same order).
+ *
+ * @param a - a pointer to the first version.
+ * @param b - a pointer to the second version.
+ * @return - 1 if the entry labels are the same, otherwise 0 is returned.
+ */
+int same_entries(om_ptr a, om_ptr b)
+{
+	sr_ptr p;
+	sr_ptr q;
+
+	for(p = a -> entries, q = b -> entries; p != NULL && q != NULL; p = p -> next, q = q -> next) {
+		if(strcmp(p -> label, q -> label) != 0) {
+			return 0;
+		}
+	}
+
+	return p == NULL && q == NULL;
+}
+
+
+/**
+ * write_linked_word function writes a word in place in a linked image.
+ *
+ * @param image - the contents of the linked image.
+ * @param header_len - the length of the header line of the linked image.
+ * @param addr - the address of the word.
+ * @param word - the word.
+ * @param tag - the A/R/E tag of the word.
+ */
+void write_linked_word(char* image, long header_len, int addr, int word, char tag)
+{
+	char line[LINKED_LINE_LENGTH + 1];	/* +1 for the null terminator sprintf function writes */
+
+	sprintf(line, "%04d %03X %c\n", addr, word, tag);
+	memcpy(image + header_len + (long)(addr - FIRST_ADDRESS) * LINKED_LINE_LENGTH, line, LINKED_LINE_LENGTH);
+}
+
+
+/**
+ * replace_file function replaces the linked image with new contents: they're written to a temporary file that is renamed to the image.
+ *
+ * @param out - the name of the linked image (without extension).
+ * @param image - the new contents of the linked image.
+ * @param len - the length of the contents.
+ * @return - 1 if the linked image was replaced, otherwise 0 is returned (the linked image is not changed).
+ */
+int replace_file(const char* out, const char* image, size_t len)
+{
+	char* file_name;
+	char* tmp_name;
+	FILE* fp;
+	int written;
+
+	file_name = module_file_name(out, OB_EXTENSION);
+	tmp_name = module_file_name(out, LINK_TMP_EXTENSION);
+
+	fp = fopen(tmp_name, "wb");
+	written = fp != NULL && fwrite(image, 1, len, fp) == len;
+	if(fp != NULL && fclose(fp) != 0) {
+		written = 0;
+	}
+
+	if(written && rename(tmp_name, file_name) != 0) {
+		written = 0;
+	}
+	if(!written) {
+		remove(tmp_name);
+	}
+
+	free(tmp_name);
+	free(file_name);
+
+	return written;
+}
@@ -0,0 +1,133 @@
+#ifndef RELINK_H
+#define RELINK_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "object_module.h"
+#include "link.h"
+#define LINK_DB_EXTENSION ".lnk"
+#define LINK_DB_MAGIC "LNK2"
+#define LINK_TMP_EXTENSION ".ob.tmp"	/* the new linked image is written to this file, then renamed to the '.ob' file */
+#define MAX_LINK_DB_LINE_LENGTH 512
+#define LINKED_LINE_LENGTH 11	/* "AAAA WWW T\n", the length of a word line of a linked image of less than 10000 words */
+#define RELINK_FULL 0	/* the result of incremental_link function: a full link is needed */
+#define RELINK_DONE 1	/* the result of incremental_link function: the linked image was updated */
+#define RELINK_FAILED 2	/* the result of incremental_link function: errors were found */
+
+/*
+ * The link database ('<out>.lnk' file) is written next to a linked image when the 'linker' runs in incremental mode. It holds everything an
+ * incremental relink needs to know about the modules without reading them:
+ * "LNK2 MODULES IC DC IMAGE_HASH IMAGE_SIZE" header line, and for every module (in link order):
+ * "NAME IC DC CODE_BASE DATA_BASE OB_HASH OB_SIZE ENT_HASH ENT_SIZE EXT_HASH EXT_SIZE ENTRIES EXTERNS" line, followed by the
+ * "LABEL ADDRESS" lines of its '.ent' and '.ext' files.
+ * The files are compared by the hash of their contents (see content_hash function) and not by their modification time: a module assembled
+ * again within the same second has the same time, and its '.ob' file usually has the same size.
+ */
+
+
+/**
+ * incremental_link function updates a linked image after some of its modules were assembled again. A module is read again only if one of its
+ * files changed since the last link (see the link database above). If every changed module still has the same number of code and data words
+ * and the same entry labels, its words are relocated and written in place in the linked image, and only the words of other modules that
+ * refer to its entry labels are patched again. The words are written in memory, and the linked image is replaced (see replace_file function)
+ * only if no errors were found, so it's never left half updated. In any other case (no link database, different modules, a module changed its size or its
+ * entry labels, or an external label is not defined) a full link is needed.
+ *
+ * @param names - the names of the modules, in link order.
+ * @param names_num - the number of modules.
+ * @param out - the name of the linked image (without extension).
+ * @return - RELINK_DONE if the linked image was updated (or is up to date), RELINK_FAILED if errors were found (they are reported with
+ *           link_error function), otherwise RELINK_FULL is returned.
+ */
+int incremental_link(char** names, int names_num, const char* out);
+
+
+/**
+ * create_link_db function writes the link database of a linked image.
+ *
+ * @param head - the head of the list of the linked modules.
+ * @param out - the name of the linked image (without extension).
+ */
+void create_link_db(om_ptr head, const char* out);
+
+
+/**
+ * read_link_db function reads the link database of a linked image. Every module of the database is returned as a module without words
+ * (the words of a module are needed only if it changed).
+ *
+ * @param out - the name of the linked image (without extension).
+ * @param total_ic - an address of an integer where to store the number of code words of the linked image.
+ * @param total_dc - an address of an integer where to store the number of data words of the linked image.
+ * @param stamps - an address of a pointer where to store the stamps of the files of the modules (6 per module: content hash and size of the
+ *                 '.ob', '.ent' and '.ext' files), must be freed.
+ * @return - the head of the list of modules, or NULL if the database doesn't exist, is not valid or doesn't match the linked image.
+ */
+om_ptr read_link_db(const char* out, int* total_ic, int* total_dc, unsigned long** stamps);
+
+
+/**
+ * get_module_stamps function gets the stamps (content hash and size) of the '.ob', '.ent' and '.ext' files of a module.
+ * The stamps of a file that doesn't exist are 0.
+ *
+ * @param name - the name of the module.
+ * @param stamps - an array of 6 where to store the stamps.
+ */
+void get_module_stamps(const char* name, unsigned long* stamps);
+
+
+/**
+ * get_file_stamp function gets the content hash and the size of a file.
+ *
+ * @param path - the name of the file.
+ * @param hash - an address of an unsigned long where to store the content hash (0 if the file doesn't exist).
+ * @param size - an address of an unsigned long where to store the size (0 if the file doesn't exist).
+ */
+void get_file_stamp(const char* path, unsigned long* hash, unsigned long* size);
+
+
+/**
+ * content_hash function returns the hash of the contents of a file (32 bit FNV-1a), so a file that changed is found even if its
+ * modification time and size are the same.
+ *
+ * @param text - the contents of the file.
+ * @param len - the length of the contents.
+ * @return - the hash value.
+ */
+unsigned long content_hash(const char* text, size_t len);
+
+
+/**
+ * same_entries function checks whether 2 versions of a module have the same entry labels (in the same order).
+ *
+ * @param a - a pointer to the first version.
+ * @param b - a pointer to the second version.
+ * @return - 1 if the entry labels are the same, otherwise 0 is returned.
+ */
+int same_entries(om_ptr a, om_ptr b);
+
+
+/**
+ * write_linked_word function writes a word in place in the contents of a linked image.
+ *
+ * @param image - the contents of the linked image.
+ * @param header_len - the length of the header line of the linked image.
+ * @param addr - the address of the word.
+ * @param word - the word.
+ * @param tag - the A/R/E tag of the word.
+ */
+void write_linked_word(char* image, long header_len, int addr, int word, char tag);
+
+
+/**
+ * replace_file function replaces the linked image with new contents: they're written to '<out>.ob.tmp', which is renamed to the image, so
+ * the linked image is either the old one or the new one.
+ *
+ * @param out - the name of the linked image (without extension).
+ * @param image - the new contents of the linked image.
+ * @param len - the length of the contents.
+ * @return - 1 if the linked image was replaced, otherwise 0 is returned (the linked image is not changed).
+ */
+int replace_file(const char* out, const char* image, size_t len);
+
+
+#endif
@@ -0,0 +1,285 @@
+/**
+ * This is the main file of the 'simulator'. It executes images the 'assembler' / 'linker' created (the names of the images are given without
+ * extension). The input of 'red' is read from the standard input and the output of 'prn' is written to the standard output.
+ * Usage: simulator [-b] [-t] [-p] [-e] [-s] [-r] [-n max_instructions] [-v vectors_file] image...
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "simulator.h"
+#include "emergency_free_mem.h"
+
+om_ptr curr_image = NULL;	/* the image currently loaded */
+machine_ptr curr_machine = NULL;	/* the machine currently running */
+lanes_ptr curr_lanes = NULL;	/* the instances currently running in lockstep */
+profile_ptr curr_profile = NULL;	/* the profile of the machine currently running */
+trace_ptr curr_trace = NULL;	/* the trace of the machine currently running */
+
+/* command line options */
+static int benchmark = 0;
+static int translate = 0;
+static int profiling = 0;
+static int tracing = 0;
+static int save_snapshots = 0;
+static int restore_snapshots = 0;
+static const char* vectors = NULL;
+static long max_steps = NO_STEP_LIMIT;
+
+
+/* main function */
+int main(int argc, char* argv[])
+{
+	/* variable definitions */
+	long executed;
+	long total_executed;
+	double seconds;
+	double total_seconds;
+	int images_num;
+	int failed;
+	int i;
+
+	/* variable initializations */
+	total_executed = 0;
+	total_seconds = 0;
+	images_num = 0;
+	failed = 0;
+
+
+	/* get options from terminal input loop */
+	for(i = 1; i < argc; i++) {
+		if(argv[i][0] != '-') {
+			images_num++;
+		}
+		else if(strcmp(argv[i], BENCHMARK_OPTION) == 0) {
+			benchmark = 1;
+		}
+		else if(strcmp(argv[i], TRANSLATE_OPTION) == 0) {
+			translate = 1;
+		}
+		else if(strcmp(argv[i], PROFILE_OPTION) == 0) {
+			profiling = 1;
+		}
+		else if(strcmp(argv[i], TRACE_OPTION) == 0) {
+			tracing = 1;
+		}
+		else if(strcmp(argv[i], SAVE_SNAPSHOT_OPTION) == 0) {
+			save_snapshots = 1;
+		}
+		else if(strcmp(argv[i], RESTORE_SNAPSHOT_OPTION) == 0) {
+			restore_snapshots = 1;
+		}
+		else if(strcmp(argv[i], VECTORS_OPTION) == 0 && argv[i+1] != NULL) {
+			vectors = argv[++i];
+		}
+		else if(strcmp(argv[i], MAX_STEPS_OPTION) == 0 && argv[i+1] != NULL && sscanf(argv[i+1], "%ld", &max_steps) == 1 && max_steps >= 0) {
+			i++;
+		}
+		else {
+			printf("Unknown option '%s'. Program terminated.\n", argv[i]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if(images_num == 0) {
+		printf("No images to run. Usage: simulator [%s] [%s] [%s] [%s] [%s] [%s] [%s max_instructions] [%s vectors_file] image...\n",
+				BENCHMARK_OPTION, TRANSLATE_OPTION, PROFILE_OPTION, TRACE_OPTION, SAVE_SNAPSHOT_OPTION, RESTORE_SNAPSHOT_OPTION, MAX_STEPS_OPTION,
+				VECTORS_OPTION);
+		exit(EXIT_FAILURE);
+	}
+
+	if(vectors != NULL && (profiling || tracing || save_snapshots)) {
+		printf("Options '%s' and '%s' can't be used together. Program terminated.\n",
+				profiling ? PROFILE_OPTION : tracing ? TRACE_OPTION : SAVE_SNAPSHOT_OPTION, VECTORS_OPTION);
+		exit(EXIT_FAILURE);
+	}
+
+
+	/* run images loop */
+	for(i = 1; i < argc; i++) {
+		if(strcmp(argv[i], MAX_STEPS_OPTION) == 0 || strcmp(argv[i], VECTORS_OPTION) == 0) {	/* skip the number / file name too */
+			i++;
+			continue;
+		}
+		if(argv[i][0] == '-') {
+			continue;
+		}
+
+		executed = 0;
+		seconds = 0;
+		if(!run_image(argv[i], &executed, &seconds)) {
+			failed++;
+		}
+		if(benchmark) {
+			print_speed(argv[i], executed, seconds);
+		}
+		total_executed += executed;
+		total_seconds += seconds;
+	}
+
+	if(benchmark && images_num > 1) {
+		print_speed("all images", total_executed, total_seconds);
+	}
+
+	if(failed) {
+		printf("\n****  %d of %d images failed  ****\n\n", failed, images_num);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+
+/**
+ * run_image function loads an image (or restores its snapshot) and executes it.
+ *
+ * @param name - the name of the image (without extension).
+ * @param executed - an address of an integer where to add the number of instructions executed (by all instances).
+ * @param seconds - an address of a double where to add the time of the execution.
+ * @return - 1 if the image was executed until 'stop' (or the step limit), otherwise 0 is returned.
+ */
+int run_image(const char* name, long* executed, double* seconds)
+{
+	machine_status res;
+	clock_t start;
+
+	if(!restore_snapshots || profiling) {	/* a restored image is loaded only for the entry labels of its profile */
+		curr_image = load_object_module(name);
+		if(curr_image == NULL) {
+			return 0;
+		}
+	}
+
+	start = clock();
+	curr_machine = restore_snapshots ? restore_snapshot(name) : create_machine(curr_image);
+	if(curr_machine != NULL && restore_snapshots && benchmark) {
+		printf("\n%s: restored from '%s%s' in %.0f microseconds\n", name, name, SNAPSHOT_EXTENSION,
+				(double) (clock() - start) * 1000000 / CLOCKS_PER_SEC);
+	}
+	if(curr_machine != NULL && profiling) {
+		curr_profile = create_profile(curr_image);	/* before the module is freed, for its entry labels */
+		curr_machine -> prof = curr_profile;
+	}
+	if(curr_machine != NULL && tracing) {
+		curr_trace = create_trace();
+		curr_machine -> trace = curr_trace;
+	}
+	free_object_modules(&curr_image);
+	if(curr_machine == NULL) {
+		return 0;
+	}
+
+	if(vectors != NULL) {
+		return run_image_lanes(name, executed, seconds);
+	}
+
+	start = clock();
+	res = translate && !profiling && !tracing ? run_translated(curr_machine, max_steps) : run_machine(curr_machine, max_steps);
+	*seconds += (double) (clock() - start) / CLOCKS_PER_SEC;
+	*executed += curr_machine -> executed;
+	fflush(stdout);
+
+	if(profiling) {
+		profile_end(curr_profile, curr_machine -> executed);
+		write_profile(curr_profile);
+		free_profile(&curr_profile);
+	}
+
+	if(tracing) {
+		trace_end(curr_trace, curr_machine);
+		write_trace(curr_trace, name);
+		free(curr_trace);
+		curr_trace = NULL;
+		curr_machine -> trace = NULL;
+	}
+
+	if(res == MACHINE_ERROR) {
+		printf("\nRuntime error in image '%s%s', address %04d: %s\n", name, OB_EXTENSION, curr_machine -> pc, curr_machine -> error);
+	}
+	else if(res == MACHINE_STEP_LIMIT) {
+		printf("\nImage '%s%s' was stopped after %ld instructions (the limit).\n", name, OB_EXTENSION, curr_machine -> executed);
+	}
+
+	if(save_snapshots && res != MACHINE_ERROR) {
+		save_snapshot(curr_machine, name);
+	}
+
+	free(curr_machine);
+	curr_machine = NULL;
+
+	return res != MACHINE_ERROR;
+}
+
+
+/**
+ * run_image_lanes function runs an instance of the loaded image for every line of an input vectors file, in lockstep.
+ *
+ * @param name - the name of the image (without extension).
+ * @param executed - an address of an integer where to add the number of instructions executed by all instances.
+ * @param seconds - an address of a double where to add the time of the execution.
+ * @return - 1 if no instance failed, otherwise 0 is returned.
+ */
+int run_image_lanes(const char* name, long* executed, double* seconds)
+{
+	clock_t start;
+	int failed;
+
+	curr_lanes = create_lanes(curr_machine, vectors);
+	if(curr_lanes == NULL) {
+		free(curr_machine);
+		curr_machine = NULL;
+		return 0;
+	}
+
+	start = clock();
+	*executed += run_lanes(curr_lanes, max_steps);
+	*seconds += (double) (clock() - start) / CLOCKS_PER_SEC;
+
+	failed = print_lanes(curr_lanes);
+	if(failed) {
+		printf("\n%d of %d instances of image '%s%s' failed.\n", failed, curr_lanes -> lanes_num, name, OB_EXTENSION);
+	}
+
+	free_lanes(&curr_lanes);
+	free(curr_machine);
+	curr_machine = NULL;
+
+	return !failed;
+}
+
+
+/**
+ * print_speed function prints the number of instructions executed and the number of instructions executed per second.
+ *
+ * @param title - the name of what was executed.
+ * @param executed - the number of instructions executed.
+ * @param seconds - the time of the execution.
+ */
+void print_speed(const char* title, long executed, double seconds)
+{
+	if(seconds > 0) {
+		printf("\n%s: %ld instructions in %.3f seconds, %.0f instructions per second\n", title, executed, seconds, executed / seconds);
+	}
+	else printf("\n%s: %ld instructions (too fast to measure)\n", title, executed);
+}
+
+
+/**
+ * emergency_free_mem function frees all memory allocated during the execution. This function is called ONLY if any memory allocation fails.
+ * This function is not included in any .header file ('only in emergency_free.mem_h') to prevent using it accidentally.
+ */
+void emergency_free_mem()
+{
+	free_object_modules(&curr_image);
+	if(curr_machine != NULL) {
+		free(curr_machine);
+	}
+	curr_machine = NULL;
+	free_block_cache();
+	free_lanes(&curr_lanes);
+	free_profile(&curr_profile);
+	if(curr_trace != NULL) {
+		free(curr_trace);
+	}
+	curr_trace = NULL;
+}
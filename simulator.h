@@ -0,0 +1,59 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>	/* for clock function */
+#include "object_module.h"
+#include "machine.h"
+#include "block_cache.h"
+#include "lockstep.h"
+#include "profiler.h"
+#include "snapshot.h"
+#include "trace.h"
+#define BENCHMARK_OPTION "-b"	/* report the number of instructions executed per second, for every image and for all images */
+#define MAX_STEPS_OPTION "-n"	/* the maximum number of instructions to execute follows */
+#define VECTORS_OPTION "-v"	/* an input vectors file follows, an instance of the image runs for every line of it, all in lockstep */
+#define TRANSLATE_OPTION "-t"	/* execute basic blocks translated once and cached (see 'block_cache.h') instead of one instruction at a time */
+#define PROFILE_OPTION "-p"	/* profile the execution and write the reports to <image>.prof and <image>.folded (see 'profiler.h') */
+#define SAVE_SNAPSHOT_OPTION "-s"	/* save the state of the machine to <image>.snap when it stops or reaches the step limit (see 'snapshot.h') */
+#define RESTORE_SNAPSHOT_OPTION "-r"	/* continue from the state saved in <image>.snap instead of loading <image>.ob */
+#define TRACE_OPTION "-e"	/* record the last instructions executed and write them to <image>.trace (see 'trace.h' and 'tracedump') */
+
+
+/**
+ * run_image function loads an image and executes it from its first address, or restores its snapshot and continues from there
+ * (RESTORE_SNAPSHOT_OPTION). With an input vectors file, an instance of the image runs for every line of the file (see 'lockstep.h') and the
+ * output of every instance is printed when all are done. The options of the command line select how it's executed.
+ *
+ * @param name - the name of the image (without extension).
+ * @param executed - an address of an integer where to add the number of instructions executed (by all instances).
+ * @param seconds - an address of a double where to add the time of the execution.
+ * @return - 1 if the image was executed until 'stop' (or the step limit), otherwise 0 is returned.
+ */
+int run_image(const char* name, long* executed, double* seconds);
+
+
+/**
+ * run_image_lanes function runs an instance of the loaded image (curr_machine) for every line of an input vectors file, in lockstep. The
+ * machine is freed when the function returns.
+ *
+ * @param name - the name of the image (without extension).
+ * @param executed - an address of an integer where to add the number of instructions executed by all instances.
+ * @param seconds - an address of a double where to add the time of the execution.
+ * @return - 1 if no instance failed, otherwise 0 is returned.
+ */
+int run_image_lanes(const char* name, long* executed, double* seconds);
+
+
+/**
+ * print_speed function prints the number of instructions executed and the number of instructions executed per second.
+ *
+ * @param title - the name of what was executed.
+ * @param executed - the number of instructions executed.
+ * @param seconds - the time of the execution.
+ */
+void print_speed(const char* title, long executed, double seconds);
+
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * This file contains all functions related to snapshots of the 'simulator': the state of a machine (registers, flags, stack and memory) is
+ * saved to a compact binary file, and restored from it, so an execution can continue from a checkpoint instead of running again from the
+ * start of the image.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for mmap */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "snapshot.h"
+#include "link.h"	/* for link_error function */
+#include "emergency_free_mem.h"
+
+
+/**
+ * save_snapshot function saves the state of a machine to '<name>.snap'.
+ *
+ * @param mc - a pointer to the machine.
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the snapshot was saved, otherwise 0 is returned.
+ */
+int save_snapshot(machine_ptr mc, const char* name)
+{
+	char* file_name;
+	FILE* fp;
+	int memory_end;
+	int i;
+
+	file_name = module_file_name(name, SNAPSHOT_EXTENSION);
+	fp = fopen(file_name, "wb");
+	if(fp == NULL) {
+		link_error(file_name, 0, "The snapshot file could not be created.", NULL);
+		free(file_name);
+		return 0;
+	}
+
+	for(memory_end = MEMORY_SIZE; memory_end > mc -> code_end && mc -> memory[memory_end - 1] == 0; memory_end--)
+		;
+
+	fwrite(SNAPSHOT_MAGIC, 1, strlen(SNAPSHOT_MAGIC), fp);
+	put_snapshot_int(fp, mc -> pc, 4);
+	put_snapshot_int(fp, mc -> zero, 4);
+	put_snapshot_int(fp, mc -> sp, 4);
+	put_snapshot_int(fp, mc -> code_end, 4);
+	put_snapshot_int(fp, memory_end, 4);
+	for(i = 0; i < REGISTERS_NUM; i++) {
+		put_snapshot_int(fp, mc -> regs[i], 4);
+	}
+	for(i = 0; i < mc -> sp; i++) {
+		put_snapshot_int(fp, mc -> stack[i], 2);
+	}
+	for(i = 0; i < memory_end; i++) {
+		put_snapshot_int(fp, mc -> memory[i], 2);
+	}
+
+	if(ferror(fp)) {
+		fclose(fp);
+		link_error(file_name, 0, "The snapshot file could not be written.", NULL);
+		free(file_name);
+		return 0;
+	}
+
+	printf("\nFile '%s' has been created successfully!\n", file_name);
+	fclose(fp);
+	free(file_name);
+
+	return 1;
+}
+
+
+/**
+ * restore_snapshot function creates a machine in the state saved in '<name>.snap'.
+ *
+ * @param name - the name of the image (without extension).
+ * @return - a pointer to the machine, or NULL if the snapshot could not be restored.
+ */
+machine_ptr restore_snapshot(const char* name)
+{
+	machine_ptr mc;
+	char* file_name;
+	struct stat st;
+	int fd;
+	unsigned char* map;
+	const unsigned char* pos;
+	int pc, zero, sp, code_end, memory_end;
+	int i;
+
+	file_name = module_file_name(name, SNAPSHOT_EXTENSION);
+	fd = open(file_name, O_RDONLY);
+	if(fd == -1) {
+		link_error(file_name, 0, "The snapshot file could not be opened.", NULL);
+		free(file_name);
+		return NULL;
+	}
+
+	if(fstat(fd, &st) == -1 || st.st_size < SNAPSHOT_HEADER_LENGTH) {
+		close(fd);
+		link_error(file_name, 0, "Invalid snapshot file.", NULL);
+		free(file_name);
+		return NULL;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);	/* the mapping stays valid after the file is closed */
+	if(map == MAP_FAILED) {
+		link_error(file_name, 0, "The snapshot file could not be opened.", NULL);
+		free(file_name);
+		return NULL;
+	}
+
+	pos = map + strlen(SNAPSHOT_MAGIC);
+	pc = (int) get_snapshot_int(pos, 4);
+	zero = (int) get_snapshot_int(pos + 4, 4);
+	sp = (int) get_snapshot_int(pos + 8, 4);
+	code_end = (int) get_snapshot_int(pos + 12, 4);
+	memory_end = (int) get_snapshot_int(pos + 16, 4);
+	pos += 20;
+
+	if(memcmp(map, SNAPSHOT_MAGIC, strlen(SNAPSHOT_MAGIC)) != 0 || sp < 0 || sp > MAX_STACK_DEPTH || code_end < FIRST_ADDRESS ||
+			code_end > MEMORY_SIZE || memory_end < code_end || memory_end > MEMORY_SIZE ||
+			SNAPSHOT_HEADER_LENGTH + 2L * (sp + memory_end) != st.st_size) {
+		munmap(map, st.st_size);
+		link_error(file_name, 0, "Invalid snapshot file.", NULL);
+		free(file_name);
+		return NULL;
+	}
+	free(file_name);
+
+	mc = calloc(1, sizeof(machine));
+
+	/* verify if calloc worked as expected */
+	if(mc == NULL)
+	{
+		munmap(map, st.st_size);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	mc -> pc = pc;
+	mc -> zero = zero != 0;
+	mc -> sp = sp;
+	mc -> code_end = code_end;
+	for(i = 0; i < REGISTERS_NUM; i++, pos += 4) {
+		mc -> regs[i] = (int) get_snapshot_int(pos, 4) & WORD_MASK;
+	}
+	for(i = 0; i < sp; i++, pos += 2) {
+		mc -> stack[i] = (int) get_snapshot_int(pos, 2);
+	}
+	for(i = 0; i < memory_end; i++, pos += 2) {
+		mc -> memory[i] = (int) get_snapshot_int(pos, 2) & WORD_MASK;
+	}
+	munmap(map, st.st_size);
+
+	for(i = FIRST_ADDRESS; i < mc -> code_end; i++) {
+		predecode(mc, i);
+	}
+
+	return mc;
+}
+
+
+/**
+ * put_snapshot_int function writes an integer to a snapshot file in little endian order.
+ *
+ * @param fp - the file.
+ * @param val - the integer.
+ * @param bytes - the number of bytes.
+ */
+void put_snapshot_int(FILE* fp, long val, int bytes)
+{
+	int i;
+
+	for(i = 0; i < bytes; i++) {
+		putc((int) ((val >> (8 * i)) & 0xFF), fp);
+	}
+}
+
+
+/**
+ * get_snapshot_int function reads an integer in little endian order from a snapshot.
+ *
+ * @param pos - the address of the integer in the snapshot.
+ * @param bytes - the number of bytes.
+ * @return - the integer.
+ */
+long get_snapshot_int(const unsigned char* pos, int bytes)
+{
+	long val;
+	int i;
+
+	for(val = 0, i = bytes - 1; i >= 0; i--) {
+		val = (val << 8) | pos[i];
+	}
+
+	return val;
+}
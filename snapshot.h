@@ -0,0 +1,65 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "machine.h"
+#define SNAPSHOT_EXTENSION ".snap"
+#define SNAPSHOT_MAGIC "SNP1"
+#define SNAPSHOT_HEADER_LENGTH 56	/* the magic and 13 fields of 4 bytes: pc, zero, sp, code_end, memory_end and the 8 registers */
+
+
+/*
+ * The state of a machine is saved in a binary file of little endian integers, so a snapshot is portable between hosts:
+ *   the magic (4 bytes)
+ *   pc, zero flag, sp, code_end, memory_end (4 bytes each)
+ *   registers 0-7 (4 bytes each)
+ *   the return addresses of the stack, sp of them (2 bytes each)
+ *   the words of the memory from address 0 to memory_end (2 bytes each), the memory after the last nonzero word is not saved
+ * The decoded code is not saved, it's decoded again when the snapshot is restored.
+ */
+
+
+/**
+ * save_snapshot function saves the state of a machine to '<name>.snap'.
+ * Errors are reported with link_error function.
+ *
+ * @param mc - a pointer to the machine.
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the snapshot was saved, otherwise 0 is returned.
+ */
+int save_snapshot(machine_ptr mc, const char* name);
+
+
+/**
+ * restore_snapshot function creates a machine in the state saved in '<name>.snap'. The file is mapped to memory and copied into the machine
+ * in one pass. The number of instructions executed starts from 0 (so a step limit counts from the snapshot).
+ * Errors are reported with link_error function.
+ *
+ * @param name - the name of the image (without extension).
+ * @return - a pointer to the machine, or NULL if the snapshot could not be restored.
+ */
+machine_ptr restore_snapshot(const char* name);
+
+
+/**
+ * put_snapshot_int function writes an integer to a snapshot file in little endian order.
+ *
+ * @param fp - the file.
+ * @param val - the integer.
+ * @param bytes - the number of bytes (2 or 4).
+ */
+void put_snapshot_int(FILE* fp, long val, int bytes);
+
+
+/**
+ * get_snapshot_int function reads an integer in little endian order from a snapshot.
+ *
+ * @param pos - the address of the integer in the snapshot.
+ * @param bytes - the number of bytes (2 or 4).
+ * @return - the integer.
+ */
+long get_snapshot_int(const unsigned char* pos, int bytes);
+
+
+#endif
@@ -19,48 +19,29 @@
  * @param err - a pointer to err. (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
  */
 void insert(char* lbl, symb_ptr * head, symb_ptr * curr, int IC, attribute att, ERR_VALUE* err)
+{
+	insert_at_line(lbl, head, curr, IC, att, get_curr_line(), err);
+}
+
+
+/**
+ * insert_at_line function adds a label to the symbol table (list) like insert function, at a given line of the source file.
+ *
+ * @param lbl - the label to add to the symbol table.
+ * @param head - the pointer to the pointer that points to the head-symbol-table-linked-list.
+ * @param curr - the pointer to the pointer that points to the current-symbol-table-linked-list.
+ * @param IC - the number line in the file where the label is defined.
+ * @param att - the attribute of the label.
+ * @param line - the line in the source file where the label is defined or declared.
+ * @param err - a pointer to err, where the function stores the err enum value if it detects an error.
+ */
+void insert_at_line(char* lbl, symb_ptr * head, symb_ptr * curr, int IC, attribute att, int line, ERR_VALUE* err)
 {
 	symb_ptr temp = NULL;
 	symb_ptr p = NULL;
 
 	if(search_lbl(lbl, *head, &temp)) { /* search if label already exists and update its attribute if needed */
-		if((temp -> attr == entry && att == code) || (temp -> attr == code && att == entry)) {
-			temp -> attr = code_entry;
-		}
-		else if((temp -> attr == entry && att == data) || (temp -> attr == data && att == entry)) {
-			temp -> attr = data_entry;
-			temp -> addr = IC;	/* in which IC the label has appeared */
-		}
-        else if((temp -> attr == entry || temp -> attr == code_entry || temp -> attr == data_entry) && att == external) {
-            *err = ENTLY_LABEL_EXISTS_TRY_TO_ADD_EXTERN_LABEL;
-            return;
-        }
-        else if(temp -> attr == external && att == entry) {
-            *err = EXTERN_LABEL_EXISTS_TRY_TO_ADD_ENTRY_LABEL;
-            return;
-        }
-        else if((temp -> attr == code || temp -> attr == code_entry) && att == data) {
-            *err = LABEL_EXISTS_IN_CODE_TRY_TO_ADD_DATA_LABEL;
-            return;
-        }
-        else if((temp -> attr == data || temp -> attr == data_entry) && att == code) {
-            *err = LABEL_EXISTS_IN_DATA_TRY_TO_ADD_CODE_LABEL;
-            return;
-        }
-        else if((temp -> attr == code || temp -> attr == code_entry) && att == code) {
-            *err = DUPLICATE_CODE_LABEL_ATTEMPT;
-            return;
-        }
-        else if((temp -> attr == data || temp -> attr == data_entry) && att == data) {
-            *err = DUPLICATE_DATA_LABEL_ATTEMPT;
-            return;
-        }
-        else if((temp -> attr == entry || temp -> attr == code_entry || temp -> attr == data_entry) && att == entry) {    /* It's ok to have multiple entry declarations of same label, but no need to add it again to the symbol table */
-            return;
-        }
-        else if(temp -> attr == external && att == external) {  /* It's ok to have multiple extern declarations of same label, but no need to add it again to the symbol table */
-            return;
-        }
+		merge_symbol(temp, IC, att, line, err);
 		return;
 	}
 
@@ -74,18 +55,7 @@ void insert(char* lbl, symb_ptr * head, symb_ptr * curr, int IC, attribute att,
 		exit(EXIT_FAILURE);
 	}
 
-	strcpy(p -> label, lbl);
-	if(att == external) {
-		p -> addr = 0;
-	}
-	else if(temp == NULL && att == entry) {
-		p -> addr = get_curr_line();
-	}
-	else {
-		p -> addr = IC;
-	}
-	p -> attr = att;
-	p -> next = NULL;
+	init_symbol(p, lbl, IC, att, line);
 
 	/* if linked list is still empty */
 	if(!(*head))
@@ -103,6 +73,80 @@ void insert(char* lbl, symb_ptr * head, symb_ptr * curr, int IC, attribute att,
 }
 
 
+/**
+ * init_symbol function sets a new node of the symbol table to the first definition or declaration of its label.
+ *
+ * @param p - the pointer to the node.
+ * @param lbl - the label.
+ * @param IC - the number line in the file where the label is defined.
+ * @param att - the attribute of the label.
+ * @param line - the line in the source file where the label is defined or declared.
+ */
+void init_symbol(symb_ptr p, const char* lbl, int IC, attribute att, int line)
+{
+	strcpy(p -> label, lbl);
+	if(att == external) {
+		p -> addr = 0;
+	}
+	else if(att == entry) {
+		p -> addr = line;
+	}
+	else {
+		p -> addr = IC;
+	}
+	p -> attr = att;
+	p -> line = line;
+	p -> next = NULL;
+}
+
+
+/**
+ * merge_symbol function applies another definition or declaration of a label to its node in the symbol table.
+ *
+ * @param temp - the pointer to the node of the label.
+ * @param IC - the number line in the file where the label is defined.
+ * @param att - the attribute of the label.
+ * @param line - the line in the source file where the label is defined or declared.
+ * @param err - a pointer to err, where the function stores the err enum value if it detects an error.
+ */
+void merge_symbol(symb_ptr temp, int IC, attribute att, int line, ERR_VALUE* err)
+{
+	if((temp -> attr == entry && att == code) || (temp -> attr == code && att == entry)) {
+		if(temp -> attr == entry) {
+			temp -> addr = IC;	/* in which IC the label has appeared */
+			temp -> line = line;
+		}
+		temp -> attr = code_entry;
+	}
+	else if((temp -> attr == entry && att == data) || (temp -> attr == data && att == entry)) {
+		if(temp -> attr == entry) {
+			temp -> line = line;
+		}
+		temp -> attr = data_entry;
+		temp -> addr = IC;	/* in which IC the label has appeared */
+	}
+	else if((temp -> attr == entry || temp -> attr == code_entry || temp -> attr == data_entry) && att == external) {
+		*err = ENTLY_LABEL_EXISTS_TRY_TO_ADD_EXTERN_LABEL;
+	}
+	else if(temp -> attr == external && att == entry) {
+		*err = EXTERN_LABEL_EXISTS_TRY_TO_ADD_ENTRY_LABEL;
+	}
+	else if((temp -> attr == code || temp -> attr == code_entry) && att == data) {
+		*err = LABEL_EXISTS_IN_CODE_TRY_TO_ADD_DATA_LABEL;
+	}
+	else if((temp -> attr == data || temp -> attr == data_entry) && att == code) {
+		*err = LABEL_EXISTS_IN_DATA_TRY_TO_ADD_CODE_LABEL;
+	}
+	else if((temp -> attr == code || temp -> attr == code_entry) && att == code) {
+		*err = DUPLICATE_CODE_LABEL_ATTEMPT;
+	}
+	else if((temp -> attr == data || temp -> attr == data_entry) && att == data) {
+		*err = DUPLICATE_DATA_LABEL_ATTEMPT;
+	}
+	/* multiple entry declarations, or multiple extern declarations, of the same label are ok, but no need to add it again to the symbol table */
+}
+
+
 /**
  * search_lbl function searches if a label already exists in the symbol table (list).
  *
@@ -168,28 +212,20 @@ int is_extern_symb(char* label, symb_ptr head)
 
 
 /**
- * create_entry_file function creates an output entry file.
- * This function must be used ONLY if no errors were found during the execution of the 'assembler'.
+ * write_entry_file function writes the entry labels of the symbol table to an entries file.
  *
- * @param head_symb - the pointer to the head-symbol-table-linked-list.
- * @param fn - the name of the file of which the output file is being created.
+ * @param node - the pointer to the head-symbol-table-linked-list.
+ * @param file_name - the name of the entries file.
+ * @return - 1 if the file was written, 0 if it could not be created.
  */
-void create_entry_file(symb_ptr node, const char* fn)
+int write_entry_file(symb_ptr node, const char* file_name)
 {
-	char file_name[MAX_FILE_NAME_LENGTH + 5]; /* +1 for string terminator char, +4 for .ent extension */
 	FILE* fp = NULL;
 
-
-	strcpy(file_name, fn);	
-	file_name[strlen(file_name) - 3] = '\0'; /* remove .as extension */
-	strcat(file_name, ENT_EXTENSION);	/* add .ent extension */
-	
 	fp = fopen(file_name, "w+");
 
 	if(fp == NULL) {
-		printf("Could not create entries file.\n");
-		emergency_free_mem();
-		exit(EXIT_FAILURE);
+		return 0;
 	}
 
 
@@ -202,9 +238,28 @@ void create_entry_file(symb_ptr node, const char* fn)
 		node = node -> next;
 	}
 
-	printf("\nFile '%s' has been created successfully!", file_name);
-
 	fclose(fp);
+	return 1;
+}
+
+
+/**
+ * add_entry_refs function adds the entry labels of the symbol table to a list of symbol references, like the lines of the '.ent' file.
+ *
+ * @param node - the pointer to the head-symbol-table-linked-list.
+ * @param head - the pointer to the head of the list of references.
+ */
+void add_entry_refs(symb_ptr node, sr_ptr* head)
+{
+	sr_ptr curr;
+
+	for(curr = *head; curr != NULL && curr -> next != NULL; curr = curr -> next);
+
+	for(; node != NULL; node = node -> next) {
+		if(node -> attr == code_entry || node -> attr == data_entry) {
+			append_symbol_ref(head, &curr, node -> label, node -> addr, node -> line);
+		}
+	}
 }
 
 
@@ -6,6 +6,7 @@
 #include "line_details.h"
 #include "main_functions.h"	/* for get_file_name function */
 #include "handler_functions_for_memory.h"	/* for get_curr_line function */
+#include "object_module.h"	/* for symbol_ref struct */
 #define MAX_LABEL_LENGTH 31
 #define ENT_EXTENSION ".ent"
 
@@ -19,6 +20,7 @@ typedef struct symb
 	char label[MAX_LABEL_LENGTH + 1];	/* +1 for string terminator char */
 	int addr;
 	attribute attr;
+	int line;	/* the line in the source file where the label is defined (or declared, if it's not defined yet) */
 	symb_ptr next;
 }symb;
 
@@ -38,6 +40,48 @@ typedef struct symb
 void insert(char* lbl, symb_ptr * head, symb_ptr * curr, int IC, attribute att, ERR_VALUE* err);
 
 
+/**
+ * insert_at_line function adds a label to the symbol table (list) like insert function, for a definition or declaration at a given line of the
+ * source file instead of the line currently processed (get_curr_line function).
+ *
+ * @param lbl - the label to add to the symbol table.
+ * @param head - the pointer to the pointer that points to the head-symbol-table-linked-list.
+ * @param curr - the pointer to the pointer that points to the current-symbol-table-linked-list.
+ * @param IC - the number line in the file where the label is defined.
+ * @param att - the attribute of the label. (attribute enum is defined in 'line_details.h').
+ * @param line - the line in the source file where the label is defined or declared.
+ * @param err - a pointer to err. (ERR_VALUE enum) so the function can store there the err enum value if it detects an error.
+ */
+void insert_at_line(char* lbl, symb_ptr * head, symb_ptr * curr, int IC, attribute att, int line, ERR_VALUE* err);
+
+
+/**
+ * init_symbol function sets a new node of the symbol table to the first definition or declaration of its label (the rules of insert function
+ * for a label that is not in the symbol table yet).
+ *
+ * @param p - the pointer to the node.
+ * @param lbl - the label.
+ * @param IC - the number line in the file where the label is defined.
+ * @param att - the attribute of the label.
+ * @param line - the line in the source file where the label is defined or declared.
+ */
+void init_symbol(symb_ptr p, const char* lbl, int IC, attribute att, int line);
+
+
+/**
+ * merge_symbol function applies another definition or declaration of a label to its node in the symbol table (the rules of insert function for
+ * a label that is already in the symbol table): an entry declaration and a code / data definition become code_entry / data_entry, and the
+ * conflicting ones are errors (the node doesn't change). Repeated entry or extern declarations are ignored.
+ *
+ * @param temp - the pointer to the node of the label.
+ * @param IC - the number line in the file where the label is defined.
+ * @param att - the attribute of the label.
+ * @param line - the line in the source file where the label is defined or declared.
+ * @param err - a pointer to err, where the function stores the err enum value if it detects an error.
+ */
+void merge_symbol(symb_ptr temp, int IC, attribute att, int line, ERR_VALUE* err);
+
+
 /**
  * search_lbl function searches if a label already exists in the symbol table (list).
  *
@@ -81,13 +125,24 @@ void free_symb_list(symb_ptr* head_node);
 
 
 /**
- * create_entry_file function creates an output entry file.
+ * write_entry_file function writes the entry labels of the symbol table to an entries file, without printing anything.
+ *
+ * @param node - the pointer to the head-symbol-table-linked-list.
+ * @param file_name - the name of the entries file.
+ * @return - 1 if the file was written, 0 if it could not be created.
+ */
+int write_entry_file(symb_ptr node, const char* file_name);
+
+
+/**
+ * add_entry_refs function adds the entry labels of the symbol table to a list of symbol references, like the lines of the '.ent' file.
+ * The line of every reference is the line in the source file where the label is defined.
  * This function must be used ONLY if no errors were found during the execution of the 'assembler'.
  *
- * @param head_symb - the pointer to the head-symbol-table-linked-list.
- * @param fn - the name of the file of which the output file is being created.
+ * @param node - the pointer to the head-symbol-table-linked-list.
+ * @param head - the pointer to the head of the list of references.
  */
-void create_entry_file(symb_ptr node, const char* fn);
+void add_entry_refs(symb_ptr node, sr_ptr* head);
 
 
 /**
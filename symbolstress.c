@@ -0,0 +1,259 @@
+/**
+ * This file contains the 'symbolstress' program: it checks the concurrent symbol table of the 'assembler' (see 'concurrent_symbols.h') by
+ * inserting the same random labels on many threads, and compares the result with insert_at_line function.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for threads */
+#include <pthread.h>
+#include "symbolstress.h"
+#include "emergency_free_mem.h"
+
+static err_ptr head_err = NULL;	/* the errors the symbol table reported through error_controller function */
+static err_ptr curr_err = NULL;
+
+
+/* main function */
+int main(int argc, char* argv[])
+{
+	if(argc > 1) {
+		printf("No arguments are expected. Usage: symbolstress\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return stress_concurrent_symbols() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/**
+ * stress_concurrent_symbols function checks that the concurrent symbol table gives the same labels and errors as insert_at_line function.
+ *
+ * @return - 1 if all rounds are the same as insert_at_line function, otherwise 0 is returned.
+ */
+int stress_concurrent_symbols()
+{
+	static char labels[STRESS_EVENTS][MAX_LABEL_LENGTH + 1];
+	static const attribute attributes[] = {code, code, code, data, data, entry, entry, external};
+
+	pthread_t threads[STRESS_THREADS];
+	symbol_batch batches[STRESS_THREADS];
+	symbol_event* events;
+	symbol_event* expected_errors;
+	symbol_event* errors;
+	symb_ptr expected_head, expected_curr;
+	symb_ptr head, curr;
+	long expected_errors_num;
+	long errors_num;
+	double seconds, start;
+	int same, created, round;
+	long i;
+	int t;
+
+	events = malloc(STRESS_EVENTS * sizeof(symbol_event));
+	expected_errors = malloc(STRESS_EVENTS * sizeof(symbol_event));
+
+	/* verify if malloc worked as expected */
+	if(events == NULL || expected_errors == NULL)
+	{
+		free(events);
+		free(expected_errors);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	/* the same random definitions every time, inserted in order by insert_at_line function */
+	srand(STRESS_EVENTS);
+	expected_head = NULL;
+	expected_curr = NULL;
+	for(expected_errors_num = 0, i = 0; i < STRESS_EVENTS; i++)
+	{
+		sprintf(labels[i], "L%d", rand() % STRESS_LABELS);
+		events[i].seq = i;
+		events[i].IC = FIRST_ADDRESS + rand() % STRESS_EVENTS;
+		events[i].att = attributes[rand() % (sizeof(attributes) / sizeof(attributes[0]))];
+		events[i].line = (int) i + 1;
+		events[i].err = NO_ERRORS;
+		insert_at_line(labels[i], &expected_head, &expected_curr, events[i].IC, events[i].att, events[i].line, &events[i].err);
+		if(events[i].err != NO_ERRORS) {
+			expected_errors[expected_errors_num++] = events[i];
+		}
+	}
+
+	for(same = 1, seconds = 0, round = 0; round < STRESS_ROUNDS && same; round++)
+	{
+		create_concurrent_symbols(STRESS_LABELS);
+
+		for(t = 0; t < STRESS_THREADS; t++) {	/* every thread has every STRESS_THREADS'th definition, half of them backwards */
+			batches[t].labels = labels;
+			batches[t].events = events;
+			batches[t].events_num = STRESS_EVENTS;
+			batches[t].first = t;
+			batches[t].threads_num = STRESS_THREADS;
+			batches[t].backwards = (round + t) % 2;
+		}
+
+		/* the first batch is inserted by this thread, a batch whose thread could not be created too */
+		start = wall_clock();
+		for(created = 0, t = 1; t < STRESS_THREADS; t++) {
+			if(pthread_create(&threads[t], NULL, insert_symbol_batch, &batches[t]) != 0) {
+				break;
+			}
+			created++;
+		}
+		insert_symbol_batch(&batches[0]);
+		for(t = created + 1; t < STRESS_THREADS; t++) {
+			insert_symbol_batch(&batches[t]);
+		}
+		for(t = 1; t <= created; t++) {
+			pthread_join(threads[t], NULL);
+		}
+		seconds += wall_clock() - start;
+
+		for(t = 0; t < STRESS_THREADS; t++)
+		{
+			if(!batches[t].inserted)
+			{
+				free(events);
+				free(expected_errors);
+				free_symb_list(&expected_head);
+				fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+				free_concurrent_symbols();
+				emergency_free_mem();
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		export_concurrent_symbols(&head, &curr);
+		errors_num = concurrent_symbol_errors(&errors);
+
+		same = same_symbol_tables(expected_head, head) && errors_num == expected_errors_num;
+		for(i = 0; i < errors_num && same; i++) {
+			same = errors[i].seq == expected_errors[i].seq && errors[i].err == expected_errors[i].err;
+		}
+
+		free(errors);
+		free_symb_list(&head);
+		free_concurrent_symbols();
+	}
+
+	printf("Symbol table stress: %d rounds of %d definitions of %d labels (%ld errors) on %d threads, %s.\n", round, STRESS_EVENTS, STRESS_LABELS,
+		expected_errors_num, STRESS_THREADS, same ? "all the same as insert" : "DIFFERENT from insert");
+	if(seconds > 0) {
+		printf("%.0f insertions per second\n", (double) round * STRESS_EVENTS / seconds);
+	}
+
+	free(events);
+	free(expected_errors);
+	free_symb_list(&expected_head);
+
+	return same;
+}
+
+
+/**
+ * insert_symbol_batch function inserts the labels of one thread of stress_concurrent_symbols function.
+ *
+ * @param arg - a pointer to the labels.
+ * @return - NULL.
+ */
+void* insert_symbol_batch(void* arg)
+{
+	symbol_batch* batch;
+	const symbol_event* e;
+	long last;
+	long i;
+	long step;
+
+	batch = (symbol_batch*) arg;
+	batch -> inserted = 1;
+
+	if(batch -> first >= batch -> events_num) {
+		return NULL;
+	}
+
+	last = batch -> first + (batch -> events_num - 1 - batch -> first) / batch -> threads_num * batch -> threads_num;
+	step = batch -> backwards ? -batch -> threads_num : batch -> threads_num;
+
+	for(i = batch -> backwards ? last : batch -> first; i >= batch -> first && i <= last; i += step)
+	{
+		e = &batch -> events[i];
+		if(!insert_concurrent_symbol(batch -> labels[i], e -> IC, e -> att, e -> line, e -> seq)) {
+			batch -> inserted = 0;
+			return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * same_symbol_tables function compares 2 symbol tables (lists).
+ *
+ * @param first - the pointer to the head of the first list.
+ * @param second - the pointer to the head of the second list.
+ * @return - 1 if the lists are the same, otherwise 0 is returned.
+ */
+int same_symbol_tables(symb_ptr first, symb_ptr second)
+{
+	for(; first != NULL && second != NULL; first = first -> next, second = second -> next)
+	{
+		if(strcmp(first -> label, second -> label) != 0 || first -> addr != second -> addr || first -> attr != second -> attr ||
+			first -> line != second -> line) {
+			return 0;
+		}
+	}
+
+	return first == NULL && second == NULL;
+}
+
+
+/**
+ * error_controller function adds an error of the symbol table to the errors list, like the one of the 'assembler'.
+ *
+ * @param ln - the line in the file where the error has occurred.
+ * @param err - the enum value of the error.
+ * @param file_name - the name of the file in which the error has occured.
+ */
+void error_controller(int ln, ERR_VALUE err, const char* file_name)
+{
+	add_error(ln, err, &curr_err, &head_err, file_name);
+}
+
+
+/**
+ * get_curr_line function returns the line currently processed, for insert function. No source file is processed by this program, the labels
+ * are inserted with insert_at_line function.
+ *
+ * @return - 0.
+ */
+int get_curr_line()
+{
+	return 0;
+}
+
+
+/**
+ * get_file_name function returns the name of the currently processed file, for the errors of the symbol table. No source file is processed by
+ * this program.
+ *
+ * @return - the name of the program.
+ */
+char* get_file_name()
+{
+	return "symbolstress";
+}
+
+
+/**
+ * emergency_free_mem function frees all memory allocated during the execution. This function is called ONLY if any memory allocation fails.
+ */
+void emergency_free_mem()
+{
+	free_concurrent_symbols();
+	free_error_nodes(&head_err);
+	head_err = NULL;
+}
@@ -0,0 +1,60 @@
+#ifndef SYMBOLSTRESS_H
+#define SYMBOLSTRESS_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "concurrent_symbols.h"
+#include "symbol_table.h"	/* for insert_at_line function, the order the concurrent symbol table is compared with */
+#include "timing.h"	/* for wall_clock function */
+#include "errors.h"	/* for add_error function, the errors of the symbol table */
+#define STRESS_THREADS 8	/* the number of threads that insert the labels in stress_concurrent_symbols function */
+#define STRESS_ROUNDS 10	/* the number of times the labels are inserted in stress_concurrent_symbols function */
+#define STRESS_EVENTS 60000	/* the number of definitions and declarations of labels in stress_concurrent_symbols function */
+#define STRESS_LABELS 3000	/* the number of different labels in stress_concurrent_symbols function, so most labels are defined again */
+
+
+/* a struct that represents the labels one thread inserts in stress_concurrent_symbols function: every threads_num'th event starting at first,
+ * forwards or backwards */
+typedef struct symbol_batch {
+	char (*labels)[MAX_LABEL_LENGTH + 1];	/* the label of every event */
+	const symbol_event* events;	/* all events, in the order of their sequence numbers */
+	long events_num;
+	long first;
+	int threads_num;
+	int backwards;
+	int inserted;	/* 1 if all events were inserted, 0 if memory could not be allocated */
+} symbol_batch;
+
+
+/**
+ * stress_concurrent_symbols function checks the concurrent symbol table: a random list of STRESS_EVENTS definitions and
+ * declarations of STRESS_LABELS labels is inserted with insert_at_line function in order, then STRESS_ROUNDS times on STRESS_THREADS threads,
+ * every thread with its share of the list in another order. The labels and the errors of every round must be the same as the ones of
+ * insert_at_line function. The result and the number of insertions per second are printed.
+ *
+ * @return - 1 if all rounds are the same as insert_at_line function, otherwise 0 is returned.
+ */
+int stress_concurrent_symbols();
+
+
+/**
+ * insert_symbol_batch function inserts the labels of one thread of stress_concurrent_symbols function.
+ *
+ * @param arg - a pointer to the labels (symbol_batch struct), the signature of a thread function.
+ * @return - NULL.
+ */
+void* insert_symbol_batch(void* arg);
+
+
+/**
+ * same_symbol_tables function compares 2 symbol tables (lists): the same labels in the same order, with the same addresses, attributes and
+ * lines.
+ *
+ * @param first - the pointer to the head of the first list.
+ * @param second - the pointer to the head of the second list.
+ * @return - 1 if the lists are the same, otherwise 0 is returned.
+ */
+int same_symbol_tables(symb_ptr first, symb_ptr second);
+
+
+#endif
@@ -0,0 +1,392 @@
+/**
+ * This file contains all functions related to the test mode of the 'assembler': every source file of a directory is assembled in memory and
+ * executed, and its output is compared with the output it is expected to print. The tests run on a pool of threads in one process, and every
+ * thread reuses one machine for all of its tests.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for threads and directories */
+#include <pthread.h>
+#include <dirent.h>
+#include <unistd.h>
+#include "tester.h"
+#include "link.h"	/* for link_error function */
+#include "emergency_free_mem.h"
+
+
+/* the list of tests */
+static tc_ptr head_test = NULL;
+static tc_ptr curr_test = NULL;
+
+/* the tests run by the threads of run_tests function, and the next test a thread takes */
+static tc_ptr* tests = NULL;
+static int tests_num = 0;
+static int next_test = 0;
+static pthread_mutex_t next_test_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/**
+ * compare_names function compares two names for qsort function.
+ *
+ * @param x - a pointer to the first name.
+ * @param y - a pointer to the second name.
+ * @return - like strcmp function.
+ */
+int compare_names(const void* x, const void* y)
+{
+	return strcmp(*(char* const*) x, *(char* const*) y);
+}
+
+
+/**
+ * find_test_sources function lists the source files of a directory, sorted by name.
+ *
+ * @param dir - the name of the directory.
+ * @param n - an address of an integer where to store the number of source files.
+ * @return - an array of the names of the source files without extension, or NULL if the directory could not be opened.
+ */
+char** find_test_sources(const char* dir, int* n)
+{
+	DIR* d;
+	struct dirent* entry;
+	char** sources;
+	char** temp;
+	int size;
+	size_t len;
+
+	d = opendir(dir);
+	if(d == NULL) {
+		return NULL;
+	}
+
+	sources = NULL;
+	size = 0;
+	*n = 0;
+
+	while((entry = readdir(d)) != NULL) {
+		len = strlen(entry -> d_name);
+		if(len <= strlen(".as") || strcmp(entry -> d_name + len - strlen(".as"), ".as") != 0) {
+			continue;
+		}
+
+		if(*n == size) {
+			size = size == 0 ? 16 : size * 2;
+			temp = realloc(sources, size * sizeof(char*));
+
+			/* verify if realloc worked as expected */
+			if(temp == NULL)
+			{
+				closedir(d);
+				free_test_sources(sources, *n);
+				fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+				emergency_free_mem();
+				exit(EXIT_FAILURE);
+			}
+			sources = temp;
+		}
+
+		sources[*n] = malloc(strlen(dir) + 1 + len - strlen(".as") + 1);	/* +1 for '/' +1 for null string terminator */
+
+		/* verify if malloc worked as expected */
+		if(sources[*n] == NULL)
+		{
+			closedir(d);
+			free_test_sources(sources, *n);
+			fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+			emergency_free_mem();
+			exit(EXIT_FAILURE);
+		}
+
+		sprintf(sources[*n], "%s/%.*s", dir, (int) (len - strlen(".as")), entry -> d_name);
+		(*n)++;
+	}
+	closedir(d);
+
+	if(*n > 0) {
+		qsort(sources, *n, sizeof(char*), compare_names);
+	}
+
+	return sources;
+}
+
+
+/**
+ * free_test_sources function frees an array created by find_test_sources function.
+ *
+ * @param sources - the array.
+ * @param n - the number of names in the array.
+ */
+void free_test_sources(char** sources, int n)
+{
+	int i;
+
+	for(i = 0; i < n; i++) {
+		free(sources[i]);
+	}
+	free(sources);
+}
+
+
+/**
+ * add_test_case function adds a test to the end of the list of tests.
+ *
+ * @param name - the name of the source file (without extension).
+ * @param module - the assembled image, or NULL if errors were found in the source file.
+ */
+void add_test_case(const char* name, om_ptr module)
+{
+	tc_ptr tc;
+	char* file_name;
+
+	tc = calloc(1, sizeof(test_case));
+
+	/* verify if calloc worked as expected */
+	if(tc == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	if(curr_test == NULL) {	/* added before the allocations below, so free_test_cases function frees it */
+		head_test = tc;
+	}
+	else curr_test -> next = tc;
+	curr_test = tc;
+
+	tc -> name = module_file_name(name, "");
+	tc -> module = module;
+	tc -> loadable = module != NULL && check_image(module);
+	tc -> mismatch = -1;
+
+	file_name = module_file_name(name, TEST_OUTPUT_EXTENSION);
+	tc -> expected = read_whole_file(file_name, &(tc -> expected_len));
+	free(file_name);
+
+	file_name = module_file_name(name, TEST_INPUT_EXTENSION);
+	tc -> input = read_whole_file(file_name, &(tc -> input_len));
+	free(file_name);
+}
+
+
+/**
+ * run_tests function executes the tests on a pool of threads and prints their results.
+ *
+ * @return - the number of tests that failed.
+ */
+int run_tests()
+{
+	pthread_t threads[MAX_TEST_THREADS];
+	tc_ptr tc;
+	long executed;
+	double start;
+	double seconds;
+	int threads_num;
+	int failed;
+	int skipped;
+	int i;
+
+	for(tests_num = 0, tc = head_test; tc != NULL; tc = tc -> next) {
+		tests_num++;
+	}
+	if(tests_num == 0) {
+		printf("\nNo tests were found.\n");
+		return 0;
+	}
+
+	tests = malloc(tests_num * sizeof(tc_ptr));
+
+	/* verify if malloc worked as expected */
+	if(tests == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(i = 0, tc = head_test; tc != NULL; tc = tc -> next) {
+		tests[i++] = tc;
+	}
+	next_test = 0;
+
+	threads_num = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if(threads_num < 1) {
+		threads_num = 1;
+	}
+	if(threads_num > MAX_TEST_THREADS) {
+		threads_num = MAX_TEST_THREADS;
+	}
+	if(threads_num > tests_num) {
+		threads_num = tests_num;
+	}
+
+	start = wall_clock();
+	for(i = 0; i < threads_num; i++) {
+		if(pthread_create(&threads[i], NULL, test_worker, NULL) != 0) {
+			break;
+		}
+	}
+	if(i == 0) {	/* no thread could be created, the tests run in this thread */
+		test_worker(NULL);
+		threads_num = 1;
+	}
+	else threads_num = i;
+	for(i = 0; i < threads_num; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	seconds = wall_clock() - start;
+
+	putchar('\n');
+	for(failed = 0, skipped = 0, executed = 0, i = 0; i < tests_num; i++) {
+		switch(print_test_case(tests[i])) {
+			case TEST_FAILED:
+				failed++;
+				break;
+			case TEST_SKIPPED:
+				skipped++;
+				break;
+		}
+		executed += tests[i] -> executed;
+	}
+
+	printf("\n%d tests, %d passed, %d failed, %d skipped. %ld instructions in %.3f seconds on %d threads, %.0f instructions per second\n",
+		tests_num, tests_num - failed - skipped, failed, skipped, executed, seconds, threads_num, seconds > 0 ? executed / seconds : 0.0);
+
+	free(tests);
+	tests = NULL;
+
+	return failed;
+}
+
+
+/**
+ * test_worker function takes the next test that didn't run until no tests are left.
+ *
+ * @param arg - not used.
+ * @return - NULL.
+ */
+void* test_worker(void* arg)
+{
+	machine_ptr mc;
+	int i;
+
+	mc = calloc(1, sizeof(machine));
+
+	/* verify if calloc worked as expected */
+	if(mc == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	while(1) {
+		pthread_mutex_lock(&next_test_lock);
+		i = next_test < tests_num ? next_test++ : -1;
+		pthread_mutex_unlock(&next_test_lock);
+
+		if(i == -1) {
+			break;
+		}
+		run_test(mc, tests[i]);
+	}
+
+	free(mc -> output);
+	free(mc);
+
+	return NULL;
+}
+
+
+/**
+ * run_test function executes one test.
+ *
+ * @param mc - a pointer to the machine of the thread.
+ * @param tc - a pointer to the test.
+ */
+void run_test(machine_ptr mc, tc_ptr tc)
+{
+	double start;
+	size_t i;
+
+	if(!tc -> loadable) {
+		return;
+	}
+
+	load_machine(mc, tc -> module);
+	mc -> redirected = 1;
+	mc -> input = tc -> input;
+	mc -> input_end = tc -> input == NULL ? NULL : tc -> input + tc -> input_len;
+
+	start = wall_clock();
+	tc -> status = run_machine(mc, TEST_MAX_STEPS);
+	tc -> seconds = wall_clock() - start;
+	tc -> executed = mc -> executed;
+	tc -> error = mc -> error;
+	tc -> error_addr = mc -> pc;
+
+	if(tc -> expected != NULL) {
+		for(i = 0; i < tc -> expected_len && i < (size_t) mc -> output_len && tc -> expected[i] == mc -> output[i]; i++)
+			;
+		if(i < tc -> expected_len || i < (size_t) mc -> output_len) {
+			tc -> mismatch = (long) i;
+		}
+	}
+}
+
+
+/**
+ * print_test_case function prints the result of a test.
+ *
+ * @param tc - a pointer to the test.
+ * @return - TEST_PASSED, TEST_FAILED or TEST_SKIPPED.
+ */
+int print_test_case(tc_ptr tc)
+{
+	if(tc -> module == NULL) {
+		printf("FAIL %s: errors were found in the source file.\n", tc -> name);
+	}
+	else if(!tc -> loadable) {
+		printf("FAIL %s: the image can't be executed.\n", tc -> name);
+	}
+	else if(tc -> status == MACHINE_ERROR) {
+		printf("FAIL %s: error at address %d: %s\n", tc -> name, tc -> error_addr, tc -> error);
+	}
+	else if(tc -> status == MACHINE_STEP_LIMIT) {
+		printf("FAIL %s: stopped after %ld instructions (the limit).\n", tc -> name, tc -> executed);
+	}
+	else if(tc -> mismatch != -1) {
+		printf("FAIL %s: the output differs from '%s%s' at character %ld.\n", tc -> name, tc -> name, TEST_OUTPUT_EXTENSION, tc -> mismatch);
+	}
+	else if(tc -> expected == NULL) {
+		printf("SKIP %s: there is no '%s%s' file, the output was not checked.\n", tc -> name, tc -> name, TEST_OUTPUT_EXTENSION);
+		return TEST_SKIPPED;
+	}
+	else {
+		printf("PASS %s: %ld instructions in %.3f ms\n", tc -> name, tc -> executed, tc -> seconds * 1000);
+		return TEST_PASSED;
+	}
+
+	return TEST_FAILED;
+}
+
+
+/**
+ * free_test_cases function frees the list of tests.
+ */
+void free_test_cases()
+{
+	tc_ptr tc;
+
+	while(head_test != NULL) {
+		tc = head_test;
+		head_test = head_test -> next;
+		free(tc -> name);
+		free(tc -> expected);
+		free(tc -> input);
+		free(tc);
+	}
+	curr_test = NULL;
+}
@@ -0,0 +1,122 @@
+#ifndef TESTER_H
+#define TESTER_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "machine.h"
+#include "timing.h"	/* for wall_clock function */
+#define TEST_OUTPUT_EXTENSION ".out"	/* the expected output of a test ('prn') */
+#define TEST_INPUT_EXTENSION ".in"	/* the input of a test ('red'), optional */
+#define TEST_MAX_STEPS 100000000L	/* a test that doesn't stop after this number of instructions fails */
+#define MAX_TEST_THREADS 64
+#define TEST_PASSED 0	/* the results of a test (see print_test_case function) */
+#define TEST_FAILED 1
+#define TEST_SKIPPED 2	/* the test ran without errors but has no '.out' file, so its output wasn't checked */
+
+
+/* a pointer to struct test_case */
+typedef struct test_case* tc_ptr;
+
+/* a struct that represents one test: a source file that is assembled in memory and executed, and the output it is expected to print */
+typedef struct test_case {
+	char* name;	/* the name of the source file (without extension) */
+	om_ptr module;	/* the assembled image, NULL if errors were found in the source file */
+	int loadable;	/* 1 if the image can be loaded into a machine (see check_image function in 'machine.h') */
+	char* expected;	/* the contents of the '.out' file, NULL if there is no such file (then the test is skipped) */
+	size_t expected_len;
+	char* input;	/* the contents of the '.in' file, NULL if there is no such file */
+	size_t input_len;
+	machine_status status;
+	const char* error;	/* the description of the error if status is MACHINE_ERROR */
+	int error_addr;	/* the address of the instruction that failed */
+	long executed;	/* the number of instructions executed */
+	long mismatch;	/* the first character where the output differs from the expected output, -1 if it doesn't */
+	double seconds;	/* the time the test ran */
+	tc_ptr next;
+} test_case;
+
+
+/**
+ * find_test_sources function lists the source files ('.as') of a directory, sorted by name.
+ *
+ * @param dir - the name of the directory.
+ * @param n - an address of an integer where to store the number of source files.
+ * @return - an array of the names of the source files, as "<dir>/<name>" without extension (the array and the names must be freed with
+ *           free_test_sources function), or NULL if the directory could not be opened.
+ */
+char** find_test_sources(const char* dir, int* n);
+
+
+/**
+ * compare_names function compares two names for qsort function.
+ *
+ * @param x - a pointer to the first name (a pointer to a string).
+ * @param y - a pointer to the second name.
+ * @return - like strcmp function.
+ */
+int compare_names(const void* x, const void* y);
+
+
+/**
+ * free_test_sources function frees an array created by find_test_sources function.
+ *
+ * @param sources - the array.
+ * @param n - the number of names in the array.
+ */
+void free_test_sources(char** sources, int n);
+
+
+/**
+ * add_test_case function adds a test to the end of the list of tests, and reads its '.out' and '.in' files.
+ *
+ * @param name - the name of the source file (without extension).
+ * @param module - the assembled image, or NULL if errors were found in the source file. The module is not freed with the tests.
+ */
+void add_test_case(const char* name, om_ptr module);
+
+
+/**
+ * run_tests function executes the tests on a pool of threads (one per processor, up to MAX_TEST_THREADS) and prints the result and the time of
+ * every test, in the order they were added, followed by the number of tests that passed, failed and were skipped and the total throughput. Every thread loads the images of its tests into one machine
+ * (see load_machine function in 'machine.h'), so memory is allocated once per thread and not per test.
+ *
+ * @return - the number of tests that failed.
+ */
+int run_tests();
+
+
+/**
+ * test_worker function is the function of every thread of run_tests function: it takes the next test that didn't run until no tests are left.
+ *
+ * @param arg - not used.
+ * @return - NULL.
+ */
+void* test_worker(void* arg);
+
+
+/**
+ * run_test function executes one test.
+ *
+ * @param mc - a pointer to the machine of the thread.
+ * @param tc - a pointer to the test.
+ */
+void run_test(machine_ptr mc, tc_ptr tc);
+
+
+/**
+ * print_test_case function prints the result of a test in a line of its own. A test that ran without errors is skipped if it has no '.out'
+ * file, since a missing file must not let a test pass without checking its output.
+ *
+ * @param tc - a pointer to the test.
+ * @return - TEST_PASSED, TEST_FAILED or TEST_SKIPPED.
+ */
+int print_test_case(tc_ptr tc);
+
+
+/**
+ * free_test_cases function frees the list of tests (not their modules).
+ */
+void free_test_cases();
+
+
+#endif
@@ -0,0 +1,25 @@
+/**
+ * This file contains the clock the programs of the project time their work with.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* for the monotonic clock */
+#include <time.h>
+#include "timing.h"
+
+
+/**
+ * wall_clock function returns the time of a monotonic clock.
+ *
+ * @return - the time in seconds.
+ */
+double wall_clock()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,14 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+
+/**
+ * wall_clock function returns the time of a monotonic clock. The processor time of the process (clock function) adds the time of all threads,
+ * so it can't time work that runs in parallel.
+ *
+ * @return - the time in seconds.
+ */
+double wall_clock();
+
+
+#endif
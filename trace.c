@@ -0,0 +1,199 @@
+/**
+ * This file contains all functions related to execution traces of the 'simulator': a ring buffer of fixed size binary records of the last
+ * instructions executed, and the '.trace' file it's written to and 'tracedump' reads.
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "trace.h"
+#include "snapshot.h"	/* for put_snapshot_int and get_snapshot_int functions */
+#include "emergency_free_mem.h"
+
+
+/**
+ * create_trace function creates an empty trace.
+ *
+ * @return - a pointer to the trace.
+ */
+trace_ptr create_trace()
+{
+	trace_ptr t;
+
+	t = calloc(1, sizeof(trace));
+
+	/* verify if calloc worked as expected */
+	if(t == NULL)
+	{
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	return t;
+}
+
+
+/**
+ * trace_step function completes the last record of a trace and starts a record for the instruction at an address.
+ *
+ * @param t - a pointer to the trace.
+ * @param mc - a pointer to the machine.
+ * @param addr - the address of the instruction.
+ */
+void trace_step(trace_ptr t, machine_ptr mc, int addr)
+{
+	trace_record* rec;
+
+	if(t -> next > 0) {
+		trace_end(t, mc);
+	}
+
+	rec = &(t -> records[t -> next & (TRACE_RECORDS - 1)]);
+	rec -> addr = addr;
+	rec -> word = mc -> memory[addr];
+	t -> next++;
+}
+
+
+/**
+ * trace_end function completes the last record of a trace.
+ *
+ * @param t - a pointer to the trace.
+ * @param mc - a pointer to the machine.
+ */
+void trace_end(trace_ptr t, machine_ptr mc)
+{
+	trace_record* rec;
+	decoded_instruction* d;
+
+	if(t -> next == 0) {
+		return;
+	}
+
+	rec = &(t -> records[(t -> next - 1) & (TRACE_RECORDS - 1)]);
+	d = &(mc -> code[rec -> addr]);
+	rec -> zero = mc -> zero;
+	if(writes_operand(d -> op) && d -> dest_mode == regis_direct) {	/* the only register an instruction can change */
+		rec -> reg = d -> dest;
+		rec -> value = mc -> regs[d -> dest];
+	}
+	else {
+		rec -> reg = NO_REGISTER;
+		rec -> value = 0;
+	}
+}
+
+
+/**
+ * write_trace function writes the records of a trace, oldest first, to '<name>.trace'.
+ *
+ * @param t - a pointer to the trace.
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the file was written, otherwise 0 is returned.
+ */
+int write_trace(trace_ptr t, const char* name)
+{
+	char* file_name;
+	FILE* fp;
+	trace_record* rec;
+	long first;
+	long i;
+
+	file_name = module_file_name(name, TRACE_EXTENSION);
+	fp = fopen(file_name, "wb");
+	if(fp == NULL) {
+		link_error(file_name, 0, "The trace file could not be created.", NULL);
+		free(file_name);
+		return 0;
+	}
+
+	first = t -> next > TRACE_RECORDS ? t -> next - TRACE_RECORDS : 0;
+
+	fwrite(TRACE_MAGIC, 1, strlen(TRACE_MAGIC), fp);
+	put_snapshot_int(fp, t -> next - first, 4);
+	put_snapshot_int(fp, t -> next & 0xFFFFFFFFL, 4);	/* the number of instructions traced, 8 bytes */
+	put_snapshot_int(fp, (t -> next >> 16) >> 16, 4);
+	for(i = first; i < t -> next; i++) {
+		rec = &(t -> records[i & (TRACE_RECORDS - 1)]);
+		put_snapshot_int(fp, rec -> addr, 2);
+		put_snapshot_int(fp, rec -> word, 2);
+		put_snapshot_int(fp, rec -> reg, 1);
+		put_snapshot_int(fp, rec -> zero, 1);
+		put_snapshot_int(fp, rec -> value, 2);
+	}
+
+	if(ferror(fp)) {
+		fclose(fp);
+		link_error(file_name, 0, "The trace file could not be written.", NULL);
+		free(file_name);
+		return 0;
+	}
+
+	printf("\nFile '%s' has been created successfully!\n", file_name);
+	fclose(fp);
+	free(file_name);
+
+	return 1;
+}
+
+
+/**
+ * read_trace function reads the records of '<name>.trace'.
+ *
+ * @param name - the name of the image (without extension).
+ * @param records_num - an address of an integer where to store the number of records.
+ * @param traced - an address of an integer where to store the number of instructions traced.
+ * @return - the records, oldest first (must be freed), or NULL if the file could not be read.
+ */
+trace_record* read_trace(const char* name, long* records_num, long* traced)
+{
+	char* file_name;
+	char* contents;
+	size_t len;
+	const unsigned char* pos;
+	trace_record* records;
+	long i;
+
+	file_name = module_file_name(name, TRACE_EXTENSION);
+	contents = read_whole_file(file_name, &len);
+	if(contents == NULL) {
+		link_error(file_name, 0, "The trace file could not be opened.", NULL);
+		free(file_name);
+		return NULL;
+	}
+
+	pos = (const unsigned char*) contents;
+	if(len < TRACE_HEADER_LENGTH || memcmp(pos, TRACE_MAGIC, strlen(TRACE_MAGIC)) != 0 ||
+			TRACE_HEADER_LENGTH + get_snapshot_int(pos + 4, 4) * TRACE_RECORD_LENGTH != (long) len) {
+		link_error(file_name, 0, "Invalid trace file.", NULL);
+		free(contents);
+		free(file_name);
+		return NULL;
+	}
+	free(file_name);
+
+	*records_num = get_snapshot_int(pos + 4, 4);
+	*traced = get_snapshot_int(pos + 8, 4) | ((get_snapshot_int(pos + 12, 4) << 16) << 16);
+	records = malloc((*records_num + 1) * sizeof(trace_record));	/* +1 so an empty trace allocates too */
+
+	/* verify if malloc worked as expected */
+	if(records == NULL)
+	{
+		free(contents);
+		fprintf(stderr, "Fatal error: failed to allocate memory.\n");
+		emergency_free_mem();
+		exit(EXIT_FAILURE);
+	}
+
+	for(i = 0, pos += TRACE_HEADER_LENGTH; i < *records_num; i++, pos += TRACE_RECORD_LENGTH) {
+		records[i].addr = (unsigned short) get_snapshot_int(pos, 2);
+		records[i].word = (unsigned short) get_snapshot_int(pos + 2, 2);
+		records[i].reg = (unsigned char) get_snapshot_int(pos + 4, 1);
+		records[i].zero = (unsigned char) get_snapshot_int(pos + 5, 1);
+		records[i].value = (unsigned short) get_snapshot_int(pos + 6, 2);
+	}
+	free(contents);
+
+	return records;
+}
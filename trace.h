@@ -0,0 +1,87 @@
+#ifndef TRACE_H
+#define TRACE_H
+#include <stdio.h>
+#include <stdlib.h>	/* for malloc */
+#include <string.h>
+#include "machine.h"
+#define TRACE_EXTENSION ".trace"
+#define TRACE_MAGIC "TRC1"
+#define TRACE_RECORDS 65536	/* the number of records of the ring buffer (a power of 2), the trace keeps the last instructions executed */
+#define TRACE_HEADER_LENGTH 16	/* the magic, the number of records in the file (4 bytes) and the number of instructions traced (8 bytes) */
+#define TRACE_RECORD_LENGTH 8	/* address (2 bytes), word (2 bytes), register (1 byte), zero flag (1 byte), value (2 bytes) */
+#define NO_REGISTER 0xFF	/* the register of a record of an instruction that didn't change a register */
+
+
+/* a struct that represents one executed instruction: its address and first word, and the register it changed (one instruction changes one
+ * register at most) */
+typedef struct trace_record {
+	unsigned short addr;
+	unsigned short word;
+	unsigned char reg;	/* the number of the register, or NO_REGISTER */
+	unsigned char zero;	/* the zero flag after the instruction */
+	unsigned short value;	/* the new value of the register */
+} trace_record;
+
+
+/* a struct that represents the trace of an execution, a ring buffer of the last TRACE_RECORDS instructions. A record is started before its
+ * instruction is executed (see run_machine function in 'machine.h') and completed before the next one, from the destination register of its
+ * decoded instruction, so the machine doesn't report what every instruction wrote */
+typedef struct trace {
+	trace_record records[TRACE_RECORDS];
+	long next;	/* the number of records started, records[(next - 1) % TRACE_RECORDS] is the last one */
+} trace;
+
+
+/**
+ * create_trace function creates an empty trace.
+ *
+ * @return - a pointer to the trace.
+ */
+trace_ptr create_trace();
+
+
+/**
+ * trace_step function completes the last record of a trace and starts a record for the instruction at an address.
+ *
+ * @param t - a pointer to the trace.
+ * @param mc - a pointer to the machine.
+ * @param addr - the address of the instruction.
+ */
+void trace_step(trace_ptr t, machine_ptr mc, int addr);
+
+
+/**
+ * trace_end function completes the last record of a trace. It must be called when the machine returns, before the trace is written.
+ *
+ * @param t - a pointer to the trace.
+ * @param mc - a pointer to the machine.
+ */
+void trace_end(trace_ptr t, machine_ptr mc);
+
+
+/**
+ * write_trace function writes the records of a trace, oldest first, to '<name>.trace' (a binary file of little endian integers, see
+ * TRACE_HEADER_LENGTH and TRACE_RECORD_LENGTH).
+ * Errors are reported with link_error function.
+ *
+ * @param t - a pointer to the trace.
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the file was written, otherwise 0 is returned.
+ */
+int write_trace(trace_ptr t, const char* name);
+
+
+/**
+ * read_trace function reads the records of '<name>.trace'.
+ * Errors are reported with link_error function.
+ *
+ * @param name - the name of the image (without extension).
+ * @param records_num - an address of an integer where to store the number of records.
+ * @param traced - an address of an integer where to store the number of instructions traced (more than the records if the ring buffer was
+ *                 full).
+ * @return - the records, oldest first (must be freed), or NULL if the file could not be read.
+ */
+trace_record* read_trace(const char* name, long* records_num, long* traced);
+
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * This is the main file of the 'tracedump'. It prints the traces the 'simulator' wrote (see TRACE_OPTION in 'simulator.h') as assembly. The
+ * image the trace was taken from is loaded too, since a record keeps only the first word of its instruction.
+ * Usage: tracedump image...
+ *
+ * @author - Arthur Rennert
+ * Assembler Project
+ */
+
+#include "tracedump.h"
+#include "emergency_free_mem.h"
+
+om_ptr curr_image = NULL;	/* the image currently loaded */
+machine_ptr curr_machine = NULL;	/* the machine the image is loaded into, for its decoded code */
+trace_record* curr_records = NULL;	/* the records of the trace currently printed */
+
+
+/* main function */
+int main(int argc, char* argv[])
+{
+	int failed;
+	int i;
+
+	if(argc < 2) {
+		printf("No traces to print. Usage: tracedump image...\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for(failed = 0, i = 1; i < argc; i++) {
+		if(!dump_trace(argv[i])) {
+			failed++;
+		}
+	}
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+/**
+ * dump_trace function prints the trace of an image.
+ *
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the trace was printed, otherwise 0 is returned.
+ */
+int dump_trace(const char* name)
+{
+	char text[DISASSEMBLY_TEXT_LENGTH];
+	isa_image img;
+	trace_record* rec;
+	long records_num;
+	long traced;
+	long i;
+	int zero;
+
+	curr_image = load_object_module(name);
+	if(curr_image == NULL) {
+		return 0;
+	}
+	curr_machine = create_machine(curr_image);
+	free_object_modules(&curr_image);
+	if(curr_machine == NULL) {
+		return 0;
+	}
+
+	curr_records = read_trace(name, &records_num, &traced);
+	if(curr_records == NULL) {
+		free(curr_machine);
+		curr_machine = NULL;
+		return 0;
+	}
+
+	img.words = curr_machine -> memory;	/* the code as it was when the instruction was executed, see below */
+	img.words_num = MEMORY_SIZE;
+	img.code_num = curr_machine -> code_end;
+	img.first_addr = 0;
+	img.labels = NULL;
+	img.refs = NULL;
+
+	printf("Trace of image '%s%s': %ld instructions traced, the last %ld are listed\n\n", name, OB_EXTENSION, traced, records_num);
+	printf("%10s  %4s  %3s  %-28s %s\n", "#", "addr", "word", "instruction", "changes");
+
+	for(zero = -1, i = 0; i < records_num; i++) {
+		rec = &(curr_records[i]);
+		if(rec -> addr >= MEMORY_SIZE) {
+			printf("%10ld  invalid record\n", traced - records_num + i + 1);
+			continue;
+		}
+
+		if(curr_machine -> memory[rec -> addr] != rec -> word && rec -> addr < curr_machine -> code_end) {	/* the code was changed while running */
+			store_word(curr_machine, rec -> addr, rec -> word);
+		}
+		disassemble(&img, rec -> addr, text);
+
+		printf("%10ld  %04d  %03X  ", traced - records_num + i + 1, rec -> addr, rec -> word & WORD_MASK);
+		if(rec -> reg != NO_REGISTER || (rec -> zero != zero && zero != -1)) {
+			printf("%-28s", text);
+		}
+		else printf("%s", text);
+		if(rec -> reg != NO_REGISTER) {
+			printf(" r%d = %d", rec -> reg, to_signed(rec -> value));
+		}
+		if(rec -> zero != zero && zero != -1) {
+			printf(" Z = %d", rec -> zero);
+		}
+		zero = rec -> zero;
+		putchar('\n');
+	}
+
+	free(curr_records);
+	curr_records = NULL;
+	free(curr_machine);
+	curr_machine = NULL;
+
+	return 1;
+}
+
+
+/**
+ * emergency_free_mem function frees all memory allocated during the execution. This function is called ONLY if any memory allocation fails.
+ * This function is not included in any .header file ('only in emergency_free.mem_h') to prevent using it accidentally.
+ */
+void emergency_free_mem()
+{
+	free_object_modules(&curr_image);
+	if(curr_machine != NULL) {
+		free(curr_machine);
+	}
+	curr_machine = NULL;
+	if(curr_records != NULL) {
+		free(curr_records);
+	}
+	curr_records = NULL;
+}
@@ -0,0 +1,21 @@
+#ifndef TRACEDUMP_H
+#define TRACEDUMP_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "object_module.h"
+#include "machine.h"
+#include "trace.h"
+
+
+/**
+ * dump_trace function prints the trace of an image, one executed instruction in a line: its number in the execution, its address and word, the
+ * instruction as assembly, and the register and zero flag it changed.
+ *
+ * @param name - the name of the image (without extension).
+ * @return - 1 if the trace was printed, otherwise 0 is returned.
+ */
+int dump_trace(const char* name);
+
+
+#endif